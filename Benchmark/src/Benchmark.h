@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Benchmarks register themselves with PR_BENCHMARK, the Benchmark application
+ * runs all of them (sorted by name) on its only tick. Results are printed
+ * with fmt::print, so they don't depend on the log level or async logging.
+ */
+struct BenchmarkRegistry {
+	struct Entry {
+		const char* name;
+		void (*run)();
+	};
+
+	static std::vector<Entry>& Get()
+	{
+		static std::vector<Entry> entries;
+		return entries;
+	}
+
+	struct Registrar {
+		Registrar(const char* name, void (*run)()) { Get().push_back({ name, run }); }
+	};
+
+	static void RunAll()
+	{
+		auto& entries = Get();
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return std::strcmp(a.name, b.name) < 0; });
+		for (const Entry& entry : entries)
+			entry.run();
+	}
+};
+
+namespace BenchmarkUtil {
+
+	// reads one byte per cache line, what a consumer of the data touches at least
+	inline uint64_t Touch(std::string_view data)
+	{
+		uint64_t sum = data.size();
+		for (size_t i = 0; i < data.size(); i += 64)
+			sum += static_cast<uint8_t>(data[i]);
+		return sum;
+	}
+
+	// drops a file from the page cache, so it's read from the disk again (best effort, POSIX only)
+	inline bool EvictFromCache(const std::string& filepath)
+	{
+#if defined(_WIN32)
+		return false;
+#else
+		const int file = open(filepath.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+		fdatasync(file);
+		const bool evicted = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(file);
+		return evicted;
+#endif
+	}
+
+	// an empty directory in the temp directory, removed again with this
+	struct TempDirectory {
+		explicit TempDirectory(const std::string& name) : path(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(path);
+			std::filesystem::create_directories(path);
+		}
+		~TempDirectory()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(path, error);
+		}
+
+		std::filesystem::path path;
+	};
+
+	struct RandomFile {
+		std::string name; // relative to the directory, "dir<i % 16>/asset<i>.bin"
+		std::string data;
+	};
+
+	/**
+	 * Writes count files of random bytes into directory, sized 256B << [0, sizeShifts)
+	 * like small assets (shaders, scripts, ...). The same seed gives the same files.
+	 */
+	inline std::vector<RandomFile> WriteRandomFiles(const std::filesystem::path& directory, uint32_t count, uint32_t seed, uint32_t sizeShifts = 9)
+	{
+		std::mt19937 random(seed);
+		std::vector<RandomFile> files;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			RandomFile file{ "dir" + std::to_string(i % 16) + "/asset" + std::to_string(i) + ".bin", std::string(256u << (random() % sizeShifts), '\0') };
+			for (char& c : file.data) c = static_cast<char>(random());
+
+			const std::filesystem::path path = directory / file.name;
+			std::filesystem::create_directories(path.parent_path());
+			std::ofstream(path.string(), std::ios::binary).write(file.data.data(), file.data.size());
+			files.push_back(std::move(file));
+		}
+		return files;
+	}
+}
+
+#define PR_BENCHMARK(name) static void name(); \
+	static BenchmarkRegistry::Registrar name##Registrar(#name, name); \
+	static void name()
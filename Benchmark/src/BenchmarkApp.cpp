@@ -0,0 +1,18 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+/**
+ * Headless application running every registered benchmark once
+ */
+struct BenchmarkApp : public Prism::Application {
+
+	BenchmarkApp() : Prism::Application(HeadlessProperties{ 60.0f, true, 1 }) {}
+
+	void OnUpdate(float dt) override { BenchmarkRegistry::RunAll(); }
+	void OnEvent(Prism::Event& e) override {}
+};
+
+APPLICATION_ENTRY_POINT{
+	return new BenchmarkApp();
+}
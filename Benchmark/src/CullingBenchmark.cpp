@@ -0,0 +1,79 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Systems/CullingSystem.h"
+#include "Systems/TransformSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+/**
+ * Frustum culling of scattered entities: the CullingSystem (SIMD kernels,
+ * chunk-parallel) against the same SIMD kernel and the scalar reference
+ * on one thread. All three must find the same visible set.
+ */
+PR_BENCHMARK(FrustumCulling)
+{
+	using namespace Prism;
+	constexpr uint32_t c_Entities = 1 << 20, c_Runs = 10;
+
+	World world;
+	Prefab prefab;
+	prefab.Add<Transform>();
+	prefab.Add<Bounds>();
+	const World::EntityRange range = world.Instantiate(prefab, c_Entities);
+
+	std::mt19937 random(30);
+	std::uniform_real_distribution<float> distribution(-500.0f, 500.0f);
+	Transform* transforms = world.GetColumn<Transform>(range);
+	for (uint32_t i = 0; i < c_Entities; ++i)
+	{
+		transforms[i].SetPosition(vec3(distribution(random), distribution(random) * 0.1f, distribution(random)));
+		transforms[i].SetRotation(quat::AxisAngle(vec3(0.0f, 1.0f, 0.0f), distribution(random)));
+	}
+
+	TransformSystem transformSystem;
+	CullingSystem culling;
+	transformSystem.Add(world, range);
+	culling.Add(world, range);
+	transformSystem.Update();
+	culling.Update(transformSystem);
+
+	const mat4 viewProjection = mat4::Perspective(Radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f)
+		* mat4::LookAt(vec3(0.0f, 10.0f, 0.0f), vec3(100.0f, 0.0f, 30.0f), vec3(0.0f, 1.0f, 0.0f));
+	const Frustum frustum(viewProjection);
+	const BoundsSoA bounds = culling.GetBounds();
+	std::vector<uint32_t> visible(c_Entities);
+
+	// ns per entity of the fastest run, and the visible count
+	auto measure = [&](const std::function<size_t()>& cull)
+	{
+		double best = 1e30;
+		size_t count = 0;
+		for (uint32_t run = 0; run < c_Runs; ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			count = cull();
+			best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		}
+		return std::make_pair(best / c_Entities, count);
+	};
+
+	const auto [systemTime, systemVisible] = measure([&]()
+		{
+			FrameAllocator::NewFrame(); // one frame per run, the visible list is frame memory
+			return culling.Cull(viewProjection).size();
+		});
+	const auto [simdTime, simdVisible] = measure([&]() { return CullBounds(frustum, bounds, 0, c_Entities, visible.data()); });
+	const auto [scalarTime, scalarVisible] = measure([&]() { return CullBoundsScalar(frustum, bounds, 0, c_Entities, visible.data()); });
+
+	fmt::print("Frustum culling, {} entities, {} visible (SIMD width {}, {} workers):\n",
+		c_Entities, scalarVisible, PR_SIMD_WIDTH, TaskSystem::GetWorkerCount());
+	fmt::print("  CullingSystem::Cull  {:6.3f}ns per entity{}\n", systemTime, systemVisible == scalarVisible ? "" : "  WRONG RESULT");
+	fmt::print("  CullBounds           {:6.3f}ns per entity{}\n", simdTime, simdVisible == scalarVisible ? "" : "  WRONG RESULT");
+	fmt::print("  CullBoundsScalar     {:6.3f}ns per entity\n", scalarTime);
+}
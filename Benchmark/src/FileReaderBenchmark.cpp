@@ -0,0 +1,101 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Util/FileReader/FileReader.h"
+#include "Util/FileReader/StringReader.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+/**
+ * Loading many small loose files (sizes like shaders and scripts, 256B -
+ * 64KB) one after another through StringReader and mapped, vs. all at once
+ * through FileReader::ReadAsync, and with a readahead hint up front. Cold
+ * runs drop the files from the page cache first (if the OS allows it).
+ */
+PR_BENCHMARK(FileReading)
+{
+	using clock = std::chrono::steady_clock;
+	constexpr uint32_t c_Files = 2000, c_Runs = 3;
+
+	const BenchmarkUtil::TempDirectory root("prism_file_reader_benchmark");
+	std::vector<std::string> filepaths;
+	uint64_t bytes = 0;
+	for (const BenchmarkUtil::RandomFile& file : BenchmarkUtil::WriteRandomFiles(root.path, c_Files, 1))
+	{
+		filepaths.push_back((root.path / file.name).string());
+		bytes += file.data.size();
+	}
+
+	bool cold = true;
+	auto measure = [&](bool evict, const std::function<uint64_t()>& load)
+	{
+		double time = 0.0;
+		uint64_t checksum = 0;
+		for (uint32_t run = 0; run < c_Runs; ++run)
+		{
+			if (evict)
+				for (const std::string& filepath : filepaths)
+					cold &= BenchmarkUtil::EvictFromCache(filepath);
+			const auto start = clock::now();
+			checksum += load();
+			time += std::chrono::duration<double, std::milli>(clock::now() - start).count() / c_Runs;
+		}
+		return std::make_pair(time, checksum);
+	};
+
+	auto serial = [&]()
+	{
+		uint64_t sum = 0;
+		for (const std::string& filepath : filepaths)
+			sum += BenchmarkUtil::Touch(*Prism::StringReader::ReadFile(filepath));
+		return sum;
+	};
+	auto mapped = [&]()
+	{
+		uint64_t sum = 0;
+		for (const std::string& filepath : filepaths)
+			sum += BenchmarkUtil::Touch(Prism::FileReader::Map(filepath)->GetView());
+		return sum;
+	};
+	auto async = [&]()
+	{
+		std::atomic<uint64_t> sum = 0;
+		Prism::FileReader::ReadAsync(filepaths, [&](const std::string&, std::optional<std::string> data)
+			{
+				if (data) sum += BenchmarkUtil::Touch(*data);
+			});
+		Prism::FileReader::Wait();
+		return sum.load();
+	};
+	auto prefetched = [&]()
+	{
+		Prism::FileReader::Prefetch(filepaths);
+		return mapped();
+	};
+
+	fmt::print("File reading, {} loose files ({:.1f}MB), {}, average of {} runs:\n", c_Files, bytes / 1048576.0,
+		Prism::FileReader::IsAsyncNative() ? "io_uring" : "blocking I/O threads", c_Runs);
+	for (bool evict : { true, false })
+	{
+		const auto [serialTime, serialSum] = measure(evict, serial);
+		const auto [mappedTime, mappedSum] = measure(evict, mapped);
+		const auto [asyncTime, asyncSum] = measure(evict, async);
+		const auto [prefetchedTime, prefetchedSum] = measure(evict, prefetched);
+		if (evict && !cold)
+		{
+			fmt::print("  (can't drop files from the page cache here, cold runs are warm)\n");
+			continue;
+		}
+
+		const char* state = evict ? "cold" : "warm";
+		const bool match = serialSum == mappedSum && serialSum == asyncSum && serialSum == prefetchedSum;
+		fmt::print("  {} StringReader       {:8.2f}ms  {:6.2f}us/file\n", state, serialTime, serialTime * 1000.0 / c_Files);
+		fmt::print("  {} mapped             {:8.2f}ms  {:6.2f}us/file\n", state, mappedTime, mappedTime * 1000.0 / c_Files);
+		fmt::print("  {} ReadAsync          {:8.2f}ms  {:6.2f}us/file  ({:.1f}x){}\n", state, asyncTime,
+			asyncTime * 1000.0 / c_Files, serialTime / asyncTime, match ? "" : "  CONTENT MISMATCH");
+		fmt::print("  {} Prefetch + mapped  {:8.2f}ms  {:6.2f}us/file\n", state, prefetchedTime, prefetchedTime * 1000.0 / c_Files);
+	}
+}
@@ -0,0 +1,75 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "spdlog/sinks/basic_file_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+static constexpr uint32_t c_CallsPerThread = 20000;
+
+static void runLogBenchmark(const std::shared_ptr<spdlog::logger>& logger, const char* mode)
+{
+	using clock = std::chrono::steady_clock;
+
+	const uint32_t threads = Prism::TaskSystem::GetWorkerCount() + 1;
+	std::vector<std::vector<float>> latencies(threads);
+	for (auto& thread : latencies)
+		thread.resize(c_CallsPerThread);
+
+	const uint64_t droppedBefore = Prism::Log::GetDroppedCount();
+	const auto start = clock::now();
+	Prism::TaskSystem::ParallelFor(threads, 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t thread = begin; thread < end; ++thread)
+				for (uint32_t i = 0; i < c_CallsPerThread; ++i)
+				{
+					const auto before = clock::now();
+					PR_LOG_WRITE(logger, spdlog::level::info, "worker {0} iteration {1} value {2}", thread, i, i * 0.5f);
+					latencies[thread][i] = std::chrono::duration<float, std::nano>(clock::now() - before).count();
+				}
+		});
+	const float callTime = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+	Prism::Log::Flush();
+	const float totalTime = std::chrono::duration<float, std::milli>(clock::now() - start).count();
+
+	std::vector<float> all;
+	for (const auto& thread : latencies)
+		all.insert(all.end(), thread.begin(), thread.end());
+	std::sort(all.begin(), all.end());
+
+	double sum = 0.0;
+	for (float ns : all) sum += ns;
+	auto percentile = [&](double p) { return all[std::min<size_t>(all.size() - 1, static_cast<size_t>(p * all.size()))]; };
+
+	// written synchronously to stdout so it's not part of the measurement
+	fmt::print("{:<14} {} threads x {} calls: mean {:.0f}ns  p50 {:.0f}ns  p99 {:.0f}ns  p99.9 {:.0f}ns  max {:.0f}ns  "
+		"(calls done {:.1f}ms, written {:.1f}ms, dropped {})\n", mode, threads, c_CallsPerThread,
+		sum / all.size(), percentile(0.5), percentile(0.99), percentile(0.999), all.back(),
+		callTime, totalTime, Prism::Log::GetDroppedCount() - droppedBefore);
+}
+
+/**
+ * Latency of log calls issued from TaskSystem workers, synchronous vs. asynchronous
+ *
+ * Every thread logs into a file sink, the time of each call is measured on
+ * the calling thread (i.e. what a worker is stalled by a log statement).
+ */
+PR_BENCHMARK(LogLatency)
+{
+	auto logger = spdlog::basic_logger_mt("Benchmark", "log_benchmark.log", true);
+	logger->set_level(spdlog::level::trace);
+
+	Prism::Log::StopAsync();
+	runLogBenchmark(logger, "sync");
+
+	Prism::Log::StartAsync({ Prism::Log::OverflowPolicy::Block });
+	runLogBenchmark(logger, "async (block)");
+	Prism::Log::StopAsync();
+
+	Prism::Log::StartAsync({ Prism::Log::OverflowPolicy::Drop });
+	runLogBenchmark(logger, "async (drop)");
+	// keep async mode for the rest of the application
+}
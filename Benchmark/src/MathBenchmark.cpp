@@ -0,0 +1,95 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Math/Batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+	// ns per element of the fastest of a few runs
+	double measureKernel(size_t count, const std::function<void()>& kernel)
+	{
+		constexpr uint32_t c_Runs = 20;
+		double best = 1e30;
+		for (uint32_t run = 0; run < c_Runs; ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			kernel();
+			best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+		}
+		return best / count;
+	}
+
+	float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		float difference = 0.0f;
+		for (size_t i = 0; i < a.size(); ++i)
+			difference = std::max(difference, std::abs(a[i] - b[i]));
+		return difference;
+	}
+}
+
+/**
+ * SoA batch kernels (Math/Batch.h) against their scalar reference
+ * versions, with the largest difference between the results.
+ */
+PR_BENCHMARK(MathKernels)
+{
+	constexpr size_t c_Points = 1 << 16, c_Matrices = 1 << 14;
+
+	std::mt19937 random(27);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	auto fill = [&](std::vector<float>& values) { for (float& v : values) v = distribution(random); };
+
+	std::vector<float> x(c_Points), y(c_Points), z(c_Points);
+	fill(x); fill(y); fill(z);
+	std::vector<float> simd[3] = { std::vector<float>(c_Points), std::vector<float>(c_Points), std::vector<float>(c_Points) };
+	std::vector<float> scalar[3] = { std::vector<float>(c_Points), std::vector<float>(c_Points), std::vector<float>(c_Points) };
+	const Prism::mat4 transform = Prism::mat4::Compose(Prism::vec3(1.0f, 2.0f, 3.0f),
+		Prism::quat::AxisAngle(Prism::vec3(0.0f, 1.0f, 0.0f), 0.5f), Prism::vec3(2.0f));
+
+	fmt::print("Math kernels (ns per element, SIMD width {}):\n", PR_SIMD_WIDTH);
+	fmt::print("  {:<22} {:>8} {:>8} {:>8} {:>10}\n", "", "SIMD", "scalar", "speedup", "max diff");
+	auto report = [](const char* name, double simdTime, double scalarTime, float difference)
+	{
+		fmt::print("  {:<22} {:>8.3f} {:>8.3f} {:>7.1f}x {:>10.2g}\n", name, simdTime, scalarTime, scalarTime / simdTime, difference);
+	};
+
+	const double pointsSimd = measureKernel(c_Points, [&]()
+		{ Prism::TransformPoints(transform, x.data(), y.data(), z.data(), simd[0].data(), simd[1].data(), simd[2].data(), c_Points); });
+	const double pointsScalar = measureKernel(c_Points, [&]()
+		{ Prism::TransformPointsScalar(transform, x.data(), y.data(), z.data(), scalar[0].data(), scalar[1].data(), scalar[2].data(), c_Points); });
+	report("TransformPoints", pointsSimd, pointsScalar,
+		std::max({ maxDifference(simd[0], scalar[0]), maxDifference(simd[1], scalar[1]), maxDifference(simd[2], scalar[2]) }));
+
+	// normalizing is idempotent, so repeated runs on the same data are fine
+	for (uint32_t i = 0; i < 3; ++i) simd[i] = scalar[i] = (i == 0 ? x : i == 1 ? y : z);
+	const double normalizeSimd = measureKernel(c_Points, [&]() { Prism::NormalizeBatch(simd[0].data(), simd[1].data(), simd[2].data(), c_Points); });
+	const double normalizeScalar = measureKernel(c_Points, [&]() { Prism::NormalizeBatchScalar(scalar[0].data(), scalar[1].data(), scalar[2].data(), c_Points); });
+	report("NormalizeBatch", normalizeSimd, normalizeScalar,
+		std::max({ maxDifference(simd[0], scalar[0]), maxDifference(simd[1], scalar[1]), maxDifference(simd[2], scalar[2]) }));
+
+	std::vector<Prism::mat4> a(c_Matrices), b(c_Matrices), simdOut(c_Matrices), scalarOut(c_Matrices);
+	for (size_t i = 0; i < c_Matrices; ++i)
+		for (int column = 0; column < 4; ++column)
+			for (int row = 0; row < 4; ++row)
+			{
+				a[i][column][row] = distribution(random);
+				b[i][column][row] = distribution(random);
+			}
+	const double mulSimd = measureKernel(c_Matrices, [&]() { Prism::MulMat4Batch(a.data(), b.data(), simdOut.data(), c_Matrices); });
+	const double mulScalar = measureKernel(c_Matrices, [&]() { Prism::MulMat4BatchScalar(a.data(), b.data(), scalarOut.data(), c_Matrices); });
+	float mulDifference = 0.0f;
+	for (size_t i = 0; i < c_Matrices; ++i)
+		for (int column = 0; column < 4; ++column)
+			for (int row = 0; row < 4; ++row)
+				mulDifference = std::max(mulDifference, std::abs(simdOut[i][column][row] - scalarOut[i][column][row]));
+	report("MulMat4Batch", mulSimd, mulScalar, mulDifference);
+}
@@ -0,0 +1,102 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Systems/CullingSystem.h"
+#include "Systems/OcclusionSystem.h"
+#include "Systems/TransformSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+/**
+ * Hi-Z occlusion culling behind a street of buildings: occluder
+ * rasterisation and the occlusion test of the frustum-visible entities,
+ * compared to frustum culling alone. Entities in front of all occluders
+ * must stay visible.
+ */
+PR_BENCHMARK(OcclusionCulling)
+{
+	using namespace Prism;
+	using clock = std::chrono::steady_clock;
+	constexpr uint32_t c_Entities = 1 << 18, c_Buildings = 64, c_Runs = 10;
+	constexpr float c_FrontDepth = -20.0f; // no occluder is nearer than this
+
+	World world;
+	Prefab prefab;
+	prefab.Add<Transform>();
+	prefab.Add<Bounds>();
+	const World::EntityRange range = world.Instantiate(prefab, c_Entities);
+
+	std::mt19937 random(31);
+	std::uniform_real_distribution<float> side(-150.0f, 150.0f), height(-5.0f, 40.0f), depth(-300.0f, -1.0f);
+	Transform* transforms = world.GetColumn<Transform>(range);
+	for (uint32_t i = 0; i < c_Entities; ++i)
+		transforms[i].SetPosition(vec3(side(random), height(random), depth(random)));
+
+	TransformSystem transformSystem;
+	CullingSystem culling;
+	transformSystem.Add(world, range);
+	culling.Add(world, range);
+	transformSystem.Update();
+	culling.Update(transformSystem);
+
+	// buildings along both sides of the view and across its end, as unit cubes scaled into place
+	const OccluderMesh cube{
+		{ { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f },
+		  { -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f }, { -0.5f, 0.5f, 0.5f } },
+		{ 0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4, 3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5 } };
+	OcclusionSystem occlusion;
+	for (uint32_t i = 0; i < c_Buildings; ++i)
+	{
+		const float z = c_FrontDepth - 10.0f - 8.0f * (i / 2);
+		const float x = i % 2 == 0 ? -14.0f : 14.0f;
+		occlusion.AddOccluder(cube, mat4::Compose(vec3(x, 15.0f, z), quat{}, vec3(16.0f, 30.0f, 6.0f)));
+	}
+	occlusion.AddOccluder(cube, mat4::Compose(vec3(0.0f, 15.0f, -120.0f), quat{}, vec3(40.0f, 30.0f, 2.0f)));
+
+	const mat4 viewProjection = mat4::Perspective(Radians(60.0f), 16.0f / 9.0f, 0.1f, 400.0f)
+		* mat4::LookAt(vec3(0.0f, 2.0f, 0.0f), vec3(0.0f, 2.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+
+	double frustumTime = 1e30, rasterTime = 1e30, occlusionTime = 1e30;
+	for (uint32_t run = 0; run < c_Runs; ++run)
+	{
+		FrameAllocator::NewFrame(); // the visible lists are frame memory
+		auto start = clock::now();
+		culling.Cull(viewProjection);
+		auto end = clock::now();
+		frustumTime = std::min(frustumTime, std::chrono::duration<double, std::micro>(end - start).count());
+
+		start = clock::now();
+		occlusion.RenderOccluders(viewProjection);
+		end = clock::now();
+		rasterTime = std::min(rasterTime, std::chrono::duration<double, std::micro>(end - start).count());
+
+		start = clock::now();
+		occlusion.Cull(culling);
+		end = clock::now();
+		occlusionTime = std::min(occlusionTime, std::chrono::duration<double, std::micro>(end - start).count());
+	}
+
+	// conservative: nothing in front of the nearest occluder may be culled
+	std::vector<EntityID> visible(occlusion.GetVisible().begin(), occlusion.GetVisible().end());
+	std::sort(visible.begin(), visible.end());
+	uint32_t front = 0, wronglyOccluded = 0;
+	for (EntityID entity : culling.GetVisible())
+		if (transforms[entity - range.first].GetPosition().z - 0.5f > c_FrontDepth)
+		{
+			++front;
+			wronglyOccluded += !std::binary_search(visible.begin(), visible.end(), entity);
+		}
+
+	const OcclusionSystem::Stats& stats = occlusion.GetStats();
+	fmt::print("Occlusion culling, {} entities, {} occluder triangles, {}x{} depth buffer:\n",
+		c_Entities, stats.occluderTriangles, OcclusionSystem::Width, OcclusionSystem::Height);
+	fmt::print("  frustum cull        {:8.1f}us  {} visible\n", frustumTime, culling.GetVisible().size());
+	fmt::print("  rasterise + Hi-Z    {:8.1f}us\n", rasterTime);
+	fmt::print("  occlusion test      {:8.1f}us  {} visible, {:.0f}% occluded\n", occlusionTime, visible.size(), 100.0f * stats.CullRate());
+	fmt::print("  {} entities in front of the occluders, {} wrongly occluded -> {}\n",
+		front, wronglyOccluded, wronglyOccluded == 0 ? "OK" : "FAILED");
+}
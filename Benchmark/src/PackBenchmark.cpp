@@ -0,0 +1,220 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Util/FileReader/PackArchive.h"
+#include "Util/FileReader/PackWriter.h"
+#include "Util/FileReader/StringReader.h"
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+	// shader/script-like text, mesh-like vertex data and texture-like pixels
+	std::string generateAsset(uint32_t kind, size_t size, std::mt19937& random)
+	{
+		static const char* tokens[] = { "vec4 ", "uniform ", "gl_Position", " = ", "texture(", "float ", ";\n",
+			"void main()\n{\n", "}\n", "0.5", "color", "local ", "function ", "end\n", "\t", "return " };
+
+		std::string data;
+		data.reserve(size);
+		if (kind == 0)
+			while (data.size() < size) data += tokens[random() % 16];
+		else if (kind == 1)
+			for (uint32_t vertex = 0; data.size() < size; ++vertex)
+			{
+				// position on a bumpy grid, normal, uv
+				const float x = (vertex % 256) * 0.1f, z = (vertex / 256) * 0.1f, y = std::sin(x) * std::cos(z);
+				const float values[8] = { x, y, z, 0.0f, 1.0f, 0.0f, (vertex % 256) / 255.0f, (vertex / 256 % 256) / 255.0f };
+				data.append(reinterpret_cast<const char*>(values), sizeof(values));
+			}
+		else
+			for (uint32_t pixel = 0; data.size() < size; ++pixel)
+			{
+				const uint8_t noise = random() % 4;
+				const char rgba[4] = { char((pixel % 512) / 2 + noise), char((pixel / 512 % 512) / 2), char(128 + noise), char(255) };
+				data.append(rgba, 4);
+			}
+		data.resize(size);
+		return data;
+	}
+
+	double cpuMilliseconds() { return 1000.0 * std::clock() / CLOCKS_PER_SEC; } // process CPU time (wall time on Windows)
+}
+
+/**
+ * Loading every asset of a set of small files (sizes like shaders and
+ * scripts, 256B - 64KB) as loose files through StringReader vs. from a
+ * mapped pack. Files are in the page cache in both cases (written right
+ * before), so this is the syscall and copy overhead, not disk speed.
+ */
+PR_BENCHMARK(PackLoading)
+{
+	using clock = std::chrono::steady_clock;
+	constexpr uint32_t c_Files = 2000, c_Runs = 5;
+
+	const BenchmarkUtil::TempDirectory root("prism_pack_benchmark");
+	const std::string packPath = (root.path / "assets.pack").string();
+
+	std::vector<std::string> names;
+	Prism::PackWriter writer;
+	uint64_t bytes = 0;
+	for (BenchmarkUtil::RandomFile& file : BenchmarkUtil::WriteRandomFiles(root.path / "loose", c_Files, 42))
+	{
+		names.push_back(file.name);
+		bytes += file.data.size();
+		writer.Add(file.name, std::move(file.data));
+	}
+	std::string error;
+	if (!writer.Write(packPath, error))
+	{
+		fmt::print("PackLoading: {}\n", error);
+		return;
+	}
+
+	auto measure = [&](const std::function<uint64_t()>& load)
+	{
+		uint64_t checksum = 0;
+		const auto start = clock::now();
+		for (uint32_t run = 0; run < c_Runs; ++run)
+			checksum += load();
+		return std::make_pair(std::chrono::duration<double, std::milli>(clock::now() - start).count() / c_Runs, checksum);
+	};
+
+	const std::string loose = (root.path / "loose").string() + "/";
+	const auto [looseTime, looseSum] = measure([&]()
+		{
+			uint64_t sum = 0;
+			for (const std::string& name : names)
+				sum += BenchmarkUtil::Touch(*Prism::StringReader::ReadFile(loose + name));
+			return sum;
+		});
+
+	const auto [packTime, packSum] = measure([&]()
+		{
+			Prism::PackArchive pack; // opening is part of the measurement
+			pack.Open(packPath);
+			uint64_t sum = 0;
+			for (const std::string& name : names)
+				sum += BenchmarkUtil::Touch(*pack.Find(name));
+			return sum;
+		});
+
+	Prism::PackArchive pack;
+	pack.Open(packPath);
+	const auto [lookupTime, lookupSum] = measure([&]()
+		{
+			uint64_t found = 0;
+			for (const std::string& name : names)
+				found += pack.Find(name)->size();
+			return found;
+		});
+
+	fmt::print("Pack loading, {} files ({:.1f}MB), average of {} runs:\n", c_Files, bytes / 1048576.0, c_Runs);
+	fmt::print("  loose (StringReader) {:8.2f}ms  {:6.2f}us/file\n", looseTime, looseTime * 1000.0 / c_Files);
+	fmt::print("  pack (mapped)        {:8.2f}ms  {:6.2f}us/file  ({:.1f}x){}\n", packTime, packTime * 1000.0 / c_Files,
+		looseTime / packTime, looseSum == packSum ? "" : "  CONTENT MISMATCH");
+	fmt::print("  pack lookup only     {:8.2f}ms  {:6.3f}us/file\n", lookupTime, lookupTime * 1000.0 / c_Files);
+}
+
+/**
+ * Loading compressed vs. uncompressed packs, cold (dropped from the page
+ * cache before every run, if the OS allows it) and warm. Uncompressed
+ * entries are only touched in the mapping (zero-copy), compressed ones are
+ * decompressed into preallocated buffers, serially and with the blocks
+ * spread over the TaskSystem.
+ */
+PR_BENCHMARK(PackCompression)
+{
+	using clock = std::chrono::steady_clock;
+	constexpr uint32_t c_Assets = 48, c_Runs = 3;
+	constexpr size_t c_AssetSize = 1 << 20;
+
+	const BenchmarkUtil::TempDirectory root("prism_pack_compression");
+	const std::string plainPath = (root.path / "plain.pack").string(), compressedPath = (root.path / "compressed.pack").string();
+
+	std::mt19937 random(7);
+	std::vector<std::string> names;
+	Prism::PackWriter plain, compressed;
+	for (uint32_t i = 0; i < c_Assets; ++i)
+	{
+		names.push_back(fmt::format("asset{0}.bin", i));
+		std::string data = generateAsset(i % 3, c_AssetSize, random);
+		compressed.Add(names.back(), data, true);
+		plain.Add(names.back(), std::move(data));
+	}
+	std::string error;
+	if (!plain.Write(plainPath, error) || !compressed.Write(compressedPath, error))
+	{
+		fmt::print("PackCompression: {}\n", error);
+		return;
+	}
+
+	std::vector<std::string> buffers(c_Assets, std::string(c_AssetSize, '\0')); // the final destinations
+	const double megabytes = c_Assets * c_AssetSize / 1048576.0;
+
+	struct Result { double wall = 0.0, cpu = 0.0; bool cold = true; };
+	auto measure = [&](const std::string& path, bool evict, const std::function<void(const Prism::PackArchive&)>& load)
+	{
+		Result result;
+		for (uint32_t run = 0; run < c_Runs; ++run)
+		{
+			if (evict) result.cold &= BenchmarkUtil::EvictFromCache(path);
+			const double cpu = cpuMilliseconds();
+			const auto start = clock::now();
+			Prism::PackArchive pack;
+			pack.Open(path);
+			load(pack);
+			result.wall += std::chrono::duration<double, std::milli>(clock::now() - start).count() / c_Runs;
+			result.cpu += (cpuMilliseconds() - cpu) / c_Runs;
+		}
+		return result;
+	};
+
+	uint64_t checksum = 0;
+	auto zeroCopy = [&](const Prism::PackArchive& pack)
+	{
+		for (const std::string& name : names)
+			checksum += BenchmarkUtil::Touch(*pack.Find(name));
+	};
+	auto decompress = [&](const Prism::PackArchive& pack, bool parallel)
+	{
+		for (uint32_t i = 0; i < c_Assets; ++i)
+			pack.Read(*pack.FindEntry(names[i]), buffers[i].data(), parallel);
+	};
+
+	fmt::print("Pack compression, {} assets ({:.0f}MB), {} on disk compressed, {} uncompressed, average of {} runs:\n",
+		c_Assets, megabytes, fs::file_size(compressedPath), fs::file_size(plainPath), c_Runs);
+	fmt::print("  {:<26} {:>10} {:>10} {:>10}\n", "", "wall ms", "MB/s", "CPU ms");
+	for (bool cold : { true, false })
+	{
+		const Result results[] = {
+			measure(plainPath, cold, zeroCopy),
+			measure(compressedPath, cold, [&](const Prism::PackArchive& pack) { decompress(pack, false); }),
+			measure(compressedPath, cold, [&](const Prism::PackArchive& pack) { decompress(pack, true); })
+		};
+		const char* labels[] = { "uncompressed (mmap)", "compressed (1 thread)", "compressed (parallel)" };
+		if (cold && !results[0].cold)
+		{
+			fmt::print("  (can't drop files from the page cache here, cold runs are warm)\n");
+			continue;
+		}
+		for (uint32_t i = 0; i < 3; ++i)
+			fmt::print("  {:<5} {:<20} {:>10.2f} {:>10.0f} {:>10.2f}\n", cold ? "cold" : "warm", labels[i],
+				results[i].wall, megabytes * 1000.0 / results[i].wall, results[i].cpu);
+	}
+
+	// the decompressed data must be what was packed
+	Prism::PackArchive pack;
+	pack.Open(plainPath);
+	for (uint32_t i = 0; i < c_Assets; ++i)
+		if (*pack.Find(names[i]) != buffers[i])
+			fmt::print("  CONTENT MISMATCH in {}\n", names[i]);
+}
@@ -0,0 +1,46 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Components/Bounds.h"
+#include "Components/Transform.h"
+#include "Entities/World.h"
+
+#include <chrono>
+
+/**
+ * Bulk instantiation of prefabs (column-wise copies into one allocation
+ * per component type). Checks that every instance got the prototype's
+ * components and that empty instantiations give an empty, usable range.
+ */
+PR_BENCHMARK(PrefabInstantiate)
+{
+	using clock = std::chrono::steady_clock;
+	constexpr uint32_t c_Count = 100000;
+
+	Prism::Prefab prefab;
+	prefab.Add<Prism::Transform>(Prism::vec3(1.0f, 2.0f, 3.0f));
+	prefab.Add<Prism::Bounds>();
+
+	Prism::World world;
+	uint32_t failures = 0;
+
+	const Prism::World::EntityRange empty = world.Instantiate(prefab, 0);
+	if (empty.count != 0 || world.GetColumn<Prism::Transform>(empty) != nullptr)
+		failures++;
+
+	const auto start = clock::now();
+	const Prism::World::EntityRange range = world.Instantiate(prefab, c_Count);
+	const double time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+	const Prism::Transform* transforms = world.GetColumn<Prism::Transform>(range);
+	if (!transforms || !world.GetColumn<Prism::Bounds>(range))
+		failures++;
+	else
+		for (uint32_t i = 0; i < range.count; ++i)
+			if (transforms[i].GetPosition().y != 2.0f || range.entities[i].id != range.first + i)
+				failures++;
+
+	fmt::print("Prefab instantiate: {} entities with {} components in {:.2f}ms ({:.1f}ns/entity), {} failures -> {}\n",
+		c_Count, prefab.GetComponentCount(), time, time * 1e6 / c_Count, failures, failures == 0 ? "OK" : "FAILED");
+}
@@ -0,0 +1,207 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Core/Memory/Epoch.h"
+#include "Core/Resources/ResourceMap.h"
+
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+	std::atomic<int64_t> g_LivePayloads = 0;
+
+	// checks itself on every access, poisoned on destruction
+	struct Payload {
+		Payload(const std::string& name) : name(name), key(std::hash<std::string>()(name)) { g_LivePayloads++; }
+		~Payload() { key = 0; g_LivePayloads--; }
+		bool Valid(const std::string& expected) const { return key == std::hash<std::string>()(expected) && name == expected; }
+
+		std::string name;
+		size_t key;
+	};
+
+	std::string payloadName(uint32_t thread, uint32_t serial) { return fmt::format("t{0}/{1}", thread, serial); }
+
+	uint32_t benchmarkThreads() { return Prism::TaskSystem::GetWorkerCount() + 1; }
+}
+
+/**
+ * Every thread owns a window of resources it creates and destroys, while
+ * all threads look up (and reference) random resources of the others by
+ * name. Checks that acquired resources are never stale or reclaimed early,
+ * that stale handles resolve to nullptr and that nothing leaks.
+ */
+PR_BENCHMARK(ResourceMapStress)
+{
+	constexpr uint32_t c_Window = 32, c_Iterations = 200000;
+
+	const uint32_t threads = benchmarkThreads();
+	const auto resourcesLevel = Prism::Log::GetLevel(Prism::Log::Category::Resources);
+	Prism::Log::SetLevel(Prism::Log::Category::Resources, spdlog::level::err); // lookups of destroyed names are expected
+
+	auto map = std::make_unique<Prism::ResourceMap<Payload>>();
+	std::vector<std::atomic<uint32_t>> published(threads * c_Window); // serial + 1 of the resource in each window slot
+	std::atomic<uint64_t> failures = 0, found = 0, missed = 0, creates = 0, destroys = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	Prism::TaskSystem::ParallelFor(threads, 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t thread = begin; thread < end; ++thread)
+			{
+				std::mt19937 random(thread);
+				std::vector<Prism::ResourceHandle> owned(c_Window), pending; // pending: released, but still referenced by a reader
+				uint32_t serial = 0;
+
+				auto destroy = [&](Prism::ResourceHandle handle)
+				{
+					if (!map->DestroyResource(handle))
+						return false;
+					if (map->GetRaw(handle) != nullptr) failures++;
+					destroys++;
+					return true;
+				};
+
+				for (uint32_t i = 0; i < c_Iterations; ++i)
+				{
+					const uint32_t op = random() % 8;
+					if (op == 0)
+					{
+						// replace a resource of the own window
+						const uint32_t slot = random() % c_Window;
+						if (owned[slot].Valid())
+						{
+							published[thread * c_Window + slot].store(0, std::memory_order_relaxed);
+							map->RemoveResource(owned[slot]);
+							if (!destroy(owned[slot]))
+								pending.push_back(owned[slot]); // a reader got hold of it
+						}
+						owned[slot] = map->CreateResource(payloadName(thread, serial), payloadName(thread, serial));
+						published[thread * c_Window + slot].store(++serial, std::memory_order_release);
+						creates++;
+					}
+					else
+					{
+						// reference a random resource of a random thread
+						const uint32_t other = random() % threads, slot = random() % c_Window;
+						const uint32_t otherSerial = published[other * c_Window + slot].load(std::memory_order_acquire);
+						if (otherSerial == 0)
+							continue;
+
+						const std::string name = payloadName(other, otherSerial - 1);
+						const Prism::ResourceHandle handle = map->GetResource(name);
+						if (!handle.Valid())
+						{
+							missed++;
+							continue;
+						}
+						const Payload* payload = map->GetRaw(handle);
+						if (!payload || !payload->Valid(name) || map->GetName(handle) != name)
+							failures++;
+						map->NotifyCopy(handle);
+						map->RemoveResource(handle);
+						map->RemoveResource(handle);
+						found++;
+					}
+
+					if (!pending.empty() && destroy(pending.back()))
+						pending.pop_back();
+				}
+
+				for (uint32_t slot = 0; slot < c_Window; ++slot)
+					if (owned[slot].Valid())
+					{
+						published[thread * c_Window + slot].store(0, std::memory_order_relaxed);
+						map->RemoveResource(owned[slot]);
+						pending.push_back(owned[slot]);
+					}
+				// readers only hold references for a moment
+				while (!pending.empty())
+					if (destroy(pending.back())) pending.pop_back();
+			}
+		});
+	const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	// every resource was destroyed, once retired objects are collected nothing may be left
+	Prism::Epoch::Collect();
+	Prism::Epoch::Collect();
+	const int64_t leaked = g_LivePayloads.load();
+	if (map->GetResource(payloadName(0, 0)).Valid()) failures++;
+	map.reset();
+	Prism::Log::SetLevel(Prism::Log::Category::Resources, resourcesLevel);
+
+	fmt::print("ResourceMap stress: {} threads, {:.1f}ms: {} creates, {} destroys, {} lookups ({} of destroyed names), "
+		"{} failures, {} leaked, {} retired pending -> {}\n", threads, time, creates.load(), destroys.load(),
+		found.load() + missed.load(), missed.load(), failures.load(), leaked, Prism::Epoch::GetPendingCount(),
+		failures == 0 && leaked == 0 && creates == destroys ? "OK" : "FAILED");
+}
+
+/**
+ * Lookups per second by handle and by name with increasing thread counts,
+ * compared to a mutex-guarded unordered_map (the previous ResourceMap
+ * would have needed one to be shared between threads).
+ */
+PR_BENCHMARK(ResourceMapReadThroughput)
+{
+	using clock = std::chrono::steady_clock;
+	constexpr uint32_t c_Resources = 4096, c_Lookups = 1 << 20;
+
+	Prism::ResourceMap<Payload> map;
+	std::vector<Prism::ResourceHandle> handles;
+	std::vector<std::string> names;
+	std::unordered_map<std::string, std::unique_ptr<Payload>> locked;
+	std::mutex mutex;
+	for (uint32_t i = 0; i < c_Resources; ++i)
+	{
+		names.push_back(payloadName(0, i));
+		handles.push_back(map.CreateResource(names.back(), names.back()));
+		locked.emplace(names.back(), std::make_unique<Payload>(names.back()));
+	}
+
+	auto measure = [&](uint32_t threads, const std::function<size_t(uint32_t index)>& lookup)
+	{
+		std::atomic<size_t> checksum = 0;
+		const auto start = clock::now();
+		Prism::TaskSystem::ParallelFor(threads, 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t thread = begin; thread < end; ++thread)
+				{
+					size_t sum = 0;
+					for (uint32_t i = 0, index = thread * 7919 % c_Resources; i < c_Lookups; ++i, index = (index + 2654435761u) % c_Resources)
+						sum += lookup(index);
+					checksum += sum;
+				}
+			});
+		const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+		return threads * static_cast<double>(c_Lookups) / seconds / 1e6;
+	};
+
+	fmt::print("ResourceMap read throughput (million lookups/s, {} resources):\n", c_Resources);
+	fmt::print("{:>8} {:>12} {:>12} {:>16}\n", "threads", "GetRaw", "GetResource", "mutex+map");
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads < benchmarkThreads(); threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(benchmarkThreads());
+
+	for (uint32_t threads : threadCounts)
+	{
+		const double raw = measure(threads, [&](uint32_t i) { return map.GetRaw(handles[i])->key; });
+		const double named = measure(threads, [&](uint32_t i)
+			{
+				const Prism::ResourceHandle handle = map.GetResource(names[i]);
+				const size_t key = map.GetRaw(handle)->key;
+				map.RemoveResource(handle);
+				return key;
+			});
+		const double baseline = measure(threads, [&](uint32_t i)
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				return locked.find(names[i])->second->key;
+			});
+		fmt::print("{:>8} {:>12.1f} {:>12.1f} {:>16.1f}\n", threads, raw, named, baseline);
+	}
+}
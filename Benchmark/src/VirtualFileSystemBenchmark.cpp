@@ -0,0 +1,85 @@
+#include "Prism.h"
+
+#include "Benchmark.h"
+
+#include "Util/FileReader/PackWriter.h"
+#include "Util/FileReader/StringReader.h"
+#include "Util/FileSystem/VirtualFileSystem.h"
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Path lookups and opens through the VirtualFileSystem (a base pack with
+ * a patch pack mounted over it) vs. asking the OS for loose files. Every
+ * 10th file is replaced by the patch, which must win without slowing
+ * down lookups.
+ */
+PR_BENCHMARK(VirtualFileSystemLookup)
+{
+	using clock = std::chrono::steady_clock;
+	using VFS = Prism::VirtualFileSystem;
+	constexpr uint32_t c_Files = 2000, c_Runs = 5;
+
+	const BenchmarkUtil::TempDirectory root("prism_vfs_benchmark");
+	const std::string basePath = (root.path / "base.pack").string(), patchPath = (root.path / "patch.pack").string();
+
+	std::vector<std::string> paths, loosePaths, missingPaths;
+	Prism::PackWriter base, patch;
+	for (BenchmarkUtil::RandomFile& file : BenchmarkUtil::WriteRandomFiles(root.path / "loose", c_Files, 3, 6))
+	{
+		const size_t i = paths.size();
+		paths.push_back("bench/" + file.name);
+		loosePaths.push_back((root.path / "loose" / file.name).string());
+		missingPaths.push_back(fmt::format("bench/dir{0}/missing{1}.bin", i % 16, i));
+		if (i % 10 == 0)
+			patch.Add(file.name, "patched");
+		base.Add(file.name, std::move(file.data));
+	}
+	std::string error;
+	if (!base.Write(basePath, error) || !patch.Write(patchPath, error))
+	{
+		fmt::print("VirtualFileSystemLookup: {}\n", error);
+		return;
+	}
+
+	const VFS::MountID baseMount = VFS::MountPack("bench", basePath);
+	const VFS::MountID patchMount = VFS::MountPack("bench", patchPath);
+
+	auto measure = [&](const std::function<uint64_t(uint32_t index)>& lookup)
+	{
+		uint64_t checksum = 0;
+		const auto start = clock::now();
+		for (uint32_t run = 0; run < c_Runs; ++run)
+			for (uint32_t i = 0; i < c_Files; ++i)
+				checksum += lookup(i);
+		const double time = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (c_Runs * c_Files);
+		return std::make_pair(time, checksum);
+	};
+
+	const auto [vfsExists, vfsFound] = measure([&](uint32_t i) { return VFS::Exists(paths[i]); });
+	const auto [vfsMissing, vfsMissingFound] = measure([&](uint32_t i) { return VFS::Exists(missingPaths[i]); });
+	const auto [osExists, osFound] = measure([&](uint32_t i) { return fs::exists(loosePaths[i]); });
+	const auto [osMissing, osMissingFound] = measure([&](uint32_t i) { return fs::exists(loosePaths[i] + ".missing"); });
+	const auto [vfsOpen, vfsSum] = measure([&](uint32_t i) { return BenchmarkUtil::Touch(VFS::Open(paths[i])->GetView()); });
+	const auto [looseOpen, looseSum] = measure([&](uint32_t i) { return BenchmarkUtil::Touch(*Prism::StringReader::ReadFile(loosePaths[i])); });
+
+	uint32_t patched = 0;
+	for (uint32_t i = 0; i < c_Files; ++i)
+		patched += VFS::Open(paths[i])->GetView() == "patched";
+
+	fmt::print("VirtualFileSystem, {} files in a base pack, {} replaced by a patch pack, average of {} runs:\n",
+		c_Files, patch.GetEntryCount(), c_Runs);
+	fmt::print("  exists       VFS {:8.1f}ns   OS {:8.1f}ns{}\n", vfsExists, osExists,
+		vfsFound == osFound && vfsFound == c_Runs * c_Files ? "" : "  WRONG RESULT");
+	fmt::print("  missing      VFS {:8.1f}ns   OS {:8.1f}ns{}\n", vfsMissing, osMissing,
+		vfsMissingFound == 0 && osMissingFound == 0 ? "" : "  WRONG RESULT");
+	fmt::print("  open + read  VFS {:8.1f}ns   loose {:8.1f}ns\n", vfsOpen, looseOpen);
+	fmt::print("  {} of {} files from the patch{}\n", patched, patch.GetEntryCount(), patched == patch.GetEntryCount() ? "" : "  WRONG RESULT");
+
+	VFS::Unmount(patchMount);
+	VFS::Unmount(baseMount);
+}
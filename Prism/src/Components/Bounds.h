@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Component.h"
+#include "Math/AABB.h"
+
+namespace Prism {
+
+	// Local-space bounding box of an entity, used for spatial queries and culling
+	struct Bounds : public Component {
+		Bounds() = default;
+		Bounds(const AABB& box) : box(box) {}
+
+		AABB box{ vec3(-0.5f), vec3(0.5f) };
+	};
+}
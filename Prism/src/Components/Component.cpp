@@ -0,0 +1,15 @@
+#include "Component.h"
+#include "ComponentColumn.h"
+
+namespace Prism {
+
+	Component* ComponentsMap::GetFromColumns(const std::type_info* type) const
+	{
+		if (!m_Columns) return nullptr;
+
+		for (const auto& column : *m_Columns)
+			if (column->GetType() == type)
+				return column->At(m_ColumnIndex);
+		return nullptr;
+	}
+}
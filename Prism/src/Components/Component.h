@@ -1,11 +1,17 @@
 #pragma once
 
+#include "Util/Log/Log.h"
+
 #include <typeinfo>
 #include <typeindex>
 #include <unordered_map>
+#include <vector>
+#include <memory>
 
 namespace Prism {
 
+	class ComponentColumn; // see ComponentColumn.h
+
 	struct Component
 	{
 		virtual ~Component() = default;
@@ -33,18 +39,39 @@ namespace Prism {
 		{
 			static_assert(std::is_base_of<Component, T>::value, "Component classes must be derivatives of Component.");
 			components.insert(std::pair(&typeid(T), static_cast<Component*>(component)));
-			return component;
 		}
 
 		template<typename T>
 		constexpr T* Get()
 		{
 			const auto itr = components.find(&typeid(T));
-			PR_CORE_ASSERT(itr != components.end(), "Component classes must be derivatives of Component.");
-			return dynamic_cast<T*>(itr->second);
+			if (itr != components.end())
+				return dynamic_cast<T*>(itr->second);
+
+			// components of prefab instances live in the columns of their block
+			Component* component = GetFromColumns(&typeid(T));
+			PR_CORE_ASSERT(component, "Component not found.");
+			return static_cast<T*>(component);
+		}
+
+		// like Get, but returns nullptr if the component does not exist
+		template<typename T>
+		T* Find()
+		{
+			const auto itr = components.find(&typeid(T));
+			if (itr != components.end())
+				return dynamic_cast<T*>(itr->second);
+			return static_cast<T*>(GetFromColumns(&typeid(T)));
 		}
 
 	private:
+		friend class World;
+		Component* GetFromColumns(const std::type_info* type) const;
+
 		std::unordered_multimap<const std::type_info*, Component*> components;
+
+		// set by World::Instantiate, avoids a map entry per prefab component
+		const std::vector<std::unique_ptr<ComponentColumn>>* m_Columns = nullptr;
+		size_t m_ColumnIndex = 0;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Component.h"
+
+#include <typeinfo>
+#include <memory>
+#include <type_traits>
+
+namespace Prism {
+
+	/**
+	 * Owning, contiguous storage of components of the same type (used in World.h)
+	 *
+	 * All components of a column are allocated in one go and live until the
+	 * column is destroyed.
+	 */
+	class ComponentColumn {
+	public:
+		virtual ~ComponentColumn() = default;
+
+		virtual Component* At(size_t index) = 0;
+
+		const std::type_info* GetType() const { return m_Type; }
+		size_t GetSize() const { return m_Size; }
+
+	protected:
+		ComponentColumn(const std::type_info* type, size_t size) : m_Type(type), m_Size(size) {}
+
+		const std::type_info* m_Type;
+		size_t m_Size;
+	};
+
+	template<typename T>
+	class TypedComponentColumn : public ComponentColumn {
+	public:
+		// copy-constructs count instances of the prototype into one allocation
+		TypedComponentColumn(const T& prototype, size_t count)
+			: ComponentColumn(&typeid(T), count)
+		{
+			m_Data = std::allocator<T>().allocate(count);
+			std::uninitialized_fill_n(m_Data, count, prototype);
+		}
+
+		~TypedComponentColumn()
+		{
+			std::destroy_n(m_Data, m_Size);
+			std::allocator<T>().deallocate(m_Data, m_Size);
+		}
+
+		TypedComponentColumn(const TypedComponentColumn&) = delete;
+		TypedComponentColumn& operator=(const TypedComponentColumn&) = delete;
+
+		Component* At(size_t index) override { return m_Data + index; }
+		T* Data() { return m_Data; }
+
+	private:
+		T* m_Data = nullptr;
+	};
+
+	/**
+	 * Type-erased prototype component of a Prefab
+	 *
+	 * Knows how to fill a whole column with copies of itself.
+	 */
+	class ComponentPrototype {
+	public:
+		virtual ~ComponentPrototype() = default;
+
+		virtual std::unique_ptr<ComponentColumn> Instantiate(size_t count) const = 0;
+		virtual Component* Get() = 0;
+
+		const std::type_info* GetType() const { return m_Type; }
+
+	protected:
+		ComponentPrototype(const std::type_info* type) : m_Type(type) {}
+
+		const std::type_info* m_Type;
+	};
+
+	template<typename T>
+	class TypedComponentPrototype : public ComponentPrototype {
+	public:
+		template<typename ...Args>
+		TypedComponentPrototype(Args&&... args)
+			: ComponentPrototype(&typeid(T)), m_Prototype(std::forward<Args>(args)...) {}
+
+		std::unique_ptr<ComponentColumn> Instantiate(size_t count) const override
+		{
+			return std::make_unique<TypedComponentColumn<T>>(m_Prototype, count);
+		}
+
+		Component* Get() override { return &m_Prototype; }
+
+	private:
+		T m_Prototype;
+	};
+}
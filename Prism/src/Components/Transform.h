@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Component.h"
+#include "Math/Math.h"
+
+#include <cstdint>
+
+namespace Prism {
+
+	using EntityID = uint32_t; // see Entity.h
+
+	/**
+	 * Local transformation relative to the parent (or the world for roots)
+	 *
+	 * The world matrix is computed by the TransformSystem, setters
+	 * mark the transform dirty so only changed subtrees are recomputed.
+	 */
+	class Transform : public Component {
+	public:
+		Transform() = default;
+		Transform(const vec3& position, const quat& rotation = {}, const vec3& scale = vec3(1.0f))
+			: m_Position(position), m_Rotation(rotation), m_Scale(scale) {}
+
+		const vec3& GetPosition() const { return m_Position; }
+		const quat& GetRotation() const { return m_Rotation; }
+		const vec3& GetScale() const { return m_Scale; }
+
+		void SetPosition(const vec3& position) { m_Position = position; m_Dirty = true; }
+		void SetRotation(const quat& rotation) { m_Rotation = rotation; m_Dirty = true; }
+		void SetScale(const vec3& scale) { m_Scale = scale; m_Dirty = true; }
+
+		mat4 GetLocalMatrix() const { return mat4::Compose(m_Position, m_Rotation, m_Scale); }
+		bool IsDirty() const { return m_Dirty; }
+
+	private:
+		friend class TransformSystem;
+
+		vec3 m_Position{ 0.0f };
+		quat m_Rotation{};
+		vec3 m_Scale{ 1.0f };
+		bool m_Dirty = true;
+	};
+
+	// Attaches the entity's Transform to the Transform of another entity
+	struct Parent : public Component {
+		Parent() = default;
+		Parent(EntityID parent) : parent(parent) {}
+
+		EntityID parent = 0;
+	};
+}
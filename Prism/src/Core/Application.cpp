@@ -1,42 +1,111 @@
 #include "Application.h"
 
 #include "Core/TaskSystem/TaskSystem.h"
-#include "Core/Resources/ResourceManager.h"
+#include "Core/Startup/StartupGraph.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Resources/Resource.h"
 
 #include "Core/Graphics/Renderer.h"
 #include "Core/Graphics/Vulkan/VulkanInstance.h"
 
+#include "Util/FileReader/FileReader.h"
+#include "Util/FileSystem/VirtualFileSystem.h"
 #include "Util/Log/Log.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 
 
 namespace Prism {
 
 	Application* g_Application = nullptr;
 
-	Application::Application(const Window::Properties& props)
+	// assets are loaded through the VirtualFileSystem: the shipped pack (if any), loose files override it
+	static void mountResources()
+	{
+		if (std::filesystem::exists("res.pack"))
+			VirtualFileSystem::MountPack("res", "res.pack");
+		if (std::filesystem::is_directory("res"))
+			VirtualFileSystem::MountDirectory("res", "res");
+	}
+
+	// asks the OS to read the mounted assets ahead, so the first loads don't wait for the disk
+	static void preloadResources()
+	{
+		std::vector<std::string> files;
+		if (std::filesystem::exists("res.pack"))
+			files.push_back("res.pack");
+		std::error_code error;
+		for (std::filesystem::recursive_directory_iterator it("res", error), end; !error && it != end; it.increment(error))
+			if (it->is_regular_file(error))
+				files.push_back(it->path().string());
+		FileReader::Prefetch(files);
+	}
+
+	Application::Application(const Window::Properties& props, const EngineProperties& engine)
 	{
 		PR_CORE_ASSERT(!g_Application, "There is already an Application instance!");
 		g_Application = this; // set static for global access
+		configure(engine);
 
-		ResourceManager::Init();
+		// independent stages overlap on the TaskSystem, GLFW calls stay on the main thread
+		StartupGraph startup;
+		auto fileSystem = startup.AddStage("FileSystem", []() { mountResources(); });
+		auto preload = startup.AddStage("AssetPreload", []() { preloadResources(); }, { fileSystem });
+		auto resources = startup.AddStage("ResourceManager", []() { ResourceManager::Init(); });
+		startup.AddStage("Lua", [this]() { m_LuaInstance = std::make_unique<Lua>(); }, { fileSystem });
+		auto worldStage = startup.AddStage("World", [this]() { world = std::make_unique<World>(); });
 
-		// not really necessary as this is very quick for now
-		m_LuaInstance = std::make_unique<Lua>();;
+		// loads the icon
+		auto window = startup.AddStage("Window", [this, &props]()
+			{
+				m_MainWindow = std::make_unique<Window>(props);
+				m_MainWindow->SetEventCallback(PR_BIND_EVENT_FN(Application::EventCallback));
+			}, { fileSystem }, true);
 
-		// window creation must happen on the main thread
-		m_MainWindow = std::make_unique<Window>(props);
-		m_MainWindow->SetEventCallback(PR_BIND_EVENT_FN(Application::EventCallback));
-		
 		// can't be done before the first window creation (glfwInit())
-		VulkanInstance::Init();
+		auto vulkan = startup.AddStage("VulkanInstance", []() { VulkanInstance::Init(); }, { window });
+
+		// queries the framebuffer size, which GLFW only allows on the main thread
+		startup.AddStage("Renderer", [this]()
+			{
+				// creates the GPU objects of loads started without it
+				ResourceManager::SetRenderer(world->systems.Create<Renderer>(m_MainWindow.get()));
+			}, { worldStage, window, vulkan }, true);
 
-		world = std::make_unique<World>();
-		world->systems.Create<Renderer>(m_MainWindow.get());
+		// compiled in the background while the window and Vulkan come up, the pipeline is created in one of the first frames
+		startup.AddStage("Shaders", []()
+			{
+				Resource<Shader>::CreateAsync("flat_shader", "res/shaders/flat_test.glsl");
+			}, { fileSystem, preload, resources });
+
+		startup.Run();
+		startup.LogReport();
+
+		m_LastFrameTime = GetTime();
+	}
 
-		auto renderer = world->systems.Get<Renderer>();
-		Resource<Shader>::Create("flat_shader", "res/shaders/flat_test.glsl", renderer);
+	Application::Application(const HeadlessProperties& props, const EngineProperties& engine)
+		: m_HeadlessProperties(props)
+	{
+		PR_CORE_ASSERT(!g_Application, "There is already an Application instance!");
+		PR_CORE_ASSERT(props.tickRate > 0.0f, "Headless tick rate must be positive!");
+		g_Application = this; // set static for global access
+		configure(engine);
 
+		// no window, no VulkanInstance, no Renderer
+		StartupGraph startup;
+		auto fileSystem = startup.AddStage("FileSystem", []() { mountResources(); });
+		startup.AddStage("ResourceManager", []() { ResourceManager::Init(); });
+		startup.AddStage("Lua", [this]() { m_LuaInstance = std::make_unique<Lua>(); }, { fileSystem });
+		startup.AddStage("World", [this]() { world = std::make_unique<World>(); });
+		startup.Run();
+		startup.LogReport();
 
+		m_FixedTimestep = 1.0f / props.tickRate;
 		m_LastFrameTime = GetTime();
 	}
 
@@ -44,35 +113,216 @@ namespace Prism {
 	{
 		// must be done before world destruction (world holds VulkanContext)
 		ResourceManager::Shutdown();
+		// loads are done, nothing reads files anymore
+		VirtualFileSystem::UnmountAll();
 
 		// invoke destruction of RAII objects
 		world = nullptr;
+		bool headless = IsHeadless();
 		m_MainWindow = nullptr;
 		m_LuaInstance = nullptr;
 
-		VulkanInstance::Shutdown();
+		if (!headless)
+			VulkanInstance::Shutdown();
+
+		// whatever is left here outlives the application
+		MemoryTracker::LogReport();
+		// the engine's threads are idle, later messages are formatted again
+		BinaryLog::Close();
+	}
+
+	void Application::configure(const EngineProperties& engine)
+	{
+		for (const auto& [tag, bytes] : engine.memoryBudgets)
+			MemoryTracker::SetBudget(tag, bytes);
+		if (!engine.logLevels.empty())
+			Log::SetLevels(engine.logLevels);
+		// before the startup stages, nothing else logs yet
+		if (!engine.binaryLogPath.empty())
+			BinaryLog::Open(engine.binaryLogPath);
 	}
 
 	void Application::Run()
 	{
+		if (IsHeadless())
+		{
+			runHeadless();
+			return;
+		}
+
+		if (m_SimulationThreadEnabled)
+			startSimulationThread();
 
+		PR_PROFILE_THREAD("main");
 		while (m_Running)
 		{
+			{
+				PR_PROFILE_SCOPE("FrameLimiter");
+				m_FrameLimiter.Wait();
+			}
+			PR_PROFILE_FRAME();
+
+			// the simulation thread is parked from here on until kickSimulation
+			{
+				PR_PROFILE_SCOPE("WaitForSimulation");
+				waitForSimulation();
+			}
+			// frame memory of the frame before last is free now, the last frame's double-buffered data stays valid
+			FrameAllocator::NewFrame();
+			{
+				PR_PROFILE_SCOPE("PollEvents");
+				m_MainWindow->OnUpdate();
+			}
+			// GPU objects of finished async loads, destruction of unused ones
+			ResourceManager::ProcessUploads();
+			ResourceManager::EvictUnused();
+			MemoryTracker::ReportBudgets();
+
 			auto dt = GetDeltaTime();
-			m_MainWindow->OnUpdate();
+			StepFrame();
+
+			if (m_Minimized)
+			{
+				// nothing to show, don't burn a core either
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				continue;
+			}
 
-			if (dt >= m_MinFrameDuration && !m_Minimized)
+			if (m_SimulationThreadEnabled)
 			{
-				/*clientApp->*/OnUpdate(dt);
+				// the snapshot is the result of the previous frame's steps
+				OnSync();
+				float alpha = m_Alpha;
+				kickSimulation(accumulate(dt));
+
+				PR_PROFILE_SCOPE("Render");
+				/*clientApp->*/OnRender(alpha);
+			}
+			else
+			{
+				for (uint32_t steps = accumulate(dt); steps > 0; --steps, ++m_TickCount)
+				{
+					PR_PROFILE_SCOPE("Simulation");
+					/*clientApp->*/OnUpdate(m_FixedTimestep);
+				}
+				OnSync();
 
-				StepFrame();
+				PR_PROFILE_SCOPE("Render");
+				/*clientApp->*/OnRender(m_Alpha);
 			}
 		}
 
+		stopSimulationThread();
+
 		if (auto renderer = world->systems.Get<Renderer>())
 			renderer->Finish();
 	}
 
+	void Application::runHeadless()
+	{
+		// ticks are never dropped: the n-th tick always simulates n / tickRate seconds
+		m_FrameLimiter.SetFrameDuration(m_HeadlessProperties.maxSpeed ? 0.0 : m_FixedTimestep);
+		const uint64_t maxTicks = m_HeadlessProperties.maxTicks;
+		const double start = GetTime();
+
+		PR_PROFILE_THREAD("main");
+		while (m_Running && (maxTicks == 0 || m_TickCount < maxTicks))
+		{
+			m_FrameLimiter.Wait();
+			PR_PROFILE_FRAME();
+			FrameAllocator::NewFrame();
+			ResourceManager::ProcessUploads();
+			ResourceManager::EvictUnused();
+			MemoryTracker::ReportBudgets();
+
+			PR_PROFILE_SCOPE("Simulation");
+			/*clientApp->*/OnUpdate(m_FixedTimestep);
+			++m_TickCount;
+		}
+
+		const double elapsed = GetTime() - start;
+		PR_CORE_INFO("Headless: {0} ticks in {1:.3f}s ({2:.1f} ticks/s, {3:.3f}ms/tick)", m_TickCount.load(), elapsed,
+			m_TickCount / elapsed, elapsed * 1000.0 / std::max<uint64_t>(m_TickCount, 1));
+	}
+
+	uint32_t Application::accumulate(float frameTime)
+	{
+		m_Accumulator += frameTime;
+		uint32_t steps = static_cast<uint32_t>(m_Accumulator / m_FixedTimestep);
+		if (steps > m_MaxStepsPerFrame)
+		{
+			PR_CORE_TRACE("Simulation is behind by {0} steps, skipping", steps - m_MaxStepsPerFrame);
+			steps = m_MaxStepsPerFrame;
+			m_Accumulator = m_FixedTimestep * steps;
+		}
+		m_Accumulator -= m_FixedTimestep * steps;
+		m_Alpha = std::min(m_Accumulator / m_FixedTimestep, 1.0f);
+		return steps;
+	}
+
+	void Application::startSimulationThread()
+	{
+		m_SimulationStop = false;
+		m_SimulationThread = std::thread([this]()
+			{
+				PR_PROFILE_THREAD("simulation");
+				std::unique_lock<std::mutex> lock(m_SimulationMutex);
+				while (true)
+				{
+					m_SimulationCondition.wait(lock, [this]() { return m_SimulationBusy || m_SimulationStop; });
+					if (m_SimulationStop)
+						return;
+
+					uint32_t steps = m_PendingSteps;
+					lock.unlock();
+					for (; steps > 0; --steps, ++m_TickCount)
+					{
+						PR_PROFILE_SCOPE("Simulation");
+						/*clientApp->*/OnUpdate(m_FixedTimestep);
+					}
+					lock.lock();
+
+					m_SimulationBusy = false;
+					m_SimulationCondition.notify_all();
+				}
+			});
+	}
+
+	void Application::stopSimulationThread()
+	{
+		if (!m_SimulationThread.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_SimulationMutex);
+			m_SimulationStop = true;
+		}
+		m_SimulationCondition.notify_all();
+		m_SimulationThread.join();
+	}
+
+	void Application::kickSimulation(uint32_t steps)
+	{
+		if (steps == 0)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_SimulationMutex);
+			m_PendingSteps = steps;
+			m_SimulationBusy = true;
+		}
+		m_SimulationCondition.notify_all();
+	}
+
+	void Application::waitForSimulation()
+	{
+		if (!m_SimulationThread.joinable())
+			return;
+
+		std::unique_lock<std::mutex> lock(m_SimulationMutex);
+		m_SimulationCondition.wait(lock, [this]() { return !m_SimulationBusy; });
+	}
+
 	void Application::EventCallback(Event& event)
 	{
 		event.Handle<WindowCloseEvent>([&](WindowCloseEvent& e)
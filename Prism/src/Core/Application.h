@@ -6,10 +6,19 @@
 #include "Core/Events/Event.h"
 #include "Core/Window/Window.h"
 #include "Core/Graphics/Renderer.h"
+#include "Core/Time/FrameLimiter.h"
+#include "Core/Memory/MemoryTracker.h"
 
 #include"Scripting/Lua.h"
 
+#include <atomic>
 #include <memory>
+#include <string>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 
 namespace Prism {
 
@@ -18,30 +27,78 @@ namespace Prism {
 	 * 
 	 * Acts as the context: holds the window, runs the main loop, receives events
 	 * 
+	 * Headless applications (HeadlessProperties) have no window, Vulkan or
+	 * Renderer: they tick the simulation at a deterministic rate, either paced
+	 * in real time or as fast as possible (benchmarks, servers, CI).
+	 *
 	 * Also manages static(!) systems (ResourceManager, VulkanInstance, ...)
 	 * => there must only be one instance of this class!
 	 *****************************************************************************/
 	class Application {
 	public:
+		struct HeadlessProperties
+		{
+			float tickRate = 60.0f; // OnUpdate is always called with 1 / tickRate
+			bool maxSpeed = false; // don't wait for real time between ticks
+			uint64_t maxTicks = 0; // stop after this many ticks, 0: run until Quit()
+		};
 
-		Application(const Window::Properties& props);
+		// settings of the engine subsystems, windowed or headless
+		struct EngineProperties
+		{
+			// budgets of the MemoryTracker tags (bytes), exceeding one is logged once per frame
+			std::vector<std::pair<MemoryTag, size_t>> memoryBudgets;
+			// if set, messages are written to this BinaryLog file instead of formatted (errors to both),
+			// turn it into text with "LogDecoder <file> [pattern] > log.txt" (Tools/LogDecoder)
+			std::string binaryLogPath;
+			// applied with Log::SetLevels, e.g. "info,Vulkan=trace" (empty: trace in debug builds, warn otherwise)
+			std::string logLevels;
+		};
+
+		Application(const Window::Properties& props, const EngineProperties& engine = {});
+		Application(const HeadlessProperties& props, const EngineProperties& engine = {});
 		virtual ~Application();
 
 		void Run();
 		void EventCallback(Event&);
 
+		// called zero or more times per frame with the fixed timestep
 		virtual void OnUpdate(float dt) = 0;
 		virtual void OnEvent(Event&) = 0;
+		// alpha in [0, 1): progress from the previous to the latest simulation step
+		virtual void OnRender(float alpha) {}
+		// simulation and rendering halted, copy what OnRender needs
+		virtual void OnSync() {}
 
 		Lua* GetLuaInstance() { return m_LuaInstance.get(); }
+		bool IsHeadless() const { return !m_MainWindow; }
 
 	protected:
-		double GetTime() { return m_MainWindow->GetTime(); }
+		void Quit() { m_Running = false; }
+		uint64_t GetTickCount() const { return m_TickCount; }
+
+		double GetTime() { return FrameLimiter::Now(); }
 		float GetDeltaTime() { return (float)(GetTime() - m_LastFrameTime); }
-		void LimitFPS(float fps) { m_MinFrameDuration = 1.0f / fps; }
-		void UnlimitFPS() { m_MinFrameDuration = 0.0f; }
+		void LimitFPS(float fps) { m_FrameLimiter.SetFrameDuration(1.0 / fps); }
+		void UnlimitFPS() { m_FrameLimiter.SetFrameDuration(0.0); }
+
+		void SetFixedTimestep(float dt) { m_FixedTimestep = dt; }
+		float GetFixedTimestep() const { return m_FixedTimestep; }
+		// upper bound of steps per frame, drops time instead of spiraling when the simulation can't keep up
+		void SetMaxStepsPerFrame(uint32_t steps) { m_MaxStepsPerFrame = steps; }
+		// must be set before Run()
+		void EnableSimulationThread(bool enable) { m_SimulationThreadEnabled = enable; }
 	private:
 		void StepFrame() { m_LastFrameTime = GetTime(); }
+		void configure(const EngineProperties& engine);
+		void runHeadless();
+		// adds the frame time to the accumulator, returns the number of steps to simulate
+		uint32_t accumulate(float frameTime);
+
+		void startSimulationThread();
+		void stopSimulationThread();
+		void kickSimulation(uint32_t steps);
+		void waitForSimulation();
 
 	protected:
 		std::unique_ptr<World> world = nullptr;
@@ -52,8 +109,24 @@ namespace Prism {
 		bool m_Running = true;
 		bool m_Minimized = false;
 
+		HeadlessProperties m_HeadlessProperties;
+		std::atomic<uint64_t> m_TickCount = 0; // advanced by the simulation thread
+
 		double m_LastFrameTime;
-		float m_MinFrameDuration = 0;
+		FrameLimiter m_FrameLimiter;
+
+		float m_FixedTimestep = 1.0f / 60.0f;
+		uint32_t m_MaxStepsPerFrame = 8;
+		float m_Accumulator = 0.0f;
+		float m_Alpha = 0.0f;
+
+		bool m_SimulationThreadEnabled = false;
+		std::thread m_SimulationThread;
+		std::mutex m_SimulationMutex;
+		std::condition_variable m_SimulationCondition;
+		uint32_t m_PendingSteps = 0;
+		bool m_SimulationBusy = false;
+		bool m_SimulationStop = false;
 	};
 
 	// defined in the client application
@@ -2,42 +2,56 @@
 
 namespace Prism {
 
+	static std::string shaderName(const std::string& filepath)
+	{
+		size_t pos = filepath.find_last_of('/');
+		if (pos == std::string::npos)
+			return "shader_without_name";
+		return filepath.substr(pos, filepath.size() - pos - 1);
+	}
+
 	std::optional<ShaderBinary> ShaderUtil::Load(const std::string& filepath)
 	{
 		auto code = ReadFile(filepath);
 		if (!code.has_value()) return std::nullopt;
 
+		return Compile(code.value(), shaderName(filepath).c_str());
+	}
 
-		const char* name = "shader_without_name";
-		size_t pos = filepath.find_last_of('/');
-		if (pos != std::string::npos)
-			name = filepath.substr(pos, filepath.size() - pos - 1).c_str();
+	std::optional<ShaderBinary> ShaderUtil::Load(const std::string& filepath, std::string_view source)
+	{
+		auto code = Parse(source, filepath);
+		if (!code.has_value()) return std::nullopt;
 
-		return Compile(code.value(), name);
+		return Compile(code.value(), shaderName(filepath).c_str());
 	}
 
 	std::optional<ShaderCode> ShaderUtil::ReadFile(const std::string& filepath)
 	{
-		auto fileContent = StringReader::ReadFile(filepath);
-		if (!fileContent.has_value())
+		auto file = VirtualFileSystem::Open(filepath);
+		if (!file.has_value())
 		{
-			PR_CORE_ERROR("Could not load shader {0}", filepath);
+			PR_VULKAN_ERROR("Could not load shader {0}", filepath);
 			return std::nullopt;
 		}
+		return Parse(file->GetView(), filepath);
+	}
 
+	std::optional<ShaderCode> ShaderUtil::Parse(std::string_view source, const std::string& filepath)
+	{
 		// split content into shader sources
 		ShaderCode result;
 
 		const char* typeToken = "#type";
 		size_t typeTokenLength = strlen(typeToken);
-		size_t pos = fileContent.value().find(typeToken, 0);
+		size_t pos = source.find(typeToken, 0);
 		while (pos != std::string::npos)
 		{
 			// read type
-			size_t eol = fileContent.value().find_first_of("\r\n", pos);
+			size_t eol = source.find_first_of("\r\n", pos);
 			PR_CORE_ASSERT(eol != std::string::npos, "Syntax error");
 			size_t begin = pos + typeTokenLength + 1;
-			std::string typestr = fileContent.value().substr(begin, eol - begin);
+			std::string_view typestr = source.substr(begin, eol - begin);
 
 			// parse type
 			ShaderType type;
@@ -55,15 +69,15 @@ namespace Prism {
 				type = ShaderType::TesselationEvaluation;
 			else
 			{
-				PR_CORE_ERROR(false, "Unknown shader type '{0}' in {1}", typestr, filepath);
+				PR_VULKAN_ERROR("Unknown shader type '{0}' in {1}", typestr, filepath);
 				return std::nullopt;
 			}
 
 			// read shader source
-			size_t nextLinePos = fileContent.value().find_first_not_of("\r\n", eol);
-			pos = fileContent.value().find(typeToken, nextLinePos);
-			result[type] = fileContent.value().substr(nextLinePos,
-				pos - (nextLinePos == std::string::npos ? fileContent.value().size() - 1 : nextLinePos));
+			size_t nextLinePos = source.find_first_not_of("\r\n", eol);
+			pos = source.find(typeToken, nextLinePos);
+			result[type] = std::string(source.substr(nextLinePos,
+				pos - (nextLinePos == std::string::npos ? source.size() - 1 : nextLinePos)));
 		}
 
 		return result;
@@ -86,13 +100,13 @@ namespace Prism {
 				name, options);
 
 			if (compiled.GetCompilationStatus() != shaderc_compilation_status_success) {
-				PR_CORE_ERROR("Error compiling shader '{0}': {1}", name, compiled.GetErrorMessage());
+				PR_VULKAN_ERROR("Error compiling shader '{0}': {1}", name, compiled.GetErrorMessage());
 				return std::nullopt;
 			}
 			result[shader.first] = { compiled.cbegin(), compiled.cend() };
 		}
 
-		PR_CORE_TRACE("Shader '{0}' compiled", name);
+		PR_VULKAN_TRACE("Shader '{0}' compiled", name);
 		return result;
 	}
 
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Util/Log/Log.h"
-#include "Util/FileReader/StringReader.h"
+#include "Util/FileSystem/VirtualFileSystem.h"
 
 #include <vulkan/vulkan.h>
 #include <shaderc/shaderc.hpp>
@@ -31,7 +31,10 @@ namespace Prism {
 	public:
 
 		static std::optional<ShaderBinary> Load(const std::string& filepath);
+		// source is the contents of filepath, read already
+		static std::optional<ShaderBinary> Load(const std::string& filepath, std::string_view source);
 		static std::optional<ShaderBinary> Compile(const ShaderCode& code, const char* name);
 		static std::optional<ShaderCode> ReadFile(const std::string& filepath);
+		static std::optional<ShaderCode> Parse(std::string_view source, const std::string& filepath);
 	};
 }
\ No newline at end of file
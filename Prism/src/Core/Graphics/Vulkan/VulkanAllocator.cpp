@@ -0,0 +1,37 @@
+#include "VulkanAllocator.h"
+
+#include "Core/Memory/MemoryTracker.h"
+
+namespace Prism {
+
+	static void* VKAPI_PTR vulkanAllocate(void*, size_t size, size_t alignment, VkSystemAllocationScope)
+	{
+		return MemoryTracker::Allocate(MemoryTag::VulkanHost, size, alignment);
+	}
+
+	static void* VKAPI_PTR vulkanReallocate(void*, void* original, size_t size, size_t alignment, VkSystemAllocationScope)
+	{
+		if (!original)
+			return MemoryTracker::Allocate(MemoryTag::VulkanHost, size, alignment);
+		return MemoryTracker::Reallocate(original, size, alignment);
+	}
+
+	static void VKAPI_PTR vulkanFree(void*, void* memory)
+	{
+		MemoryTracker::Free(memory);
+	}
+
+	static const VkAllocationCallbacks s_Callbacks = {
+		nullptr, // pUserData
+		vulkanAllocate,
+		vulkanReallocate,
+		vulkanFree,
+		nullptr, // pfnInternalAllocation
+		nullptr  // pfnInternalFree
+	};
+
+	const VkAllocationCallbacks* VulkanAllocator::Get()
+	{
+		return &s_Callbacks;
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+namespace Prism {
+
+	/**
+	 * Host allocation callbacks routing the driver's CPU memory through the
+	 * MemoryTracker (tag VulkanHost), pass to every vkCreateX/vkDestroyX call
+	 */
+	class VulkanAllocator {
+	public:
+		static const VkAllocationCallbacks* Get();
+	};
+}
@@ -1,5 +1,6 @@
 #include "VulkanContext.h"
 #include "VulkanInstance.h"
+#include "VulkanAllocator.h"
 
 #include <GLFW/glfw3.h>
 #include <map>
@@ -57,8 +58,8 @@ namespace Prism {
 		m_DefaultRenderPass = nullptr;
 		m_Swapchain = nullptr; // destruct manually before destroying device and surface
 
-		vkDestroyDevice(m_Device, nullptr);
-		vkDestroySurfaceKHR(VulkanInstance::Get(), m_Surface, nullptr);
+		vkDestroyDevice(m_Device, VulkanAllocator::Get());
+		vkDestroySurfaceKHR(VulkanInstance::Get(), m_Surface, VulkanAllocator::Get());
 	}
 
 	void VulkanContext::Resize()
@@ -75,7 +76,7 @@ namespace Prism {
 	VkSurfaceKHR VulkanContext::createSurface(GLFWwindow* window)
 	{
 		VkSurfaceKHR result;
-		auto res = glfwCreateWindowSurface(VulkanInstance::Get(), window, nullptr, &result);
+		auto res = glfwCreateWindowSurface(VulkanInstance::Get(), window, VulkanAllocator::Get(), &result);
 		PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to create Vulkan window surface!");
 
 		return result;
@@ -191,7 +192,7 @@ namespace Prism {
 			deviceCreateInfo.pEnabledFeatures = nullptr;
 
 			VkDevice device;
-			auto res = vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device);
+			auto res = vkCreateDevice(physicalDevice, &deviceCreateInfo, VulkanAllocator::Get(), &device);
 			PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to create logical device!");
 
 			// finally retreive configured queues
@@ -1,4 +1,5 @@
 #include "VulkanInstance.h"
+#include "VulkanAllocator.h"
 
 #include "Util/Log/Log.h"
 
@@ -17,7 +18,7 @@ namespace Prism {
 		const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,
 		void* pUserData) {
 
-		PR_CORE_ERROR(pCallbackData->pMessage);
+		PR_VULKAN_ERROR(pCallbackData->pMessage);
 
 		return VK_FALSE;
 	}
@@ -83,12 +84,12 @@ namespace Prism {
 			createInfo.pNext = &debugCreateInfo;
 		}
 
-		auto result = vkCreateInstance(&createInfo, nullptr, &s_Instance);
+		auto result = vkCreateInstance(&createInfo, VulkanAllocator::Get(), &s_Instance);
 		PR_CORE_ASSERT(result == VK_SUCCESS, "Failed to create Vulkan instance!");
-		PR_CORE_INFO("Vulkan instance created");
+		PR_VULKAN_INFO("Vulkan instance created");
 
 		if (useValidation) {
-			auto res = createDebugUtilsMessengerEXT(s_Instance, &debugCreateInfo, nullptr, &debugMessenger);
+			auto res = createDebugUtilsMessengerEXT(s_Instance, &debugCreateInfo, VulkanAllocator::Get(), &debugMessenger);
 			PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to setup Vulkan debugMessenger");
 		}
 
@@ -98,9 +99,9 @@ namespace Prism {
 	void VulkanInstance::Shutdown()
 	{
 		if (useValidation) {
-			destroyDebugUtilsMessengerEXT(s_Instance, debugMessenger, nullptr);
+			destroyDebugUtilsMessengerEXT(s_Instance, debugMessenger, VulkanAllocator::Get());
 		}
-		vkDestroyInstance(s_Instance, nullptr);
+		vkDestroyInstance(s_Instance, VulkanAllocator::Get());
 
 		s_Initialized = false;
 	}
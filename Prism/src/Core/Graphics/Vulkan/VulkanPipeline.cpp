@@ -1,4 +1,5 @@
 #include "VulkanPipeline.h"
+#include "VulkanAllocator.h"
 
 namespace Prism {
 
@@ -73,17 +74,17 @@ namespace Prism {
 		createInfo.basePipelineHandle = nullptr;
 		createInfo.basePipelineIndex = -1;
 
-		auto res = vkCreateGraphicsPipelines(context->GetDevice(), nullptr, 1, &createInfo, nullptr, &m_Pipeline);
+		auto res = vkCreateGraphicsPipelines(context->GetDevice(), nullptr, 1, &createInfo, VulkanAllocator::Get(), &m_Pipeline);
 
-		PR_CORE_TRACE("Pipeline created");
+		PR_VULKAN_TRACE("Pipeline created");
 	}
 
 	VulkanPipeline::~VulkanPipeline()
 	{
-		vkDestroyPipeline(m_Context->GetDevice(), m_Pipeline, nullptr);
-		vkDestroyPipelineLayout(m_Context->GetDevice(), m_Layout, nullptr);
+		vkDestroyPipeline(m_Context->GetDevice(), m_Pipeline, VulkanAllocator::Get());
+		vkDestroyPipelineLayout(m_Context->GetDevice(), m_Layout, VulkanAllocator::Get());
 		for (const auto& shaderModule : m_ShaderModules)
-			vkDestroyShaderModule(m_Context->GetDevice(), shaderModule.second.module, nullptr);
+			vkDestroyShaderModule(m_Context->GetDevice(), shaderModule.second.module, VulkanAllocator::Get());
 	}
 
 	void VulkanPipeline::setShaders(const ShaderBinary& spv)
@@ -96,7 +97,7 @@ namespace Prism {
 			moduleCreateInfo.codeSize = sizeof(uint32_t) * shader.second.size();
 			moduleCreateInfo.pCode = shader.second.data();
 
-			auto res = vkCreateShaderModule(m_Context->GetDevice(), &moduleCreateInfo, nullptr, &m_ShaderModules[shader.first].module);
+			auto res = vkCreateShaderModule(m_Context->GetDevice(), &moduleCreateInfo, VulkanAllocator::Get(), &m_ShaderModules[shader.first].module);
 			PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to create shader module");
 
 			m_ShaderModules[shader.first].info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -185,7 +186,7 @@ namespace Prism {
 		pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
 		pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
 
-		auto res = vkCreatePipelineLayout(m_Context->GetDevice(), &pipelineLayoutInfo, nullptr, &m_Layout);
+		auto res = vkCreatePipelineLayout(m_Context->GetDevice(), &pipelineLayoutInfo, VulkanAllocator::Get(), &m_Layout);
 		PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to create pipeline layout");
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "VulkanRenderPass.h"
 #include "VulkanContext.h"
+#include "VulkanAllocator.h"
 
 #include <array>
 
@@ -35,7 +36,7 @@ namespace Prism {
 		createInfo.dependencyCount = static_cast<uint32_t>(blueprint.subpassDependencies.size());
 		createInfo.pDependencies = blueprint.subpassDependencies.data();
 
-		auto res = vkCreateRenderPass(context->GetDevice(), &createInfo, nullptr, &m_RenderPass);
+		auto res = vkCreateRenderPass(context->GetDevice(), &createInfo, VulkanAllocator::Get(), &m_RenderPass);
 		PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to create RenderPass");
 
 		SetClearValue({ { 1.0f, 0.0f, 1.0f, 1.0f } });
@@ -43,7 +44,7 @@ namespace Prism {
 
 	VulkanRenderPass::~VulkanRenderPass()
 	{
-		vkDestroyRenderPass(m_Context->GetDevice(), m_RenderPass, nullptr);
+		vkDestroyRenderPass(m_Context->GetDevice(), m_RenderPass, VulkanAllocator::Get());
 	}
 
 	//void RenderPass::Begin(
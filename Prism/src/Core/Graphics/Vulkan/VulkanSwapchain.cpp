@@ -1,4 +1,5 @@
 #include "VulkanSwapchain.h"
+#include "VulkanAllocator.h"
 
 #include "Util/Log/Log.h"
 
@@ -31,7 +32,7 @@ namespace Prism {
 		swapchainCreateInfo.clipped = true;
 		swapchainCreateInfo.oldSwapchain = oldSwapchain ? oldSwapchain.value() : nullptr;
 
-		vkCreateSwapchainKHR(device, &swapchainCreateInfo, nullptr, &swapchain);
+		vkCreateSwapchainKHR(device, &swapchainCreateInfo, VulkanAllocator::Get(), &swapchain);
 
 		// get images from Swapchain
 		uint32_t swapchainImageCount;
@@ -47,14 +48,14 @@ namespace Prism {
 	VulkanSwapchain::~VulkanSwapchain()
 	{
 		for (auto& framebuffer : framebuffers)
-			vkDestroyFramebuffer(m_Device, framebuffer, nullptr);
+			vkDestroyFramebuffer(m_Device, framebuffer, VulkanAllocator::Get());
 		framebuffers.clear();
 
 		for (const auto& imageView : imageViews)
-			vkDestroyImageView(m_Device, imageView, nullptr);
+			vkDestroyImageView(m_Device, imageView, VulkanAllocator::Get());
 		imageViews.clear();
 
-		vkDestroySwapchainKHR(m_Device, swapchain, nullptr);
+		vkDestroySwapchainKHR(m_Device, swapchain, VulkanAllocator::Get());
 	}
 
 	void VulkanSwapchain::CreateFrameBuffers(VkRenderPass renderPass)
@@ -77,7 +78,7 @@ namespace Prism {
 			createInfo.height = extent.height;
 			createInfo.layers = 1;
 
-			auto res = vkCreateFramebuffer(m_Device, &createInfo, nullptr, &framebuffers[i]);
+			auto res = vkCreateFramebuffer(m_Device, &createInfo, VulkanAllocator::Get(), &framebuffers[i]);
 			PR_CORE_ASSERT(res == VK_SUCCESS, "Failed to create framebuffer");
 		}
 	}
@@ -100,7 +101,7 @@ namespace Prism {
 		createInfo.subresourceRange.layerCount = 1;
 
 		VkImageView result;
-		vkCreateImageView(m_Device, &createInfo, nullptr, &result);
+		vkCreateImageView(m_Device, &createInfo, VulkanAllocator::Get(), &result);
 		return result;
 	}
 }
\ No newline at end of file
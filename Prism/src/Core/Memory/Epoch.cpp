@@ -0,0 +1,132 @@
+#include "Epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Prism {
+
+	// collect once this many objects are pending
+	constexpr size_t c_CollectThreshold = 64;
+
+	struct EpochRecord {
+		std::atomic<uint64_t> active = 0; // epoch announced by the outermost guard, 0 when outside
+		uint32_t depth = 0; // nesting, owning thread only
+	};
+
+	struct Retired {
+		void* object;
+		void (*deleter)(void*);
+		uint64_t epoch;
+	};
+
+	std::atomic<uint64_t> g_Epoch = 1;
+
+	std::mutex g_EpochMutex;
+	std::vector<std::unique_ptr<EpochRecord>> g_EpochRecords; // never shrinks, threads keep pointers
+	std::vector<EpochRecord*> g_FreeEpochRecords; // of exited threads
+	std::vector<Retired> g_Retired;
+
+	// returns the record to the free list when the thread exits
+	struct EpochRecordHandle {
+		EpochRecord* record = nullptr;
+		~EpochRecordHandle()
+		{
+			if (!record) return;
+			std::lock_guard<std::mutex> lock(g_EpochMutex);
+			g_FreeEpochRecords.push_back(record);
+		}
+	};
+	thread_local EpochRecordHandle t_EpochRecord;
+
+	static EpochRecord& localRecord()
+	{
+		if (!t_EpochRecord.record)
+		{
+			std::lock_guard<std::mutex> lock(g_EpochMutex);
+			if (!g_FreeEpochRecords.empty())
+			{
+				t_EpochRecord.record = g_FreeEpochRecords.back();
+				g_FreeEpochRecords.pop_back();
+			}
+			else
+			{
+				g_EpochRecords.push_back(std::make_unique<EpochRecord>());
+				t_EpochRecord.record = g_EpochRecords.back().get();
+			}
+		}
+		return *t_EpochRecord.record;
+	}
+
+	Epoch::Guard::Guard()
+	{
+		EpochRecord& record = localRecord();
+		if (record.depth++ == 0)
+		{
+			record.active.store(g_Epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			// the announcement must be visible before any shared pointer is read
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	Epoch::Guard::~Guard()
+	{
+		EpochRecord& record = *t_EpochRecord.record;
+		if (--record.depth == 0)
+			record.active.store(0, std::memory_order_release);
+	}
+
+	// g_EpochMutex must be held
+	static void collect(std::vector<Retired>& reclaimable)
+	{
+		// readers that announce the new epoch started after everything retired so far was unlinked
+		g_Epoch.fetch_add(1, std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		uint64_t oldest = std::numeric_limits<uint64_t>::max();
+		for (auto& record : g_EpochRecords)
+		{
+			const uint64_t active = record->active.load(std::memory_order_acquire);
+			if (active != 0) oldest = std::min(oldest, active);
+		}
+
+		auto reachable = std::partition(g_Retired.begin(), g_Retired.end(), [=](const Retired& r) { return r.epoch >= oldest; });
+		reclaimable.assign(reachable, g_Retired.end());
+		g_Retired.erase(reachable, g_Retired.end());
+	}
+
+	void Epoch::Retire(void* object, void (*deleter)(void*))
+	{
+		std::vector<Retired> reclaimable;
+		{
+			std::lock_guard<std::mutex> lock(g_EpochMutex);
+			g_Retired.push_back({ object, deleter, g_Epoch.load(std::memory_order_seq_cst) });
+			if (g_Retired.size() >= c_CollectThreshold)
+				collect(reclaimable);
+		}
+		// deleters may retire again
+		for (const Retired& r : reclaimable)
+			r.deleter(r.object);
+	}
+
+	void Epoch::Collect()
+	{
+		std::vector<Retired> reclaimable;
+		{
+			std::lock_guard<std::mutex> lock(g_EpochMutex);
+			collect(reclaimable);
+		}
+		for (const Retired& r : reclaimable)
+			r.deleter(r.object);
+	}
+
+	size_t Epoch::GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(g_EpochMutex);
+		return g_Retired.size();
+	}
+}
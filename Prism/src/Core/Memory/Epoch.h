@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Prism {
+
+	/**
+	 * Epoch-based reclamation for lock-free readers
+	 *
+	 * Readers wrap their accesses to shared structures in an Epoch::Guard.
+	 * Writers unlink an object first and then Retire() it; it is deleted
+	 * once every guard that was active at that point has been left.
+	 *
+	 * Guards are cheap (a store and a fence) and may be nested. Pointers
+	 * obtained inside a guard must not be used after leaving it.
+	 */
+	class Epoch {
+	public:
+		class Guard {
+		public:
+			Guard();
+			~Guard();
+			Guard(const Guard&) = delete;
+			Guard& operator=(const Guard&) = delete;
+		};
+
+		template<typename T>
+		static void Retire(T* object) { Retire(object, [](void* p) { delete static_cast<T*>(p); }); }
+		static void Retire(void* object, void (*deleter)(void*));
+
+		// deletes what no guard can see anymore (also done by Retire every now and then)
+		static void Collect();
+		static size_t GetPendingCount();
+	};
+}
@@ -0,0 +1,112 @@
+#include "FrameAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Prism {
+
+	struct ThreadArenas {
+		ThreadArenas(size_t size) : frame(size), doubleBuffered{ LinearArena(size), LinearArena(size) } {}
+
+		LinearArena frame;
+		LinearArena doubleBuffered[2]; // indexed by frame parity
+
+		// frame index each arena was last reset for
+		uint64_t frameStamp = 0;
+		uint64_t doubleBufferedStamp[2] = { 0, 0 };
+	};
+
+	std::atomic<uint64_t> g_FrameIndex = 1;
+	std::atomic<size_t> g_ArenaSize = 1 << 20;
+
+	std::mutex g_ArenaMutex;
+	std::vector<std::unique_ptr<ThreadArenas>> g_Arenas; // never shrinks, threads keep pointers
+	std::vector<ThreadArenas*> g_FreeArenas; // of exited threads, handed to new ones
+
+	// returns the arenas to the free list when the thread exits
+	struct ThreadArenasHandle {
+		ThreadArenas* arenas = nullptr;
+		~ThreadArenasHandle()
+		{
+			if (!arenas) return;
+			std::lock_guard<std::mutex> lock(g_ArenaMutex);
+			g_FreeArenas.push_back(arenas);
+		}
+	};
+	thread_local ThreadArenasHandle t_Arenas;
+
+	static ThreadArenas& localArenas()
+	{
+		if (!t_Arenas.arenas)
+		{
+			std::lock_guard<std::mutex> lock(g_ArenaMutex);
+			if (!g_FreeArenas.empty())
+			{
+				t_Arenas.arenas = g_FreeArenas.back();
+				g_FreeArenas.pop_back();
+			}
+			else
+			{
+				g_Arenas.push_back(std::make_unique<ThreadArenas>(g_ArenaSize.load()));
+				t_Arenas.arenas = g_Arenas.back().get();
+			}
+		}
+		return *t_Arenas.arenas;
+	}
+
+	void FrameAllocator::NewFrame()
+	{
+		g_FrameIndex.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	uint64_t FrameAllocator::GetFrameIndex()
+	{
+		return g_FrameIndex.load(std::memory_order_acquire);
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		ThreadArenas& arenas = localArenas();
+		const uint64_t frame = GetFrameIndex();
+		if (arenas.frameStamp != frame)
+		{
+			arenas.frame.Reset();
+			arenas.frameStamp = frame;
+		}
+		return arenas.frame.Allocate(size, alignment);
+	}
+
+	void* FrameAllocator::AllocateDoubleBuffered(size_t size, size_t alignment)
+	{
+		ThreadArenas& arenas = localArenas();
+		const uint64_t frame = GetFrameIndex();
+		const uint32_t parity = frame & 1;
+		// the arena of this parity was last used two frames ago at the earliest
+		if (arenas.doubleBufferedStamp[parity] != frame)
+		{
+			arenas.doubleBuffered[parity].Reset();
+			arenas.doubleBufferedStamp[parity] = frame;
+		}
+		return arenas.doubleBuffered[parity].Allocate(size, alignment);
+	}
+
+	void FrameAllocator::SetArenaSize(size_t bytes)
+	{
+		g_ArenaSize = bytes;
+	}
+
+	FrameAllocator::Stats FrameAllocator::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(g_ArenaMutex);
+		Stats stats;
+		stats.threads = static_cast<uint32_t>(g_Arenas.size());
+		for (const auto& arenas : g_Arenas)
+			for (const LinearArena* arena : { &arenas->frame, &arenas->doubleBuffered[0], &arenas->doubleBuffered[1] })
+			{
+				stats.used += arena->GetUsed();
+				stats.capacity += arena->GetCapacity();
+				stats.highWaterMark += arena->GetHighWaterMark();
+			}
+		return stats;
+	}
+}
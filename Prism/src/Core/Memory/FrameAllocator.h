@@ -0,0 +1,80 @@
+#pragma once
+
+#include "LinearArena.h"
+
+#include <vector>
+#include <string>
+
+namespace Prism {
+
+	/**
+	 * Transient memory for the current frame, one bump arena per thread
+	 *
+	 * Allocate(): valid until the end of the current frame
+	 * AllocateDoubleBuffered(): valid until the end of the next frame, e.g. for
+	 *   data produced by the simulation and consumed by the renderer later on
+	 *
+	 * NewFrame() is a single counter increment; each thread resets its arenas
+	 * lazily on its first allocation in a new frame, so no thread touches
+	 * another thread's arena. Must be called while no frame memory is in use.
+	 */
+	class FrameAllocator {
+	public:
+		static void NewFrame();
+		static uint64_t GetFrameIndex();
+
+		static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+		static void* AllocateDoubleBuffered(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		static T* Allocate(size_t count = 1) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+		template<typename T>
+		static T* AllocateDoubleBuffered(size_t count = 1) { return static_cast<T*>(AllocateDoubleBuffered(count * sizeof(T), alignof(T))); }
+
+		// initial block size of arenas created after this call
+		static void SetArenaSize(size_t bytes);
+
+		struct Stats {
+			uint32_t threads = 0;
+			size_t used = 0, capacity = 0, highWaterMark = 0; // summed over all arenas
+		};
+		// only consistent while no other thread allocates
+		static Stats GetStats();
+	};
+
+	enum class FrameLifetime { Frame, DoubleBuffered };
+
+	/**
+	 * STL allocator adaptor for the FrameAllocator, deallocate() is a no-op
+	 */
+	template<typename T, FrameLifetime Lifetime = FrameLifetime::Frame>
+	class FrameStdAllocator {
+	public:
+		using value_type = T;
+		template<typename U> struct rebind { using other = FrameStdAllocator<U, Lifetime>; };
+
+		FrameStdAllocator() = default;
+		template<typename U>
+		FrameStdAllocator(const FrameStdAllocator<U, Lifetime>&) {}
+
+		T* allocate(size_t count)
+		{
+			if constexpr (Lifetime == FrameLifetime::Frame)
+				return FrameAllocator::Allocate<T>(count);
+			else
+				return FrameAllocator::AllocateDoubleBuffered<T>(count);
+		}
+		void deallocate(T*, size_t) {}
+
+		template<typename U>
+		bool operator==(const FrameStdAllocator<U, Lifetime>&) const { return true; }
+		template<typename U>
+		bool operator!=(const FrameStdAllocator<U, Lifetime>&) const { return false; }
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameStdAllocator<T>>;
+	template<typename T>
+	using DoubleBufferedFrameVector = std::vector<T, FrameStdAllocator<T, FrameLifetime::DoubleBuffered>>;
+	using FrameString = std::basic_string<char, std::char_traits<char>, FrameStdAllocator<char>>;
+}
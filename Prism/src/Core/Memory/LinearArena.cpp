@@ -0,0 +1,66 @@
+#include "LinearArena.h"
+
+#include <algorithm>
+
+namespace Prism {
+
+	void LinearArena::nextBlock(size_t minSize)
+	{
+		// record the usage of the block we leave
+		m_UsedBefore = GetUsed();
+
+		if (!m_Blocks.empty())
+			++m_BlockIndex;
+
+		// skip kept blocks that are too small for this request
+		while (m_BlockIndex < m_Blocks.size() && m_Blocks[m_BlockIndex].size < minSize)
+			++m_BlockIndex;
+
+		if (m_BlockIndex >= m_Blocks.size())
+		{
+			const size_t size = std::max(m_BlockSize, minSize);
+			m_Blocks.push_back({ std::make_unique<uint8_t[]>(size), size });
+			m_BlockIndex = m_Blocks.size() - 1;
+		}
+
+		m_Current = reinterpret_cast<uintptr_t>(m_Blocks[m_BlockIndex].data.get());
+		m_End = m_Current + m_Blocks[m_BlockIndex].size;
+	}
+
+	void LinearArena::Reset()
+	{
+		m_HighWaterMark = std::max(m_HighWaterMark, GetUsed());
+
+		// one overflow means the frame needs more: merge into a single block once
+		if (m_Blocks.size() > 1 && m_BlockIndex > 0)
+		{
+			m_BlockSize = std::max(m_BlockSize, GetCapacity());
+			m_Blocks.clear();
+		}
+
+		m_BlockIndex = 0;
+		m_UsedBefore = 0;
+		if (m_Blocks.empty())
+		{
+			m_Current = m_End = 0;
+			return;
+		}
+		m_Current = reinterpret_cast<uintptr_t>(m_Blocks[0].data.get());
+		m_End = m_Current + m_Blocks[0].size;
+	}
+
+	size_t LinearArena::GetUsed() const
+	{
+		if (m_Blocks.empty())
+			return 0;
+		return m_UsedBefore + (m_Current - reinterpret_cast<uintptr_t>(m_Blocks[m_BlockIndex].data.get()));
+	}
+
+	size_t LinearArena::GetCapacity() const
+	{
+		size_t capacity = 0;
+		for (const Block& block : m_Blocks)
+			capacity += block.size;
+		return capacity;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Prism {
+
+	/**
+	 * Bump-pointer allocator over a list of blocks
+	 *
+	 * Deallocation is a no-op, Reset() releases everything at once in O(1)
+	 * and keeps the blocks for reuse. Not thread-safe.
+	 */
+	class LinearArena {
+	public:
+		explicit LinearArena(size_t blockSize = 1 << 20) : m_BlockSize(blockSize) {}
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			uintptr_t aligned = (m_Current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			if (aligned + size > m_End)
+			{
+				nextBlock(size + alignment);
+				aligned = (m_Current + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			}
+			m_Current = aligned + size;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		template<typename T>
+		T* Allocate(size_t count = 1) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+		void Reset();
+
+		size_t GetUsed() const; // bytes, including alignment padding
+		size_t GetCapacity() const;
+		size_t GetHighWaterMark() const { return m_HighWaterMark; }
+
+	private:
+		void nextBlock(size_t minSize);
+
+	private:
+		struct Block {
+			std::unique_ptr<uint8_t[]> data;
+			size_t size;
+		};
+
+		size_t m_BlockSize;
+		std::vector<Block> m_Blocks;
+		size_t m_BlockIndex = 0; // block m_Current points into
+		size_t m_UsedBefore = 0; // bytes used in the blocks before m_BlockIndex
+		uintptr_t m_Current = 0, m_End = 0;
+		size_t m_HighWaterMark = 0;
+	};
+
+	/**
+	 * STL allocator adaptor for a LinearArena, deallocate() is a no-op
+	 */
+	template<typename T>
+	class ArenaStdAllocator {
+	public:
+		using value_type = T;
+
+		ArenaStdAllocator(LinearArena& arena) : m_Arena(&arena) {}
+		template<typename U>
+		ArenaStdAllocator(const ArenaStdAllocator<U>& other) : m_Arena(other.m_Arena) {}
+
+		T* allocate(size_t count) { return m_Arena->Allocate<T>(count); }
+		void deallocate(T*, size_t) {}
+
+		template<typename U>
+		bool operator==(const ArenaStdAllocator<U>& other) const { return m_Arena == other.m_Arena; }
+		template<typename U>
+		bool operator!=(const ArenaStdAllocator<U>& other) const { return m_Arena != other.m_Arena; }
+
+	private:
+		template<typename U> friend class ArenaStdAllocator;
+		LinearArena* m_Arena;
+	};
+}
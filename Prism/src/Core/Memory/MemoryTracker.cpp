@@ -0,0 +1,257 @@
+#include "MemoryTracker.h"
+
+#include "Util/Log/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace Prism {
+
+	static constexpr size_t c_TagCount = static_cast<size_t>(MemoryTag::Count);
+	// pending per-thread bytes / allocations before they are published
+	static constexpr int64_t c_FlushBytes = 64 * 1024;
+	static constexpr uint32_t c_FlushAllocations = 256;
+
+	static const char* const c_TagNames[c_TagCount] = { "Core", "ECS", "Resources", "Lua", "Vulkan-host", "Log" };
+
+	// precedes every block handed out by MemoryTracker::Allocate
+	struct alignas(16) AllocationHeader {
+		uint64_t size;
+		uint32_t offset; // from the start of the malloc block
+		MemoryTag tag;
+	};
+	static_assert(sizeof(AllocationHeader) == 16, "Allocation header must keep 16 byte alignment");
+
+	std::atomic<int64_t> g_Current[c_TagCount];
+	std::atomic<int64_t> g_HighWaterMark[c_TagCount];
+	std::atomic<uint64_t> g_Allocations[c_TagCount];
+	std::atomic<size_t> g_Budget[c_TagCount];
+	std::atomic<bool> g_OverBudget[c_TagCount];
+	std::atomic<bool> g_BudgetExceeded[c_TagCount]; // not reported yet
+
+	// trivially constructible, safe to touch from operator new at any time
+	struct ThreadCounters {
+		int64_t bytes[c_TagCount];
+		uint32_t allocations[c_TagCount];
+	};
+	thread_local ThreadCounters t_Counters;
+	thread_local MemoryTag t_Tag = MemoryTag::Core;
+
+	// publishes what's left in t_Counters when the thread exits
+	struct ThreadExitFlush {
+		~ThreadExitFlush() { MemoryTracker::Flush(); }
+	};
+	thread_local ThreadExitFlush t_ExitFlush;
+	thread_local bool t_ExitFlushRegistered = false; // trivial, unlike t_ExitFlush it's cheap to check on every count
+
+	static void publish(size_t tag)
+	{
+		const int64_t bytes = t_Counters.bytes[tag];
+		const uint32_t allocations = t_Counters.allocations[tag];
+		t_Counters.bytes[tag] = 0;
+		t_Counters.allocations[tag] = 0;
+
+		g_Allocations[tag].fetch_add(allocations, std::memory_order_relaxed);
+		const int64_t current = g_Current[tag].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+		int64_t highWaterMark = g_HighWaterMark[tag].load(std::memory_order_relaxed);
+		while (current > highWaterMark && !g_HighWaterMark[tag].compare_exchange_weak(highWaterMark, current));
+
+		const size_t budget = g_Budget[tag].load(std::memory_order_relaxed);
+		if (budget == 0 || current <= static_cast<int64_t>(std::min<size_t>(budget, INT64_MAX)))
+		{
+			g_OverBudget[tag].store(false, std::memory_order_relaxed);
+			return;
+		}
+
+		// once per overrun, logged by ReportBudgets (logging allocates and takes locks, not from within operator new)
+		if (!g_OverBudget[tag].exchange(true, std::memory_order_relaxed))
+			g_BudgetExceeded[tag].store(true, std::memory_order_release);
+	}
+
+	static inline void count(MemoryTag tag, int64_t bytes, uint32_t allocations)
+	{
+		if (!t_ExitFlushRegistered)
+		{
+			t_ExitFlushRegistered = true;
+			(void)&t_ExitFlush; // first use constructs it and registers its destructor
+		}
+
+		const size_t index = static_cast<size_t>(tag);
+		t_Counters.bytes[index] += bytes;
+		t_Counters.allocations[index] += allocations;
+		if (t_Counters.bytes[index] >= c_FlushBytes || t_Counters.bytes[index] <= -c_FlushBytes
+			|| t_Counters.allocations[index] >= c_FlushAllocations)
+			publish(index);
+	}
+
+	void* MemoryTracker::Allocate(MemoryTag tag, size_t size, size_t alignment)
+	{
+		alignment = std::max(alignment, alignof(std::max_align_t));
+		const size_t slack = alignment > alignof(std::max_align_t) ? alignment - 1 : 0;
+		uint8_t* block = static_cast<uint8_t*>(std::malloc(size + sizeof(AllocationHeader) + slack));
+		if (!block)
+			return nullptr;
+
+		const uintptr_t user = (reinterpret_cast<uintptr_t>(block) + sizeof(AllocationHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+		header->size = size;
+		header->offset = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(block));
+		header->tag = tag;
+
+		count(tag, static_cast<int64_t>(size), 1);
+		return reinterpret_cast<void*>(user);
+	}
+
+	void* MemoryTracker::Reallocate(void* memory, size_t size, size_t alignment)
+	{
+		if (!memory)
+			return Allocate(t_Tag, size, alignment);
+		if (size == 0)
+		{
+			Free(memory);
+			return nullptr;
+		}
+
+		const AllocationHeader* header = static_cast<AllocationHeader*>(memory) - 1;
+		void* result = Allocate(header->tag, size, alignment);
+		if (result)
+		{
+			std::memcpy(result, memory, std::min<size_t>(size, header->size));
+			Free(memory);
+		}
+		return result;
+	}
+
+	void MemoryTracker::Free(void* memory)
+	{
+		if (!memory)
+			return;
+
+		const AllocationHeader* header = static_cast<AllocationHeader*>(memory) - 1;
+		count(header->tag, -static_cast<int64_t>(header->size), 0);
+		std::free(static_cast<uint8_t*>(memory) - header->offset);
+	}
+
+	void MemoryTracker::TrackAllocation(MemoryTag tag, size_t size)
+	{
+		count(tag, static_cast<int64_t>(size), 1);
+	}
+
+	void MemoryTracker::TrackFree(MemoryTag tag, size_t size)
+	{
+		count(tag, -static_cast<int64_t>(size), 0);
+	}
+
+	void MemoryTracker::Flush()
+	{
+		for (size_t tag = 0; tag < c_TagCount; ++tag)
+			if (t_Counters.bytes[tag] != 0 || t_Counters.allocations[tag] != 0)
+				publish(tag);
+	}
+
+	void MemoryTracker::SetBudget(MemoryTag tag, size_t bytes)
+	{
+		g_Budget[static_cast<size_t>(tag)] = bytes;
+		g_OverBudget[static_cast<size_t>(tag)] = false;
+		g_BudgetExceeded[static_cast<size_t>(tag)] = false;
+	}
+
+	void MemoryTracker::ReportBudgets()
+	{
+		for (size_t tag = 0; tag < c_TagCount; ++tag)
+			if (g_BudgetExceeded[tag].exchange(false, std::memory_order_acquire))
+				PR_CORE_WARN("Memory budget of {0} exceeded: {1} KiB used, peak {2} KiB, budget {3} KiB", c_TagNames[tag],
+					g_Current[tag].load() / 1024, g_HighWaterMark[tag].load() / 1024, g_Budget[tag].load() / 1024);
+	}
+
+	MemoryTracker::TagStats MemoryTracker::GetStats(MemoryTag tag)
+	{
+		Flush();
+		const size_t index = static_cast<size_t>(tag);
+		TagStats stats;
+		stats.current = g_Current[index].load();
+		stats.highWaterMark = g_HighWaterMark[index].load();
+		stats.allocations = g_Allocations[index].load();
+		stats.budget = g_Budget[index].load();
+		return stats;
+	}
+
+	const char* MemoryTracker::GetTagName(MemoryTag tag)
+	{
+		return c_TagNames[static_cast<size_t>(tag)];
+	}
+
+	MemoryTag MemoryTracker::GetCurrentTag()
+	{
+		return t_Tag;
+	}
+
+	MemoryTag MemoryTracker::exchangeTag(MemoryTag tag)
+	{
+		MemoryTag previous = t_Tag;
+		t_Tag = tag;
+		return previous;
+	}
+
+	void MemoryTracker::LogReport()
+	{
+		Flush();
+		ReportBudgets();
+		PR_CORE_INFO("Memory usage:");
+		for (size_t tag = 0; tag < c_TagCount; ++tag)
+		{
+			const TagStats stats = GetStats(static_cast<MemoryTag>(tag));
+			if (stats.budget == 0)
+				PR_CORE_INFO("  {0:<12} {1:>10} KiB  peak {2:>10} KiB  {3:>10} allocations", c_TagNames[tag],
+					stats.current / 1024, stats.highWaterMark / 1024, stats.allocations);
+			else
+				PR_CORE_INFO("  {0:<12} {1:>10} KiB  peak {2:>10} KiB  {3:>10} allocations  budget {4} KiB", c_TagNames[tag],
+					stats.current / 1024, stats.highWaterMark / 1024, stats.allocations, stats.budget / 1024);
+		}
+	}
+}
+
+#ifndef PR_RELEASE
+
+// global heap routed through the tracker, attributed to the thread's current tag
+
+static void* trackedNew(size_t size, size_t alignment)
+{
+	void* memory = Prism::MemoryTracker::Allocate(Prism::t_Tag, size ? size : 1, alignment);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+}
+
+static void* trackedNewNoThrow(size_t size, size_t alignment) noexcept
+{
+	return Prism::MemoryTracker::Allocate(Prism::t_Tag, size ? size : 1, alignment);
+}
+
+void* operator new(size_t size) { return trackedNew(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return trackedNew(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return trackedNew(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return trackedNew(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedNewNoThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedNewNoThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedNewNoThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedNewNoThrow(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete[](void* memory) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete(void* memory, size_t) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, size_t) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { Prism::MemoryTracker::Free(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { Prism::MemoryTracker::Free(memory); }
+
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Prism {
+
+	enum class MemoryTag : uint8_t {
+		Core,
+		ECS,
+		Resources,
+		Lua,
+		VulkanHost,
+		Log,
+		Count
+	};
+
+	/**
+	 * Per-subsystem accounting of host memory
+	 *
+	 * Allocations are counted per thread and flushed to the global counters in
+	 * chunks (and when the thread exits), so the hot path is a thread-local
+	 * add. Usage, high-water mark and budget are tracked per tag; crossing a
+	 * budget is logged by the next ReportBudgets (once per frame).
+	 *
+	 * Unless PR_RELEASE is defined, the global operator new/delete are routed
+	 * through the tracker as well, attributed to the tag of the innermost
+	 * MemoryTagScope of the allocating thread (Core by default).
+	 */
+	class MemoryTracker {
+	public:
+		/** Counted allocation with a small header, free with Free() (size is looked up). */
+		static void* Allocate(MemoryTag tag, size_t size, size_t alignment = alignof(std::max_align_t));
+		static void* Reallocate(void* memory, size_t size, size_t alignment = alignof(std::max_align_t));
+		static void Free(void* memory);
+
+		/** Counting only, for allocators that manage their memory themselves. */
+		static void TrackAllocation(MemoryTag tag, size_t size);
+		static void TrackFree(MemoryTag tag, size_t size);
+
+		/** Publishes the pending counters of the calling thread. */
+		static void Flush();
+
+		// 0 removes the budget (see Application::EngineProperties)
+		static void SetBudget(MemoryTag tag, size_t bytes);
+		// warns about budgets exceeded since the last call, not allowed within the allocator
+		static void ReportBudgets();
+
+		struct TagStats {
+			int64_t current = 0, highWaterMark = 0;
+			uint64_t allocations = 0; // total number, not live
+			size_t budget = 0; // 0: unlimited
+		};
+		// pending counters of other threads are not included (at most a flush threshold each)
+		static TagStats GetStats(MemoryTag tag);
+		static const char* GetTagName(MemoryTag tag);
+		static MemoryTag GetCurrentTag();
+
+		static void LogReport();
+
+	private:
+		friend class MemoryTagScope;
+		static MemoryTag exchangeTag(MemoryTag tag);
+	};
+
+	/**
+	 * Attributes the global heap allocations of this thread to a tag while in scope
+	 */
+	class MemoryTagScope {
+	public:
+		MemoryTagScope(MemoryTag tag) : m_Previous(MemoryTracker::exchangeTag(tag)) {}
+		~MemoryTagScope() { MemoryTracker::exchangeTag(m_Previous); }
+
+		MemoryTagScope(const MemoryTagScope&) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+	private:
+		MemoryTag m_Previous;
+	};
+
+	/**
+	 * STL allocator adaptor counting into a fixed tag
+	 */
+	template<typename T, MemoryTag Tag>
+	class TrackedStdAllocator {
+	public:
+		using value_type = T;
+		template<typename U> struct rebind { using other = TrackedStdAllocator<U, Tag>; };
+
+		TrackedStdAllocator() = default;
+		template<typename U>
+		TrackedStdAllocator(const TrackedStdAllocator<U, Tag>&) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(MemoryTracker::Allocate(Tag, count * sizeof(T), alignof(T))); }
+		void deallocate(T* memory, size_t) { MemoryTracker::Free(memory); }
+
+		template<typename U>
+		bool operator==(const TrackedStdAllocator<U, Tag>&) const { return true; }
+		template<typename U>
+		bool operator!=(const TrackedStdAllocator<U, Tag>&) const { return false; }
+	};
+}
+
+#define PR_MEMORY_TAG_CONCAT_IMPL(a, b) a##b
+#define PR_MEMORY_TAG_CONCAT(a, b) PR_MEMORY_TAG_CONCAT_IMPL(a, b)
+#define PR_MEMORY_TAG(tag) ::Prism::MemoryTagScope PR_MEMORY_TAG_CONCAT(prMemoryTag, __LINE__)(::Prism::MemoryTag::tag)
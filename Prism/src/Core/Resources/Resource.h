@@ -1,41 +1,65 @@
 #pragma once
 
+#include "ResourceHandle.h"
 #include "ResourceManager.h"
-#include <memory>
+
+#include <functional>
 #include <string>
 
 namespace Prism {
-	using ResourceHandle = std::string;
 
+	/**
+	 * Counted reference to a resource of type T
+	 *
+	 * Holds one reference while valid: copies add one (a counter increment
+	 * on the slot, no lookup), destruction releases it. Converts to T* by an
+	 * index into the slot map of T, nullptr if the resource is gone.
+	 *
+	 * Resources created with CreateAsync resolve to the fallback of T until
+	 * they are ready.
+	 */
 	template<typename T>
 	class Resource {
 	public:
 		// implicit conversion to represented type
-		constexpr operator T* () const { return ResourceManager::Get<T>(handle); }
-		constexpr bool valid() const { return handle != ""; }
+		operator T* () const { return ResourceManager::GetRaw<T>(handle); }
+		bool valid() const { return handle.Valid(); }
+		const std::string& name() const { return ResourceManager::GetName<T>(handle); }
+		ResourceState state() const { return ResourceManager::GetState<T>(handle); }
+		bool ready() const { return state() == ResourceState::Ready; }
+		// called on the render thread once loaded (or failed), right away if not loading
+		void OnLoaded(std::function<void(bool loaded)> callback) const { ResourceManager::OnLoaded<T>(handle, std::move(callback)); }
 
 		template<typename... Args>
-		static Resource<T> Create(const ResourceHandle& name, Args&&... args) { return ResourceManager::Create<T>(name, args...); }
+		static Resource<T> Create(const std::string& name, Args&&... args) { return ResourceManager::Create<T>(name, args...); }
+		template<typename... Args>
+		static Resource<T> CreateAsync(const std::string& name, Args&&... args) { return ResourceManager::CreateAsync<T>(name, args...); }
 
-		Resource(const ResourceHandle& handle) : handle(handle) {};
-		ResourceHandle handle = "";
+		Resource() = default;
+		// adopts a reference that was already counted for this handle
+		explicit Resource(ResourceHandle handle) : handle(handle) {};
+		ResourceHandle handle{};
 
 	public:
-		Resource(const Resource& other) : handle(other.handle) { ResourceManager::Get<T>(handle); }
-		Resource& operator=(const Resource& rhs) { return std::move(Resource{ ResourceManager::Get<T>(rhs.handle) }); }
-		Resource(Resource&& other) noexcept : handle(std::move(other.handle)) { }
-		Resource& operator=(Resource&& rhs) noexcept { if (this != &rhs) handle = std::move(handle); return *this; };
+		Resource(const Resource& other) : handle(other.handle) { if (valid()) ResourceManager::NotifyCopy<T>(handle); }
+		Resource& operator=(const Resource& rhs)
+		{
+			if (rhs.valid()) ResourceManager::NotifyCopy<T>(rhs.handle);
+			if (valid()) ResourceManager::Remove<T>(handle);
+			handle = rhs.handle;
+			return *this;
+		}
+		Resource(Resource&& other) noexcept : handle(other.handle) { other.handle = {}; }
+		Resource& operator=(Resource&& rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				if (valid()) ResourceManager::Remove<T>(handle);
+				handle = rhs.handle;
+				rhs.handle = {};
+			}
+			return *this;
+		};
 		~Resource() { if (valid()) ResourceManager::Remove<T>(handle); };
 	};
-
-	// forward-declarations for unexposed classes
-	template<typename T> struct resource_t;
-
-	class VulkanPipeline;
-	struct pipeline_t {}; using Shader = VulkanPipeline;
-	template<> struct resource_t<VulkanPipeline> { typedef pipeline_t type; };
-
-	struct VulkanSwapchain;
-	struct swapchain_t {}; using Swapchain = VulkanSwapchain;
-	template<> struct resource_t<Swapchain> { typedef swapchain_t type; };
-}
\ No newline at end of file
+}
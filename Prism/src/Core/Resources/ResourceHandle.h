@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Prism {
+
+	/**
+	 * 32 bit generational handle into the ResourceMap of one resource type:
+	 * the slot index and the generation of the slot when the handle was
+	 * issued, so handles to a destroyed (and reused) slot are detected.
+	 */
+	struct ResourceHandle {
+		static constexpr uint32_t IndexBits = 20;
+		static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+		static constexpr uint32_t GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+		uint32_t value = 0; // 0 is invalid, generations start at 1
+
+		constexpr ResourceHandle() = default;
+		constexpr ResourceHandle(uint32_t index, uint32_t generation) : value((generation << IndexBits) | index) {}
+
+		constexpr uint32_t Index() const { return value & IndexMask; }
+		constexpr uint32_t Generation() const { return value >> IndexBits; }
+		constexpr bool Valid() const { return value != 0; }
+
+		constexpr bool operator==(ResourceHandle other) const { return value == other.value; }
+		constexpr bool operator!=(ResourceHandle other) const { return value != other.value; }
+	};
+
+	/** What a handle currently resolves to, see ResourceManager::CreateAsync */
+	enum class ResourceState : uint8_t {
+		Invalid, // invalid or stale handle
+		Loading, // the first load is still in flight
+		Ready,
+		Failed // nothing was loaded, the fallback is used
+	};
+
+	/**
+	 * What happens to resources nobody references anymore (see ResourceMap::EvictUnused)
+	 *
+	 * They are kept for at least graceFrames frames (the GPU may still use
+	 * them) and then destroyed, least recently released first, as long as
+	 * the unreferenced ones take up more than budget bytes. Until destroyed,
+	 * getting them by name again is free.
+	 *
+	 * Replaced (reloaded) resources are kept for graceFrames as well, so it
+	 * must cover the frames the renderer has in flight.
+	 */
+	struct ResourceCachePolicy {
+		uint32_t graceFrames = 3;
+		size_t budget = 0; // 0: destroy right after the grace period
+	};
+
+	// forward-declarations for unexposed classes
+	template<typename T> struct resource_t;
+
+	class VulkanPipeline;
+	struct pipeline_t {}; using Shader = VulkanPipeline;
+	template<> struct resource_t<VulkanPipeline> { typedef pipeline_t type; };
+
+	struct VulkanSwapchain;
+	struct swapchain_t {}; using Swapchain = VulkanSwapchain;
+	template<> struct resource_t<Swapchain> { typedef swapchain_t type; };
+}
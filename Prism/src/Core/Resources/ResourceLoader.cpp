@@ -0,0 +1,142 @@
+#include "ResourceLoader.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Log/Log.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace Prism {
+
+	std::mutex g_LoadMutex;
+	std::condition_variable g_LoadsDone;
+	std::deque<std::function<void()>> g_Loads; // waiting for a lane
+	uint32_t g_LoadLanes = 0; // lanes (tasks) currently running loads
+
+	std::mutex g_UploadMutex;
+	std::deque<std::function<void()>> g_Uploads;
+
+	std::mutex g_CallbackMutex;
+	std::map<std::pair<const void*, uint32_t>, std::vector<ResourceLoader::Callback>> g_Callbacks;
+
+	static uint32_t maxLoadLanes()
+	{
+		return std::max(1u, TaskSystem::GetWorkerCount() / 2);
+	}
+
+	// a lane keeps running queued loads, so loads never occupy more than maxLoadLanes() workers
+	static void runLane(std::function<void()> job)
+	{
+		PR_PROFILE_SCOPE("ResourceLoad");
+		while (true)
+		{
+			job();
+
+			std::lock_guard<std::mutex> lock(g_LoadMutex);
+			if (g_Loads.empty())
+			{
+				--g_LoadLanes;
+				g_LoadsDone.notify_all();
+				return;
+			}
+			job = std::move(g_Loads.front());
+			g_Loads.pop_front();
+		}
+	}
+
+	void ResourceLoader::Load(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_LoadMutex);
+			if (g_LoadLanes >= maxLoadLanes())
+			{
+				g_Loads.push_back(std::move(job));
+				return;
+			}
+			++g_LoadLanes;
+		}
+		TaskSystem::Submit(Task([job = std::move(job)]() { runLane(job); }));
+	}
+
+	void ResourceLoader::Upload(std::function<void()> upload)
+	{
+		std::lock_guard<std::mutex> lock(g_UploadMutex);
+		g_Uploads.push_back(std::move(upload));
+	}
+
+	size_t ResourceLoader::ProcessUploads(double budgetMs)
+	{
+		using clock = std::chrono::steady_clock;
+		const auto deadline = clock::now() + std::chrono::duration<double, std::milli>(budgetMs);
+
+		std::unique_lock<std::mutex> lock(g_UploadMutex);
+		while (!g_Uploads.empty())
+		{
+			auto upload = std::move(g_Uploads.front());
+			g_Uploads.pop_front();
+
+			// uploads may queue further uploads
+			lock.unlock();
+			upload();
+			lock.lock();
+
+			if (clock::now() >= deadline)
+				break;
+		}
+		return g_Uploads.size();
+	}
+
+	void ResourceLoader::OnLoaded(const void* map, ResourceHandle handle,
+		const std::function<ResourceState()>& state, Callback callback)
+	{
+		bool loaded;
+		{
+			std::lock_guard<std::mutex> lock(g_CallbackMutex);
+			const ResourceState current = state();
+			if (current == ResourceState::Loading)
+			{
+				g_Callbacks[{ map, handle.value }].push_back(std::move(callback));
+				return;
+			}
+			loaded = current == ResourceState::Ready;
+		}
+		callback(loaded);
+	}
+
+	void ResourceLoader::Complete(const void* map, ResourceHandle handle, bool loaded)
+	{
+		std::vector<Callback> callbacks;
+		{
+			std::lock_guard<std::mutex> lock(g_CallbackMutex);
+			auto it = g_Callbacks.find({ map, handle.value });
+			if (it == g_Callbacks.end())
+				return;
+			callbacks = std::move(it->second);
+			g_Callbacks.erase(it);
+		}
+		for (auto& callback : callbacks)
+			callback(loaded);
+	}
+
+	void ResourceLoader::Shutdown()
+	{
+		{
+			std::unique_lock<std::mutex> lock(g_LoadMutex);
+			if (!g_Loads.empty())
+				PR_RESOURCES_INFO("Dropping {0} queued resource loads", g_Loads.size());
+			g_Loads.clear();
+			g_LoadsDone.wait(lock, []() { return g_LoadLanes == 0; });
+		}
+
+		std::lock_guard<std::mutex> uploadLock(g_UploadMutex);
+		std::lock_guard<std::mutex> callbackLock(g_CallbackMutex);
+		g_Uploads.clear();
+		g_Callbacks.clear();
+	}
+}
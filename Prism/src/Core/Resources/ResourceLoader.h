@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ResourceHandle.h"
+
+#include <functional>
+
+namespace Prism {
+
+	/**
+	 * Background part of ResourceManager::CreateAsync
+	 *
+	 * Loads (file I/O, decoding) run as TaskSystem tasks, but at most half
+	 * the workers are busy with loads at any time, so frame work is never
+	 * starved. Whatever needs the render thread (GPU objects) is queued as
+	 * an upload and done in batches by ProcessUploads within a time budget.
+	 *
+	 * Completion callbacks are keyed by the resource map and the handle.
+	 */
+	class ResourceLoader {
+	public:
+		using Callback = std::function<void(bool loaded)>;
+
+		// runs job on a background lane
+		static void Load(std::function<void()> job);
+		// runs upload on the render thread (in ProcessUploads)
+		static void Upload(std::function<void()> upload);
+
+		/**
+		 * Runs queued uploads in order until the budget is spent (at least
+		 * one), the rest waits for the next frame. Render thread only.
+		 *
+		 * @returns the number of uploads left
+		 */
+		static size_t ProcessUploads(double budgetMs);
+
+		/**
+		 * Calls callback once the load of the resource is completed,
+		 * right away (on this thread) if it isn't loading anymore.
+		 *
+		 * state is checked under the same lock as Complete, which must be
+		 * called after the state changed.
+		 */
+		static void OnLoaded(const void* map, ResourceHandle handle, const std::function<ResourceState()>& state, Callback callback);
+		// calls the callbacks waiting for the load
+		static void Complete(const void* map, ResourceHandle handle, bool loaded);
+
+		// waits for running loads, drops queued loads and uploads
+		static void Shutdown();
+	};
+}
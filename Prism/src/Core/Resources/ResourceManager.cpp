@@ -1,4 +1,6 @@
 #include "ResourceManager.h"
+#include "Resource.h"
+#include "ResourceLoader.h"
 #include "ResourceMap.h"
 
 #include "Core/Graphics/Vulkan/VulkanPipeline.h"
@@ -7,39 +9,156 @@
 
 #include "Core/Graphics/Vulkan/VulkanSwapchain.h"
 
+#include "Core/Memory/Epoch.h"
+#include "Core/Memory/MemoryTracker.h"
+
+#include "Util/FileReader/FileReader.h"
+#include "Util/FileSystem/VirtualFileSystem.h"
+#include "Util/Profiler/Profiler.h"
+
 
 namespace Prism {
 
 	ResourceMap<uint32_t> g_UIntMap{};
 	ResourceMap<VulkanSwapchain> g_SwapchainMap{};
 	ResourceMap<VulkanPipeline> g_Pipelines{};
+	std::atomic<ResourceHandle> g_PipelineFallback{};
+	std::atomic<Renderer*> g_UploadRenderer = nullptr; // see SetRenderer
 
 	void ResourceManager::Init()
 	{
+		// pipelines are small and expensive to create, keep a few hundred around
+		g_Pipelines.SetCachePolicy({ 3, 256 * sizeof(VulkanPipeline) });
 	}
 
 	void ResourceManager::Shutdown()
 	{
+		// reads still running would start loads, loads still running would complete into cleared maps
+		FileReader::Wait();
+		ResourceLoader::Shutdown();
+
+		SetFallback(pipeline_t(), {});
+		SetRenderer(nullptr);
 		g_Pipelines.Clear();
+		// replaced resources still wait for readers, there are none left
+		Epoch::Collect();
 	}
 
 
 
-	ResourceHandle ResourceManager::Create(pipeline_t, const ResourceHandle& handle,
+	ResourceHandle ResourceManager::Create(pipeline_t, const std::string& name,
 		const std::string& filepath, Renderer* renderer)
 	{
+		PR_MEMORY_TAG(Resources);
 		auto binary = ShaderUtil::Load(filepath);
 		if (!binary.has_value())
 		{
-			PR_CORE_WARN("Unable to load shader, returning invalid resource handle.");
-			return "";
+			PR_RESOURCES_WARN("Unable to load shader, returning invalid resource handle.");
+			return {};
 		}
 
-		return g_Pipelines.CreateResource(handle, renderer-> m_Renderer->GetContext(), binary.value());
+		return g_Pipelines.CreateResource(name, renderer-> m_Renderer->GetContext(), binary.value());
+	}
+
+	ResourceHandle ResourceManager::CreateAsync(pipeline_t, const std::string& name,
+		const std::string& filepath, Renderer* renderer)
+	{
+		const ResourceHandle handle = g_Pipelines.CreatePending(name);
+		g_Pipelines.NotifyCopy(handle); // the load keeps the slot alive
+
+		auto complete = [handle](bool loaded)
+		{
+			if (!loaded) g_Pipelines.Fail(handle);
+			ResourceLoader::Complete(&g_Pipelines, handle, loaded);
+			g_Pipelines.RemoveResource(handle);
+		};
+
+		// reading the shader on the I/O threads, compiling it on a worker
+		VirtualFileSystem::OpenAsync(filepath, [=](std::optional<VirtualFile> file)
+			{
+				if (!file)
+				{
+					PR_RESOURCES_WARN("Unable to read shader {0}, keeping fallback.", filepath);
+					ResourceLoader::Upload([=]() { complete(false); }); // callbacks are always called on the render thread
+					return;
+				}
+
+				auto source = std::make_shared<VirtualFile>(std::move(*file));
+				ResourceLoader::Load([=]()
+					{
+						PR_MEMORY_TAG(Resources);
+						auto binary = std::make_shared<std::optional<ShaderBinary>>(ShaderUtil::Load(filepath, source->GetView()));
+						if (!binary->has_value())
+						{
+							PR_RESOURCES_WARN("Unable to load shader {0}, keeping fallback.", filepath);
+							ResourceLoader::Upload([=]() { complete(false); });
+							return;
+						}
+
+						// the pipeline on the render thread
+						ResourceLoader::Upload([=]()
+							{
+								PR_MEMORY_TAG(Resources);
+								Renderer* target = renderer ? renderer : g_UploadRenderer.load(std::memory_order_acquire);
+								if (!target)
+								{
+									PR_RESOURCES_WARN("No Renderer to create shader {0} with, keeping fallback.", filepath);
+									complete(false);
+									return;
+								}
+								g_Pipelines.Fulfill(handle, std::make_unique<VulkanPipeline>(target->m_Renderer->GetContext(), binary->value()));
+								complete(true);
+							});
+					});
+			});
+
+		return handle;
+	}
+
+	void ResourceManager::ProcessUploads(double budgetMs)
+	{
+		PR_PROFILE_SCOPE("ResourceUploads");
+		ResourceLoader::ProcessUploads(budgetMs);
+	}
+
+	void ResourceManager::SetRenderer(Renderer* renderer)
+	{
+		g_UploadRenderer.store(renderer, std::memory_order_release);
+	}
+
+	void ResourceManager::EvictUnused()
+	{
+		PR_PROFILE_SCOPE("ResourceEviction");
+		if (const uint32_t pipelines = g_Pipelines.EvictUnused())
+			PR_RESOURCES_TRACE("Destroyed {0} unused pipelines", pipelines);
+	}
+
+	ResourceHandle ResourceManager::Get(pipeline_t, const std::string& name) { return g_Pipelines.GetResource(name); }
+	VulkanPipeline* ResourceManager::GetRaw(pipeline_t, ResourceHandle handle)
+	{
+		VulkanPipeline* pipeline = g_Pipelines.GetRaw(handle);
+		if (pipeline || g_Pipelines.GetState(handle) == ResourceState::Invalid)
+			return pipeline;
+
+		// still loading or failed
+		const ResourceHandle fallback = g_PipelineFallback.load(std::memory_order_acquire);
+		return fallback.Valid() ? g_Pipelines.GetRaw(fallback) : nullptr;
+	}
+	const std::string& ResourceManager::GetName(pipeline_t, ResourceHandle handle) { return g_Pipelines.GetName(handle); }
+	ResourceState ResourceManager::GetState(pipeline_t, ResourceHandle handle) { return g_Pipelines.GetState(handle); }
+	void ResourceManager::OnLoaded(pipeline_t, ResourceHandle handle, std::function<void(bool)> callback)
+	{
+		ResourceLoader::OnLoaded(&g_Pipelines, handle, [handle]() { return g_Pipelines.GetState(handle); }, std::move(callback));
+	}
+	void ResourceManager::SetFallback(pipeline_t, ResourceHandle handle)
+	{
+		// the fallback is referenced by the manager
+		if (handle.Valid()) g_Pipelines.NotifyCopy(handle);
+		const ResourceHandle previous = g_PipelineFallback.exchange(handle, std::memory_order_acq_rel);
+		if (previous.Valid()) g_Pipelines.RemoveResource(previous);
 	}
-	ResourceHandle ResourceManager::Get(pipeline_t, const ResourceHandle& handle) { return g_Pipelines.GetResource(handle); }
-	VulkanPipeline* ResourceManager::GetRaw(pipeline_t, const ResourceHandle& handle) { return g_Pipelines.GetRaw(handle); }
-	void ResourceManager::NotifyCopy(pipeline_t, const ResourceHandle& handle) { g_Pipelines.NotifyCopy(handle); }
-	void ResourceManager::Remove(pipeline_t, const ResourceHandle& handle) { g_Pipelines.RemoveResource(handle); }
+	void ResourceManager::SetCachePolicy(pipeline_t, const ResourceCachePolicy& policy) { g_Pipelines.SetCachePolicy(policy); }
+	void ResourceManager::NotifyCopy(pipeline_t, ResourceHandle handle) { g_Pipelines.NotifyCopy(handle); }
+	void ResourceManager::Remove(pipeline_t, ResourceHandle handle) { g_Pipelines.RemoveResource(handle); }
 
 }
\ No newline at end of file
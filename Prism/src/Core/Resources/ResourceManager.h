@@ -1,10 +1,14 @@
 #pragma once
 
-#include "Resource.h"
+#include "ResourceHandle.h"
+
+#include <functional>
+#include <string>
 
 namespace Prism {
 
 	class Renderer;
+	template<typename T> class Resource;
 
 	/**
 	 * Static class abstracting individual resources into handles
@@ -12,6 +16,9 @@ namespace Prism {
 	 *
 	 * Used for loading and managing resource life-time
 	 * May also (in the future) reorder data according to access patterns
+	 *
+	 * Names are interned on creation, everything else addresses resources
+	 * by their ResourceHandle.
 	 */
 	class ResourceManager {
 	public:
@@ -20,41 +27,111 @@ namespace Prism {
 
 
 		template<typename T, typename... Args>
-		static Resource<T> Create(const ResourceHandle& name, Args&&... args)
+		static Resource<T> Create(const std::string& name, Args&&... args)
 		{
 			typedef typename resource_t<T>::type tag;
 			return Resource<T>{ Create(tag(), name, args...) };
 		}
 
+		/**
+		 * Like Create, but returns right away: files are read by the FileReader
+		 * (VirtualFileSystem::OpenAsync), decoding happens on the TaskSystem,
+		 * GPU objects are created on the render thread (ProcessUploads).
+		 * Until then the Resource resolves to the fallback of its type (if
+		 * set), see Resource::state() and Resource::OnLoaded.
+		 *
+		 * Loading an existing name keeps the current resource until the new
+		 * one is ready (and if loading fails), meanwhile its state is Loading.
+		 */
+		template<typename T, typename... Args>
+		static Resource<T> CreateAsync(const std::string& name, Args&&... args)
+		{
+			typedef typename resource_t<T>::type tag;
+			return Resource<T>{ CreateAsync(tag(), name, args...) };
+		}
+
+		// invalid Resource if there is none of that name
 		template<typename T>
-		static Resource<T> Get(const ResourceHandle& name)
+		static Resource<T> Get(const std::string& name)
 		{
 			typedef typename resource_t<T>::type tag;
 			return Resource<T>{ Get(tag(), name) };
 		}
 
+		/** Resource used in place of those of type T that are loading or failed to load */
 		template<typename T>
-		static void Remove(const ResourceHandle& name)
+		static void SetFallback(const Resource<T>& fallback)
 		{
 			typedef typename resource_t<T>::type tag;
-			Remove(tag(), name);
+			SetFallback(tag(), fallback.handle);
 		}
 
+		/** Grace period and memory budget of unreferenced resources of type T */
+		template<typename T>
+		static void SetCachePolicy(const ResourceCachePolicy& policy)
+		{
+			typedef typename resource_t<T>::type tag;
+			SetCachePolicy(tag(), policy);
+		}
+
+		/**
+		 * Creates the GPU objects of finished loads, as many as fit into the
+		 * budget (at least one). Called by the render thread once per frame.
+		 */
+		static void ProcessUploads(double budgetMs = 2.0);
+
+		/**
+		 * Renderer of the GPU objects of loads that weren't given one, so
+		 * loads can start before the Renderer exists (uploads wait for it).
+		 */
+		static void SetRenderer(Renderer* renderer);
+
+		/** Destroys unreferenced resources according to their cache policy, once per frame */
+		static void EvictUnused();
+
 	private:
 		template<typename T> friend class Resource;
 
 		template<typename T>
-		static void NotifyCopy(const ResourceHandle& name)
+		static void Remove(ResourceHandle handle)
+		{
+			typedef typename resource_t<T>::type tag;
+			Remove(tag(), handle);
+		}
+
+		template<typename T>
+		static void NotifyCopy(ResourceHandle handle)
+		{
+			typedef typename resource_t<T>::type tag;
+			NotifyCopy(tag(), handle);
+		}
+
+		template<typename T>
+		static T* GetRaw(ResourceHandle handle)
+		{
+			typedef typename resource_t<T>::type tag;
+			return GetRaw(tag(), handle);
+		}
+
+		template<typename T>
+		static const std::string& GetName(ResourceHandle handle)
+		{
+			typedef typename resource_t<T>::type tag;
+			return GetName(tag(), handle);
+		}
+
+		template<typename T>
+		static ResourceState GetState(ResourceHandle handle)
 		{
 			typedef typename resource_t<T>::type tag;
-			NotifyCopy(tag(), name);
+			return GetState(tag(), handle);
 		}
 
 		template<typename T>
-		static T* GetRaw(const ResourceHandle& name)
+		static void OnLoaded(ResourceHandle handle, std::function<void(bool loaded)> callback)
 		{
 			typedef typename resource_t<T>::type tag;
-			return GetRaw(tag(), name);
+			OnLoaded(tag(), handle, std::move(callback));
 		}
 
 	private:
@@ -63,21 +140,34 @@ namespace Prism {
 		 * For any resource managed, these methods must be implemented.
 		 * 
 		 * 
-		 * static ResourceHandle Create(uint32_t_t, const ResourceHandle& handle, ...);
-		 * static ResourceHandle Get(uint32_t_t, const ResourceHandle& handle);
-		 * static void NotifyCopy(uint32_t_t, const ResourceHandle& handle);
-		 * static void Remove(uint32_t_t, const ResourceHandle& handle);
+		 * static ResourceHandle Create(uint32_t_t, const std::string& name, ...);
+		 * static ResourceHandle CreateAsync(uint32_t_t, const std::string& name, ...);
+		 * static ResourceHandle Get(uint32_t_t, const std::string& name);
+		 * static T* GetRaw(uint32_t_t, ResourceHandle handle);
+		 * static const std::string& GetName(uint32_t_t, ResourceHandle handle);
+		 * static ResourceState GetState(uint32_t_t, ResourceHandle handle);
+		 * static void OnLoaded(uint32_t_t, ResourceHandle handle, std::function<void(bool)> callback);
+		 * static void SetFallback(uint32_t_t, ResourceHandle handle);
+		 * static void SetCachePolicy(uint32_t_t, const ResourceCachePolicy& policy);
+		 * static void NotifyCopy(uint32_t_t, ResourceHandle handle);
+		 * static void Remove(uint32_t_t, ResourceHandle handle);
 		 */
 
-		static ResourceHandle Create(pipeline_t, const ResourceHandle& handle, const std::string& filepath, Renderer*);
-		static ResourceHandle Get(pipeline_t, const ResourceHandle& handle);
-		static VulkanPipeline* GetRaw(pipeline_t, const ResourceHandle& handle);
-		static void NotifyCopy(pipeline_t, const ResourceHandle& handle);
-		static void Remove(pipeline_t, const ResourceHandle& handle);
+		static ResourceHandle Create(pipeline_t, const std::string& name, const std::string& filepath, Renderer*);
+		static ResourceHandle CreateAsync(pipeline_t, const std::string& name, const std::string& filepath, Renderer* = nullptr);
+		static ResourceHandle Get(pipeline_t, const std::string& name);
+		static VulkanPipeline* GetRaw(pipeline_t, ResourceHandle handle);
+		static const std::string& GetName(pipeline_t, ResourceHandle handle);
+		static ResourceState GetState(pipeline_t, ResourceHandle handle);
+		static void OnLoaded(pipeline_t, ResourceHandle handle, std::function<void(bool)> callback);
+		static void SetFallback(pipeline_t, ResourceHandle handle);
+		static void SetCachePolicy(pipeline_t, const ResourceCachePolicy& policy);
+		static void NotifyCopy(pipeline_t, ResourceHandle handle);
+		static void Remove(pipeline_t, ResourceHandle handle);
 
-		//static ResourceHandle Create(swapchain_t, const ResourceHandle& handle);
-		//static ResourceHandle Get(swapchain_t, const ResourceHandle& handle);
-		//static void NotifyCopy(swapchain_t, const ResourceHandle& handle);
-		//static void Remove(swapchain_t, const ResourceHandle& handle);
+		//static ResourceHandle Create(swapchain_t, const std::string& name);
+		//static ResourceHandle Get(swapchain_t, const std::string& name);
+		//static void NotifyCopy(swapchain_t, ResourceHandle handle);
+		//static void Remove(swapchain_t, ResourceHandle handle);
 	};
 }
\ No newline at end of file
@@ -1,118 +1,575 @@
 #pragma once
 
-#include "Resource.h"
+#include "ResourceHandle.h"
 
+#include "Core/Memory/Epoch.h"
 #include "Util/Log/Log.h"
 
-#include <unordered_map>
-#include <memory>
+#include <algorithm>
 #include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace Prism {
 
+	/** Bytes a resource accounts for in its cache budget, specialize for resources owning more than themselves */
+	template<typename R>
+	struct ResourceSize {
+		static size_t Get(const R& resource) { return sizeof(R); }
+	};
+
 	/**
+	 * Slot map of the resources of one type, safe to use from any thread
+	 *
+	 * Resources live in fixed blocks of slots, a handle is the slot index
+	 * plus the slot's generation. Blocks are never moved or freed (the block
+	 * directory has room for every index a handle can hold), so handle
+	 * lookups are lock-free: two atomic loads and a generation check.
+	 *
+	 * Names are interned in an open-addressing table that is read lock-free
+	 * under an Epoch::Guard; growing it publishes a new table and retires
+	 * the old one. Writers (create, destroy) are serialized by a mutex.
+	 *
+	 * A resource pointer is valid while a reference is held. Replaced and
+	 * destroyed resources are kept for the grace period of the cache policy
+	 * (the GPU may still use them, see EvictUnused) and then retired, so
+	 * readers inside a guard are safe as well.
+	 *
+	 * Slots can be created pending (CreatePending) and get their resource
+	 * later (Fulfill), until then they resolve to nullptr. Reloading an
+	 * existing resource keeps the current one until then.
+	 *
+	 * Releasing the last reference moves a resource into a LRU cache of
+	 * unreferenced ones, EvictUnused destroys them per ResourceCachePolicy.
 	 */
 	template<typename R>
 	class ResourceMap {
 	public:
+		ResourceMap() : m_Blocks(new std::atomic<Slot*>[c_MaxBlocks]()) {}
+		~ResourceMap() { Clear(); }
 
 		/**
 		 * Constructs a resource with the given parameters
-		 * and stores a shared_ptr in the ResourceMap
+		 * and stores it in a free slot
 		 *
-		 * @returns the handle and a shared_ptr of the created resource
+		 * An existing resource of the same name is replaced in place,
+		 * its handles stay valid and see the new resource.
+		 *
+		 * @returns the handle of the created resource, holding one reference
 		 */
 		template<typename... Args>
-		ResourceHandle CreateResource(const ResourceHandle& handle, Args&&... args)
+		ResourceHandle CreateResource(const std::string& name, Args&&... args)
 		{
-			uint32_t initialRefCount = 0;
+			auto resource = std::make_unique<R>(std::forward<Args>(args)...);
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
 
-			// if resource already exists
-			auto itr = m_Map.find(handle);
-			if (itr != m_Map.end() && itr->second.second.load() > 0)
-			{ // replacing unreferenced existing resource is considered safe here
-				PR_CORE_CRITICAL("Unsafe replacement of existing resource {0}!", handle);
-				initialRefCount = itr->second.second.load();
+			const ResourceHandle existing = findName(name);
+			if (existing.Valid())
+			{
+				Slot& s = *slot(existing);
+				PR_RESOURCES_TRACE("Replacing resource {0} in place ({1} references)", name, countOf(s.state.load(std::memory_order_relaxed)));
+				if (R* previous = s.resource.exchange(resource.release(), std::memory_order_acq_rel))
+					retire(previous);
+				s.loadState.store(ResourceState::Ready, std::memory_order_release);
+				s.state.fetch_add(1, std::memory_order_relaxed);
+				return existing;
 			}
 
-			// create resource
-			m_Map.emplace(handle, std::pair{
-				std::make_unique<R>(std::forward<Args>(args)...),
-				initialRefCount + 1
-				});
+			return createSlot(name, resource.release(), ResourceState::Ready);
+		}
 
-			return handle;
+		/**
+		 * Creates a slot without a resource (it resolves to nullptr) to be
+		 * fulfilled later. An existing resource of the same name is kept
+		 * until then, the returned handle is simply another reference to it,
+		 * but its state is Loading again.
+		 *
+		 * @returns the handle of the slot, holding one reference
+		 */
+		ResourceHandle CreatePending(const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			const ResourceHandle existing = findName(name);
+			if (existing.Valid())
+			{
+				Slot& s = *slot(existing);
+				s.loadState.store(ResourceState::Loading, std::memory_order_release);
+				s.state.fetch_add(1, std::memory_order_relaxed);
+				return existing;
+			}
+
+			return createSlot(name, nullptr, ResourceState::Loading);
 		}
 
-		ResourceHandle GetResource(const ResourceHandle& handle)
+		/** Sets the resource of a (pending) slot, replacing the current one */
+		void Fulfill(ResourceHandle handle, std::unique_ptr<R> resource)
 		{
-			// check if resource available
-			auto itr = m_Map.find(handle);
-			if (itr == m_Map.end())
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			if (Slot* s = slot(handle))
+			{
+				if (R* previous = s->resource.exchange(resource.release(), std::memory_order_acq_rel))
+					retire(previous);
+				s->loadState.store(ResourceState::Ready, std::memory_order_release);
+			}
+		}
+
+		/** Marks the load of a slot failed, a reload is Ready again with the resource it already has */
+		void Fail(ResourceHandle handle)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			if (Slot* s = slot(handle))
+			{
+				ResourceState loading = ResourceState::Loading;
+				const bool kept = s->resource.load(std::memory_order_relaxed) != nullptr;
+				s->loadState.compare_exchange_strong(loading, kept ? ResourceState::Ready : ResourceState::Failed);
+			}
+		}
+
+		ResourceState GetState(ResourceHandle handle) const
+		{
+			const Slot* s = slot(handle);
+			return s ? s->loadState.load(std::memory_order_acquire) : ResourceState::Invalid;
+		}
+
+		/** @returns the handle of the named resource with one more reference, invalid if not found */
+		ResourceHandle GetResource(const std::string& name)
+		{
+			Epoch::Guard guard;
+			const ResourceHandle handle = findName(name);
+			Slot* s = slot(handle);
+			if (!s || !tryAcquire(*s, handle.Generation()))
 			{
-				PR_CORE_WARN("Resource {0} not found, invalid resource returned", handle);
-				return { "" };
+				PR_RESOURCES_WARN_LIMITED("Resource {0} not found, invalid resource returned", name);
+				return {};
 			}
-			itr->second.second++; // increment refCount
 			return handle;
 		}
 
-		R* GetRaw(const ResourceHandle& handle)
+		R* GetRaw(ResourceHandle handle) const
 		{
-			auto itr = m_Map.find(handle);
-			if (itr == m_Map.end())
+			const Slot* s = slot(handle);
+			if (!s)
 			{
-				PR_CORE_WARN("Resource {0} not found, nullptr returned", handle);
+				PR_RESOURCES_WARN_LIMITED("Resource #{0}.{1} not found, nullptr returned", handle.Index(), handle.Generation());
 				return nullptr;
 			}
 
-			return itr->second.first.get();
+			return s->resource.load(std::memory_order_acquire); // nullptr while pending
 		}
 
-		void NotifyCopy(const ResourceHandle& handle)
+		// the name is written before the handle is handed out, a reference keeps it alive
+		const std::string& GetName(ResourceHandle handle) const
 		{
-			auto itr = m_Map.find(handle);
-			if (itr != m_Map.end())
-				itr->second.second++; // increment refCount
+			static const std::string none;
+			const Slot* s = slot(handle);
+			return s ? s->name : none;
+		}
+
+		void NotifyCopy(ResourceHandle handle)
+		{
+			if (Slot* s = slot(handle))
+				s->state.fetch_add(1, std::memory_order_relaxed); // increment refCount
 			else
-				PR_CORE_WARN("Resource {0} not found, notifyCopy is pointless", handle);
+				PR_RESOURCES_WARN_LIMITED("Resource #{0}.{1} not found, notifyCopy is pointless", handle.Index(), handle.Generation());
 		}
 
 		/**
-		 * Removes a resource from the map.
-		 *
-		 * All existing shared_ptrs to the resource stay valid,
-		 * but ResourceMap no longer keeps the resource alive.
+		 * Releases one reference of a resource.
 		 *
-		 * @returns if this call destroyed the resource
+		 * @returns if this call released the last reference
 		 */
-		bool RemoveResource(const ResourceHandle& handle)
+		bool RemoveResource(ResourceHandle handle)
 		{
 			// check if resource available
-			auto itr = m_Map.find(handle);
-			if (itr == m_Map.end())
+			Slot* s = slot(handle);
+			if (!s)
 			{
-				PR_CORE_ASSERT(false, "Trying to remove non-existent resource {0}", handle);
+				PR_CORE_ASSERT(false, "Trying to remove non-existent resource #{0}.{1}", handle.Index(), handle.Generation());
 				return false;
 			}
-			else if (itr->second.second.load() < 1)
+
+			const uint32_t count = countOf(s->state.fetch_sub(1, std::memory_order_acq_rel));
+			if (count == 0 || count == c_Destroyed)
 			{
-				PR_CORE_ASSERT(false, "Resource {0} should have no references");
+				PR_CORE_ASSERT(false, "Resource {0} should have no references", s->name);
+				s->state.fetch_add(1, std::memory_order_relaxed);
 				return false;
 			}
 
-			itr->second.second--; // decrement refCount
-			if (itr->second.second.load() == 1)
-				PR_CORE_WARN("No resource destruction implemented");
-			return false;
+			if (count == 1)
+				cacheUnused(handle, *s);
+			return count == 1;
+		}
+
+		/**
+		 * Destroys an unreferenced resource: the handle becomes stale, the name
+		 * is free again and the slot is reused with the next generation.
+		 *
+		 * @returns false if the resource is (again) referenced
+		 */
+		bool DestroyResource(ResourceHandle handle) { return destroy(handle, c_NotReleased); }
+
+		void SetCachePolicy(const ResourceCachePolicy& policy)
+		{
+			std::lock_guard<std::mutex> lock(m_CacheMutex);
+			m_CachePolicy = policy;
+		}
+
+		/**
+		 * Advances the frame and destroys unreferenced resources past their
+		 * grace period, least recently released first, until the cache
+		 * fits its budget. Replaced resources are retired once they are past
+		 * the grace period as well. Called once per frame.
+		 *
+		 * @returns the number of destroyed resources
+		 */
+		uint32_t EvictUnused()
+		{
+			std::vector<CacheEntry> evicted;
+			{
+				std::lock_guard<std::mutex> lock(m_CacheMutex);
+				++m_Frame;
+				while (!m_Unused.empty() && m_UnusedSize > m_CachePolicy.budget
+					&& m_Frame - m_Unused.front().frame > m_CachePolicy.graceFrames)
+				{
+					const CacheEntry& oldest = m_Unused.front();
+					if (slot(oldest.handle)) // stale if destroyed meanwhile
+						evicted.push_back(oldest);
+					m_UnusedSize -= oldest.size;
+					m_UnusedIndex.erase(oldest.handle.value);
+					m_Unused.pop_front();
+				}
+			}
+
+			// the write lock is taken after the cache lock is released (DestroyResource locks them the other way)
+			uint32_t destroyed = 0;
+			for (const CacheEntry& entry : evicted)
+				if (destroy(entry.handle, entry.frame)) // referenced again otherwise, cached again when released
+					++destroyed;
+
+			// the GPU is done with these, readers on the CPU may not be
+			std::lock_guard<std::mutex> lock(m_CacheMutex);
+			auto expired = std::partition(m_Retired.begin(), m_Retired.end(),
+				[this](const RetiredEntry& r) { return m_Frame - r.frame <= m_CachePolicy.graceFrames; });
+			for (auto it = expired; it != m_Retired.end(); ++it)
+				Epoch::Retire(it->resource);
+			m_Retired.erase(expired, m_Retired.end());
+			return destroyed;
+		}
+
+		// bytes of the cached unreferenced resources
+		size_t GetUnusedSize()
+		{
+			std::lock_guard<std::mutex> lock(m_CacheMutex);
+			return m_UnusedSize;
 		}
 
 		void Clear()
 		{
-			m_Map.clear();
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			const uint32_t count = m_SlotCount.load(std::memory_order_relaxed);
+			for (uint32_t block = 0; block * c_BlockSize < count; ++block)
+				delete[] m_Blocks[block].exchange(nullptr);
+			m_SlotCount.store(0, std::memory_order_release);
+			m_Free.clear();
+
+			{
+				std::lock_guard<std::mutex> cacheLock(m_CacheMutex);
+				m_Unused.clear();
+				m_UnusedIndex.clear();
+				m_UnusedSize = 0;
+				for (const RetiredEntry& r : m_Retired)
+					delete r.resource;
+				m_Retired.clear();
+			}
+
+			if (NameTable* table = m_Names.exchange(nullptr))
+			{
+				for (uint32_t i = 0; i <= table->mask; ++i)
+				{
+					NameEntry* entry = table->entries[i].load(std::memory_order_relaxed);
+					if (entry && entry != &s_Tombstone) delete entry;
+				}
+				delete table;
+			}
+			m_NameCount = m_NameUsed = 0;
+		}
+
+	private:
+		struct Slot {
+			std::atomic<R*> resource = nullptr;
+			std::atomic<uint64_t> state = stateOf(1, 0); // generation (high) and refCount (low), changed together
+			std::atomic<ResourceState> loadState = ResourceState::Ready;
+			std::string name;
+
+			~Slot() { delete resource.load(); }
+		};
+
+		struct NameEntry {
+			std::string name;
+			size_t hash;
+			ResourceHandle handle;
+		};
+
+		struct CacheEntry {
+			ResourceHandle handle;
+			uint64_t frame; // when the last reference was released
+			size_t size;
+		};
+
+		struct RetiredEntry {
+			R* resource; // replaced or destroyed
+			uint64_t frame; // since when it isn't used anymore
+		};
+
+		struct NameTable {
+			explicit NameTable(uint32_t capacity) : mask(capacity - 1), entries(new std::atomic<NameEntry*>[capacity]()) {}
+			uint32_t mask;
+			std::unique_ptr<std::atomic<NameEntry*>[]> entries;
+		};
+
+		static constexpr uint32_t c_BlockSize = 256;
+		static constexpr uint32_t c_MaxBlocks = (ResourceHandle::IndexMask + 1) / c_BlockSize;
+		static constexpr uint32_t c_Destroyed = 0x80000000u; // refCount of a destroyed slot
+		static constexpr uint64_t c_NotReleased = ~0ull; // frame of resources destroyed without being cached
+		static inline NameEntry s_Tombstone{};
+
+		static constexpr uint64_t stateOf(uint32_t generation, uint32_t count) { return (static_cast<uint64_t>(generation) << 32) | count; }
+		static constexpr uint32_t generationOf(uint64_t state) { return static_cast<uint32_t>(state >> 32); }
+		static constexpr uint32_t countOf(uint64_t state) { return static_cast<uint32_t>(state); }
+
+		static uint32_t nextGeneration(uint32_t generation)
+		{
+			return (generation & ResourceHandle::GenerationMask) == ResourceHandle::GenerationMask ? 1 : generation + 1;
+		}
+
+		Slot& slotAt(uint32_t index) const
+		{
+			return m_Blocks[index / c_BlockSize].load(std::memory_order_acquire)[index % c_BlockSize];
+		}
+
+		// nullptr if the handle is invalid or stale
+		Slot* slot(ResourceHandle handle) const
+		{
+			const uint32_t index = handle.Index();
+			if (!handle.Valid() || index >= m_SlotCount.load(std::memory_order_acquire))
+				return nullptr;
+
+			Slot& s = slotAt(index);
+			return generationOf(s.state.load(std::memory_order_acquire)) == handle.Generation() ? &s : nullptr;
+		}
+
+		// increments refCount unless the slot was destroyed (or already reused)
+		static bool tryAcquire(Slot& s, uint32_t generation)
+		{
+			uint64_t state = s.state.load(std::memory_order_relaxed);
+			while (generationOf(state) == generation && countOf(state) < c_Destroyed)
+				if (s.state.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel))
+					return true;
+			return false;
+		}
+
+		// moves the resource to the back of the LRU of unused resources
+		void cacheUnused(ResourceHandle handle, const Slot& s)
+		{
+			size_t size = 0;
+			{
+				// it may be referenced, destroyed and retired again by now
+				Epoch::Guard guard;
+				if (const R* resource = s.resource.load(std::memory_order_acquire))
+					size = ResourceSize<R>::Get(*resource);
+			}
+
+			std::lock_guard<std::mutex> lock(m_CacheMutex);
+			// destroying takes the cache lock after advancing the generation: it's either
+			// seen here or removes the entry afterwards. Referenced again, it's cached when released.
+			const uint64_t state = s.state.load(std::memory_order_acquire);
+			if (generationOf(state) != handle.Generation() || countOf(state) != 0)
+				return;
+
+			auto cached = m_UnusedIndex.find(handle.value);
+			if (cached != m_UnusedIndex.end())
+			{
+				m_UnusedSize -= cached->second->size;
+				m_Unused.erase(cached->second);
+			}
+			m_Unused.push_back({ handle, m_Frame, size });
+			m_UnusedIndex[handle.value] = std::prev(m_Unused.end());
+			m_UnusedSize += size;
+		}
+
+		// see DestroyResource, released is the frame the last reference was released in (if not cached anymore)
+		bool destroy(ResourceHandle handle, uint64_t released)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			Slot* s = slot(handle);
+			uint64_t unreferenced = stateOf(handle.Generation(), 0);
+			// advances the generation as well, a concurrent GetResource(name) can't resurrect it after this
+			if (!s || !s->state.compare_exchange_strong(unreferenced, stateOf(nextGeneration(handle.Generation()), c_Destroyed), std::memory_order_acq_rel))
+				return false;
+
+			eraseName(s->name, handle);
+			R* resource = s->resource.exchange(nullptr, std::memory_order_acq_rel); // nullptr if still pending
+			m_Free.push_back(handle.Index());
+
+			std::lock_guard<std::mutex> cacheLock(m_CacheMutex);
+			uint64_t frame = released;
+			auto cached = m_UnusedIndex.find(handle.value);
+			if (cached != m_UnusedIndex.end())
+			{
+				frame = cached->second->frame; // the grace period started back then
+				m_UnusedSize -= cached->second->size;
+				m_Unused.erase(cached->second);
+				m_UnusedIndex.erase(cached);
+			}
+			if (resource)
+				m_Retired.push_back({ resource, frame == c_NotReleased ? m_Frame : frame });
+			return true;
+		}
+
+		// keeps a replaced resource for the grace period, m_WriteMutex must be held
+		void retire(R* resource)
+		{
+			std::lock_guard<std::mutex> lock(m_CacheMutex);
+			m_Retired.push_back({ resource, m_Frame });
+		}
+
+		// m_WriteMutex must be held, the name must not be in use
+		ResourceHandle createSlot(const std::string& name, R* resource, ResourceState loadState)
+		{
+			const uint32_t index = allocateSlot();
+			Slot& s = slotAt(index);
+			const uint32_t generation = generationOf(s.state.load(std::memory_order_relaxed));
+			s.name = name;
+			s.resource.store(resource, std::memory_order_relaxed);
+			s.loadState.store(loadState, std::memory_order_relaxed);
+			s.state.store(stateOf(generation, 1), std::memory_order_release);
+
+			const ResourceHandle handle{ index, generation };
+			insertName(new NameEntry{ name, std::hash<std::string>()(name), handle });
+			return handle;
+		}
+
+		// m_WriteMutex must be held
+		uint32_t allocateSlot()
+		{
+			if (!m_Free.empty())
+			{
+				const uint32_t index = m_Free.back();
+				m_Free.pop_back();
+				return index;
+			}
+
+			const uint32_t index = m_SlotCount.load(std::memory_order_relaxed);
+			PR_CORE_ASSERT(index <= ResourceHandle::IndexMask, "Too many resources of one type!");
+			if (index % c_BlockSize == 0)
+				m_Blocks[index / c_BlockSize].store(new Slot[c_BlockSize], std::memory_order_release);
+			m_SlotCount.store(index + 1, std::memory_order_release);
+			return index;
+		}
+
+		// lock-free, callers hold an Epoch::Guard or m_WriteMutex
+		ResourceHandle findName(const std::string& name) const
+		{
+			const NameTable* table = m_Names.load(std::memory_order_acquire);
+			if (!table)
+				return {};
+
+			const size_t hash = std::hash<std::string>()(name);
+			for (uint32_t i = static_cast<uint32_t>(hash) & table->mask;; i = (i + 1) & table->mask)
+			{
+				const NameEntry* entry = table->entries[i].load(std::memory_order_acquire);
+				if (!entry)
+					return {};
+				if (entry != &s_Tombstone && entry->hash == hash && entry->name == name)
+					return entry->handle;
+			}
+		}
+
+		// m_WriteMutex must be held, the name must not be in the table
+		void insertName(NameEntry* entry)
+		{
+			NameTable* table = m_Names.load(std::memory_order_relaxed);
+			const uint32_t capacity = table ? table->mask + 1 : 0;
+			if ((m_NameUsed + 1) * 2 > capacity)
+			{
+				// grow (or just drop the tombstones), readers keep using the old table until it is retired
+				uint32_t newCapacity = 64;
+				while ((m_NameCount + 1) * 4 > newCapacity) newCapacity *= 2;
+				NameTable* grown = new NameTable(newCapacity);
+				if (table)
+					for (uint32_t i = 0; i < capacity; ++i)
+					{
+						NameEntry* e = table->entries[i].load(std::memory_order_relaxed);
+						if (e && e != &s_Tombstone) place(*grown, e);
+					}
+				m_Names.store(grown, std::memory_order_release);
+				if (table) Epoch::Retire(table);
+				m_NameUsed = m_NameCount;
+				table = grown;
+			}
+
+			if (place(*table, entry)) ++m_NameUsed;
+			++m_NameCount;
+		}
+
+		// @returns if a free (not a tombstone) entry was used
+		static bool place(NameTable& table, NameEntry* entry)
+		{
+			for (uint32_t i = static_cast<uint32_t>(entry->hash) & table.mask;; i = (i + 1) & table.mask)
+			{
+				NameEntry* current = table.entries[i].load(std::memory_order_relaxed);
+				if (!current || current == &s_Tombstone)
+				{
+					table.entries[i].store(entry, std::memory_order_release);
+					return !current;
+				}
+			}
+		}
+
+		// m_WriteMutex must be held
+		void eraseName(const std::string& name, ResourceHandle handle)
+		{
+			NameTable* table = m_Names.load(std::memory_order_relaxed);
+			const size_t hash = std::hash<std::string>()(name);
+			for (uint32_t i = static_cast<uint32_t>(hash) & table->mask;; i = (i + 1) & table->mask)
+			{
+				NameEntry* entry = table->entries[i].load(std::memory_order_relaxed);
+				if (!entry)
+					return;
+				if (entry != &s_Tombstone && entry->handle == handle)
+				{
+					table->entries[i].store(&s_Tombstone, std::memory_order_release);
+					Epoch::Retire(entry);
+					--m_NameCount;
+					return;
+				}
+			}
 		}
 
 	private:
-		std::unordered_map<ResourceHandle, std::pair<std::unique_ptr<R>, std::atomic<uint32_t>>> m_Map{};
+		std::unique_ptr<std::atomic<Slot*>[]> m_Blocks; // c_MaxBlocks, filled up front to back
+		std::atomic<uint32_t> m_SlotCount = 0;
+		std::vector<uint32_t> m_Free; // slots of destroyed resources, generation already advanced
+
+		std::atomic<NameTable*> m_Names = nullptr;
+		uint32_t m_NameCount = 0; // live names
+		uint32_t m_NameUsed = 0; // live names and tombstones
+
+		std::mutex m_WriteMutex;
+
+		// unreferenced resources, least recently released first
+		std::list<CacheEntry> m_Unused;
+		std::unordered_map<uint32_t, typename std::list<CacheEntry>::iterator> m_UnusedIndex;
+		size_t m_UnusedSize = 0;
+		std::vector<RetiredEntry> m_Retired; // waiting for their grace period, then retired
+		uint64_t m_Frame = 0;
+		ResourceCachePolicy m_CachePolicy;
+		std::mutex m_CacheMutex; // taken after m_WriteMutex
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,137 @@
+#include "StartupGraph.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Core/Time/FrameLimiter.h"
+
+#include "Util/Log/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace Prism {
+
+	struct StartupGraph::State {
+		double start;
+		std::unique_ptr<std::atomic<uint32_t>[]> remaining; // unfinished dependencies per stage
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<StageID> mainQueue; // ready stages bound to the main thread
+		uint32_t finished = 0;
+	};
+
+	StartupGraph::StageID StartupGraph::AddStage(const std::string& name, std::function<void()> function,
+		std::initializer_list<StageID> dependencies, bool mainThread)
+	{
+		const StageID id = static_cast<StageID>(m_Stages.size());
+		for (StageID dependency : dependencies)
+		{
+			PR_CORE_ASSERT(dependency < id, "Startup stage dependency must be added before the stage!");
+			m_Stages[dependency].dependents.push_back(id);
+		}
+
+		m_Stages.push_back({ name, std::move(function), dependencies, {}, mainThread });
+		return id;
+	}
+
+	void StartupGraph::Run()
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Stages.size());
+		auto state = std::make_shared<State>();
+		state->start = FrameLimiter::Now();
+		state->remaining = std::make_unique<std::atomic<uint32_t>[]>(count);
+		for (StageID id = 0; id < count; ++id)
+			state->remaining[id] = static_cast<uint32_t>(m_Stages[id].dependencies.size());
+
+		for (StageID id = 0; id < count; ++id)
+			if (m_Stages[id].dependencies.empty())
+				schedule(state, id);
+
+		// the calling thread works off the main thread stages until everything is done
+		std::unique_lock<std::mutex> lock(state->mutex);
+		while (state->finished < count)
+		{
+			if (state->mainQueue.empty())
+			{
+				state->condition.wait(lock);
+				continue;
+			}
+
+			StageID id = state->mainQueue.front();
+			state->mainQueue.pop_front();
+			lock.unlock();
+			execute(state, id);
+			lock.lock();
+		}
+
+		m_TotalTime = FrameLimiter::Now() - state->start;
+	}
+
+	void StartupGraph::schedule(const std::shared_ptr<State>& state, StageID id)
+	{
+		if (m_Stages[id].mainThread)
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			state->mainQueue.push_back(id);
+			state->condition.notify_all();
+		}
+		else
+			Task([this, state, id]() { execute(state, id); }).Submit();
+	}
+
+	void StartupGraph::execute(const std::shared_ptr<State>& state, StageID id)
+	{
+		Stage& stage = m_Stages[id];
+		const double start = FrameLimiter::Now();
+		stage.function();
+		stage.start = start - state->start;
+		stage.duration = FrameLimiter::Now() - start;
+
+		for (StageID dependent : stage.dependents)
+			if (state->remaining[dependent].fetch_sub(1) == 1)
+				schedule(state, dependent);
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->finished++;
+		state->condition.notify_all();
+	}
+
+	void StartupGraph::LogReport() const
+	{
+		// longest chain of dependent stages, ids are topologically sorted
+		std::vector<double> finish(m_Stages.size(), 0.0);
+		std::vector<StageID> previous(m_Stages.size(), ~0u);
+		StageID last = 0;
+		for (StageID id = 0; id < m_Stages.size(); ++id)
+		{
+			for (StageID dependency : m_Stages[id].dependencies)
+				if (finish[dependency] > finish[id])
+				{
+					finish[id] = finish[dependency];
+					previous[id] = dependency;
+				}
+			finish[id] += m_Stages[id].duration;
+			if (finish[id] > finish[last])
+				last = id;
+		}
+
+		double serial = 0.0;
+		PR_CORE_INFO("Startup stages:");
+		for (const Stage& stage : m_Stages)
+		{
+			serial += stage.duration;
+			PR_CORE_INFO("  {0:<20} start {1:8.2f}ms  took {2:8.2f}ms  ({3})", stage.name,
+				stage.start * 1000.0, stage.duration * 1000.0, stage.mainThread ? "main" : "worker");
+		}
+
+		std::string path;
+		for (StageID id = last; id != ~0u && !m_Stages.empty(); id = previous[id])
+			path = m_Stages[id].name + (path.empty() ? "" : " -> ") + path;
+
+		PR_CORE_INFO("Startup took {0:.2f}ms (serial {1:.2f}ms), critical path {2:.2f}ms: {3}",
+			m_TotalTime * 1000.0, serial * 1000.0, m_Stages.empty() ? 0.0 : finish[last] * 1000.0, path);
+	}
+}
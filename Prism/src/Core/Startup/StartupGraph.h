@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace Prism {
+
+	/**
+	 * Dependency graph of initialization stages, executed on the TaskSystem
+	 *
+	 * Stages run as soon as all their dependencies are done; stages bound
+	 * to the main thread (window creation, ...) are executed by the thread
+	 * calling Run(). Every stage is timed for the startup report.
+	 */
+	class StartupGraph {
+	public:
+		using StageID = uint32_t;
+
+		/** Dependencies must have been added before (so the graph is acyclic by construction). */
+		StageID AddStage(const std::string& name, std::function<void()> function,
+			std::initializer_list<StageID> dependencies = {}, bool mainThread = false);
+
+		/** Blocks until all stages are done. */
+		void Run();
+
+		/** Logs start, duration and thread of each stage, plus the critical path. */
+		void LogReport() const;
+
+		double GetTotalTime() const { return m_TotalTime; }
+
+	private:
+		struct Stage {
+			std::string name;
+			std::function<void()> function;
+			std::vector<StageID> dependencies;
+			std::vector<StageID> dependents;
+			bool mainThread;
+
+			// relative to the start of Run(), in seconds
+			double start = 0.0, duration = 0.0;
+		};
+
+		struct State; // defined in cpp, shared with the stage tasks
+		void schedule(const std::shared_ptr<State>& state, StageID id);
+		void execute(const std::shared_ptr<State>& state, StageID id);
+
+	private:
+		std::vector<Stage> m_Stages;
+		double m_TotalTime = 0.0;
+	};
+}
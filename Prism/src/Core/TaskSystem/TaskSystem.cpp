@@ -2,11 +2,13 @@
 #include "TaskQueue.h"
 
 #include "Util/Log/Log.h"
+#include "Util/Profiler/Profiler.h"
 
 #include <atomic>
+#include <algorithm>
 
 // uncomment for detailed logging
-#define PR_THREAD_TRACE(...) //PR_CORE_TRACE(__VA_ARGS__)
+#define PR_THREAD_TRACE(...) //PR_TASKS_TRACE(__VA_ARGS__)
 
 namespace Prism {
 
@@ -27,13 +29,17 @@ namespace Prism {
 	void processTasks(uint32_t id)
 	{
 		TaskFunction task;
+		PR_PROFILE_THREAD("worker-" + std::to_string(id));
 
 		while (true)
 		{
 			if (g_Queue.pop(task))
 			{
 				PR_THREAD_TRACE("worker-{0} starting task", id);
-				task(id);
+				{
+					PR_PROFILE_SCOPE("Task");
+					task(id);
+				}
 
 				// increment executionIndex
 				uint64_t current = g_ExecutionIndex.load();
@@ -67,7 +73,7 @@ namespace Prism {
 		g_Threads = std::vector<std::thread>(g_NumThreads);
 		g_QueueIndex = g_ExecutionIndex = 0;
 
-		PR_CORE_INFO("Starting TaskSystem with {0} worker threads", g_NumThreads);
+		PR_TASKS_INFO("Starting TaskSystem with {0} worker threads", g_NumThreads);
 		PR_CORE_ASSERT(g_NumThreads > 0, "There are no worker threads, tasks will be executed on main");
 
 		for (uint32_t i = 0; i < g_NumThreads; ++i)
@@ -112,6 +118,51 @@ namespace Prism {
 		}
 	}
 
+	void TaskSystem::ParallelFor(uint32_t count, uint32_t batchSize,
+		const std::function<void(uint32_t, uint32_t)>& function)
+	{
+		if (count == 0) return;
+		if (batchSize == 0) batchSize = 1;
+
+		const uint32_t numBatches = (count + batchSize - 1) / batchSize;
+		if (g_NumThreads == 0 || numBatches == 1)
+		{
+			function(0, count);
+			return;
+		}
+
+		// shared with the helper tasks, which may start after this call returned
+		struct State {
+			std::atomic<uint32_t> next = 0;
+			std::atomic<uint32_t> done = 0;
+		};
+		auto state = std::make_shared<State>();
+
+		auto work = [state, count, batchSize, numBatches, &function]()
+		{
+			uint32_t batch;
+			while ((batch = state->next.fetch_add(1)) < numBatches)
+			{
+				const uint32_t begin = batch * batchSize;
+				function(begin, std::min(begin + batchSize, count));
+				state->done.fetch_add(1);
+			}
+		};
+
+		const uint32_t helpers = std::min(numBatches - 1, g_NumThreads);
+		for (uint32_t i = 0; i < helpers; ++i)
+			Submit(Task(work));
+
+		work();
+		while (state->done.load() < numBatches)
+			std::this_thread::yield();
+	}
+
+	uint32_t TaskSystem::GetWorkerCount()
+	{
+		return g_NumThreads;
+	}
+
 	void TaskSystem::Finish()
 	{
 		g_Finished = true;
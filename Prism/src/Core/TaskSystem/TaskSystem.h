@@ -18,6 +18,18 @@ namespace Prism {
 		static void Submit(const Task& task);
 		static void Wait();
 		static void Finish();
+
+		/**
+		 * Splits [0, count) into batches of batchSize elements and processes
+		 * them on the workers, the calling thread participates.
+		 *
+		 * Blocks until all batches are done, but only waits for its own
+		 * batches (unlike Wait()), so it can also be called from within tasks.
+		 */
+		static void ParallelFor(uint32_t count, uint32_t batchSize,
+			const std::function<void(uint32_t begin, uint32_t end)>& function);
+
+		static uint32_t GetWorkerCount();
 	};
 
 	struct TaskLock {
@@ -44,7 +56,7 @@ namespace Prism {
 		Task(std::function<void()> fun, bool lockable = false);
 
 		void Submit() { TaskSystem::Submit(*this); }
-		void Wait() { if (mLock) mLock->wait(); else PR_CORE_WARN("Cannot wait for non-existent lock"); }
+		void Wait() { if (mLock) mLock->wait(); else PR_TASKS_WARN("Cannot wait for non-existent lock"); }
 
 	private:
 		std::function<void()> mFunction;
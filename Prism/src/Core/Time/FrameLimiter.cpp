@@ -0,0 +1,50 @@
+#include "FrameLimiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace Prism {
+
+	static constexpr double c_MinSpinMargin = 0.0002;
+	static constexpr double c_MaxSpinMargin = 0.004;
+
+	double FrameLimiter::Now()
+	{
+		using namespace std::chrono;
+		return duration<double>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	double FrameLimiter::Wait()
+	{
+		double now = Now();
+		if (m_FrameStart < 0.0 || m_FrameDuration <= 0.0)
+			return m_FrameStart = now;
+
+		const double target = m_FrameStart + m_FrameDuration;
+
+		// sleep until the spin margin, then learn from how long the sleep really took
+		const double sleepTime = target - now - m_SpinMargin;
+		if (sleepTime > 0.0)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
+			const double after = Now();
+			const double oversleep = (after - now) - sleepTime;
+			// grow fast, shrink slowly
+			m_SpinMargin = oversleep > m_SpinMargin
+				? std::min(oversleep * 1.25, c_MaxSpinMargin)
+				: std::max(m_SpinMargin * 0.99, c_MinSpinMargin);
+			now = after;
+		}
+
+		while (now < target)
+		{
+			std::this_thread::yield();
+			now = Now();
+		}
+
+		// keep the cadence, but don't try to catch up after a long hitch
+		m_FrameStart = now - target < m_FrameDuration ? target : now;
+		return now;
+	}
+}
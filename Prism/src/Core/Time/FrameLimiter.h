@@ -0,0 +1,31 @@
+#pragma once
+
+namespace Prism {
+
+	/**
+	 * Waits for the end of a frame without pegging the CPU
+	 *
+	 * Sleeps for the bulk of the remaining time and spins only for the last
+	 * bit. The spin margin adapts to the observed oversleep of the OS.
+	 */
+	class FrameLimiter {
+	public:
+		// monotonic time in seconds
+		static double Now();
+
+		void SetFrameDuration(double seconds) { m_FrameDuration = seconds; }
+		double GetFrameDuration() const { return m_FrameDuration; }
+
+		/**
+		 * Blocks until frameDuration has passed since the previous call
+		 * (returns immediately if no duration is set), returns the time
+		 * of the new frame's start.
+		 */
+		double Wait();
+
+	private:
+		double m_FrameDuration = 0.0;
+		double m_FrameStart = -1.0;
+		double m_SpinMargin = 0.002; // seconds
+	};
+}
@@ -1,5 +1,7 @@
 #include "Window.h"
 
+#include "Util/FileSystem/VirtualFileSystem.h"
+
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 
@@ -43,10 +45,15 @@ namespace Prism {
 			m_Properties.title.c_str(), monitor, nullptr);
 
 		// icon
-		GLFWimage icons[1];
-		icons[0].pixels = stbi_load("res/icon/icon.png", &icons[0].width, &icons[0].height, 0, STBI_rgb_alpha);
-		glfwSetWindowIcon(m_WindowHandle, 1, icons);
-		stbi_image_free(icons[0].pixels);
+		if (auto file = VirtualFileSystem::Open("res/icon/icon.png"))
+		{
+			GLFWimage icons[1];
+			icons[0].pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file->GetData()), static_cast<int>(file->GetSize()),
+				&icons[0].width, &icons[0].height, 0, STBI_rgb_alpha);
+			if (icons[0].pixels)
+				glfwSetWindowIcon(m_WindowHandle, 1, icons);
+			stbi_image_free(icons[0].pixels);
+		}
 
 		SetGLFWCallbacks();
 	}
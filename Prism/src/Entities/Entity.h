@@ -17,10 +17,14 @@ namespace Prism {
 	public:
 		EntityID id;
 
-		Entity() { PR_CORE_WARN("Entity constructed"); };
+		Entity() { PR_ECS_WARN("Entity constructed"); };
 		~Entity() {};
 
 	private:
+		// used by World::Instantiate for bulk construction (no logging per entity)
+		friend class World;
+		explicit Entity(EntityID id) : id(id) {}
+
 		// Wraps addedComponent (allocated with new) in a unique_ptr in Application::world
 		void Register(Component* addedComponent);
 
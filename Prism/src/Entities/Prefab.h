@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Components/ComponentColumn.h"
+
+#include "Util/Log/Log.h"
+
+#include <vector>
+#include <memory>
+
+namespace Prism {
+
+	/**
+	 * Template for entities sharing the same set of components (archetype)
+	 *
+	 * Holds one prototype per component type, World::Instantiate copies
+	 * them column-wise into contiguous storage for all instances at once.
+	 */
+	class Prefab {
+	public:
+		template<typename T, typename ...Args>
+		T* Add(Args&&... args)
+		{
+			static_assert(std::is_base_of<Component, T>::value, "Component classes must be derivatives of Component.");
+			static_assert(std::is_copy_constructible<T>::value, "Prefab components must be copy-constructible.");
+			PR_CORE_ASSERT(!Has<T>(), "Prefab already contains this component type.");
+
+			auto prototype = std::make_unique<TypedComponentPrototype<T>>(std::forward<Args>(args)...);
+			T* result = static_cast<T*>(prototype->Get());
+			m_Prototypes.push_back(std::move(prototype));
+			return result;
+		}
+
+		template<typename T>
+		T* Get()
+		{
+			for (auto& prototype : m_Prototypes)
+				if (prototype->GetType() == &typeid(T))
+					return static_cast<T*>(prototype->Get());
+			return nullptr;
+		}
+
+		template<typename T>
+		bool Has() const
+		{
+			for (const auto& prototype : m_Prototypes)
+				if (prototype->GetType() == &typeid(T))
+					return true;
+			return false;
+		}
+
+		size_t GetComponentCount() const { return m_Prototypes.size(); }
+
+	private:
+		friend class World;
+		std::vector<std::unique_ptr<ComponentPrototype>> m_Prototypes;
+	};
+}
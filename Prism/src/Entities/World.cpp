@@ -2,12 +2,54 @@
 
 namespace Prism {
 
+	World::~World()
+	{
+		for (auto& block : m_Blocks)
+		{
+			std::destroy_n(block->entities, block->count);
+			std::allocator<Entity>().deallocate(block->entities, block->count);
+		}
+	}
+
 	Entity* World::GetEntity(EntityID id)
 	{
 		auto itr = m_Entities.find(id);
 		if (itr != m_Entities.end())
 			return itr->second;
-		PR_CORE_WARN("Could not find Entity with id {0}", id);
+		PR_ECS_WARN_LIMITED("Could not find Entity with id {0}", id);
 		return nullptr;
 	}
-}
\ No newline at end of file
+
+	World::EntityRange World::Instantiate(const Prefab& prefab, uint32_t count)
+	{
+		if (count == 0) return {};
+		PR_MEMORY_TAG(ECS);
+
+		auto block = std::make_unique<EntityBlock>();
+		block->count = count;
+
+		// one allocation per component type, filled with copies of the prototype
+		block->columns.reserve(prefab.m_Prototypes.size());
+		for (const auto& prototype : prefab.m_Prototypes)
+			block->columns.push_back(prototype->Instantiate(count));
+
+		// reserve a contiguous id range
+		const EntityID first = m_GeneratorID.fetch_add(count);
+
+		block->entities = std::allocator<Entity>().allocate(count);
+		m_Entities.reserve(m_Entities.size() + count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			Entity* entity = new (block->entities + i) Entity(first + i);
+			entity->components.m_Columns = &block->columns;
+			entity->components.m_ColumnIndex = i;
+			m_Entities.emplace(first + i, entity);
+		}
+
+		PR_ECS_TRACE("Instantiated {0} entities with {1} components each", count, block->columns.size());
+
+		EntityRange range{ first, count, block->entities, block.get() };
+		m_Blocks.push_back(std::move(block));
+		return range;
+	}
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Entity.h"
+#include "Prefab.h"
 #include "Systems/System.h"
+#include "Components/ComponentColumn.h"
 
 #include "Util/Log/Log.h"
 
@@ -18,8 +20,41 @@ namespace Prism {
 	 */
 	class World {
 	public:
+		struct EntityBlock; // defined below
+
+		// Contiguous range of entities created by one Instantiate call
+		struct EntityRange {
+			EntityID first = 0;
+			uint32_t count = 0;
+			Entity* entities = nullptr;
+			EntityBlock* block = nullptr;
+		};
+
+		World() = default;
+		~World();
+
 		Entity* GetEntity(EntityID id);
 
+		/**
+		 * Instantiates count copies of the prefab at once
+		 *
+		 * EntityIDs are contiguous, the components are copy-constructed
+		 * column-wise into one allocation per component type.
+		 */
+		EntityRange Instantiate(const Prefab& prefab, uint32_t count);
+
+		// contiguous component data of all entities in the range (nullptr if not in the prefab or the range is empty)
+		template<typename T>
+		T* GetColumn(const EntityRange& range)
+		{
+			if (!range.block)
+				return nullptr;
+			for (auto& column : range.block->columns)
+				if (column->GetType() == &typeid(T))
+					return static_cast<TypedComponentColumn<T>*>(column.get())->Data();
+			return nullptr;
+		}
+
 
 		// owning hash-map for systems
 		SystemsMap systems;
@@ -30,11 +65,19 @@ namespace Prism {
 		// non-owning unorderedMap for entities
 		std::unordered_map<EntityID, Entity*> m_Entities{};
 
+		// Owning storage of prefab instances (entities + one column per component type)
+		struct EntityBlock {
+			Entity* entities = nullptr;
+			uint32_t count = 0;
+			std::vector<std::unique_ptr<ComponentColumn>> columns;
+		};
 
 	private:
 		friend class Entity;
 		std::atomic<EntityID> m_GeneratorID{ 1 };
 
+		std::vector<std::unique_ptr<EntityBlock>> m_Blocks;
+
 		void DestroyComponents(Entity* entity) {}
 	};
-}
\ No newline at end of file
+}
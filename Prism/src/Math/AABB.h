@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Vector.h"
+#include "Matrix.h"
+
+#include <limits>
+
+namespace Prism {
+
+	// axis-aligned bounding box, empty boxes have min > max
+	struct AABB {
+		vec3 min{ std::numeric_limits<float>::max() };
+		vec3 max{ -std::numeric_limits<float>::max() };
+
+		constexpr AABB() = default;
+		constexpr AABB(const vec3& min, const vec3& max) : min(min), max(max) {}
+
+		static constexpr AABB FromCenterExtents(const vec3& center, const vec3& extents) { return { center - extents, center + extents }; }
+
+		constexpr bool Empty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+		constexpr vec3 Center() const { return (min + max) * 0.5f; }
+		constexpr vec3 Extents() const { return (max - min) * 0.5f; }
+		constexpr float SurfaceArea() const
+		{
+			const vec3 d = max - min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		void Merge(const vec3& p) { min = Min(min, p); max = Max(max, p); }
+		void Merge(const AABB& other) { min = Min(min, other.min); max = Max(max, other.max); }
+
+		constexpr bool Overlaps(const AABB& o) const
+		{
+			return min.x <= o.max.x && max.x >= o.min.x
+				&& min.y <= o.max.y && max.y >= o.min.y
+				&& min.z <= o.max.z && max.z >= o.min.z;
+		}
+
+		constexpr bool Contains(const vec3& p) const
+		{
+			return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+		}
+
+		constexpr bool Contains(const AABB& o) const
+		{
+			return o.min.x >= min.x && o.max.x <= max.x && o.min.y >= min.y
+				&& o.max.y <= max.y && o.min.z >= min.z && o.max.z <= max.z;
+		}
+	};
+
+	inline AABB Merge(const AABB& a, const AABB& b) { return { Min(a.min, b.min), Max(a.max, b.max) }; }
+
+	// bounds of the transformed box (affine m)
+	inline AABB TransformBounds(const mat4& m, const AABB& box)
+	{
+		const vec3 center = TransformPoint(m, box.Center());
+		const vec3 e = box.Extents();
+		const vec3 extents = Abs(m[0].xyz()) * e.x + Abs(m[1].xyz()) * e.y + Abs(m[2].xyz()) * e.z;
+		return AABB::FromCenterExtents(center, extents);
+	}
+
+	inline float SquaredDistance(const AABB& box, const vec3& p)
+	{
+		const vec3 d = Max(Max(box.min - p, p - box.max), vec3(0.0f));
+		return Dot(d, d);
+	}
+
+	struct Sphere {
+		vec3 center;
+		float radius = 0.0f;
+
+		constexpr bool Overlaps(const Sphere& o) const
+		{
+			const vec3 d = center - o.center;
+			const float r = radius + o.radius;
+			return Dot(d, d) <= r * r;
+		}
+	};
+
+	struct Ray {
+		vec3 origin;
+		vec3 direction;
+		vec3 invDirection; // cached for the slab test
+
+		Ray() = default;
+		Ray(const vec3& origin, const vec3& direction)
+			: origin(origin), direction(direction)
+			, invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z) {}
+
+		constexpr vec3 At(float t) const { return origin + direction * t; }
+	};
+
+	/**
+	 * Slab test of the ray against the box within [0, tMax]
+	 *
+	 * @returns if the box was hit, tHit is set to the entry distance
+	 */
+	inline bool Intersect(const Ray& ray, const AABB& box, float tMax, float& tHit)
+	{
+		const vec3 t0 = (box.min - ray.origin) * ray.invDirection;
+		const vec3 t1 = (box.max - ray.origin) * ray.invDirection;
+		const vec3 tNear = Min(t0, t1);
+		const vec3 tFar = Max(t0, t1);
+
+		const float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+		const float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+		tHit = enter;
+		return enter <= exit;
+	}
+
+	// plane of points p with Dot(normal, p) + d = 0, normal points to the positive half-space
+	struct Plane {
+		vec3 normal{ 0.0f, 1.0f, 0.0f };
+		float d = 0.0f;
+
+		constexpr float Distance(const vec3& p) const { return Dot(normal, p) + d; }
+
+		inline Plane Normalized() const
+		{
+			const float inv = 1.0f / Length(normal);
+			return { normal * inv, d * inv };
+		}
+	};
+}
@@ -0,0 +1,182 @@
+#include "Batch.h"
+
+namespace Prism {
+
+	void TransformPointsScalar(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float px = x[i], py = y[i], pz = z[i];
+			outX[i] = m[0].x * px + m[1].x * py + m[2].x * pz + m[3].x;
+			outY[i] = m[0].y * px + m[1].y * py + m[2].y * pz + m[3].y;
+			outZ[i] = m[0].z * px + m[1].z * py + m[2].z * pz + m[3].z;
+		}
+	}
+
+	void TransformDirectionsScalar(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float dx = x[i], dy = y[i], dz = z[i];
+			outX[i] = m[0].x * dx + m[1].x * dy + m[2].x * dz;
+			outY[i] = m[0].y * dx + m[1].y * dy + m[2].y * dz;
+			outZ[i] = m[0].z * dx + m[1].z * dy + m[2].z * dz;
+		}
+	}
+
+	void NormalizeBatchScalar(float* x, float* y, float* z, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float inv = 1.0f / std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+			x[i] *= inv; y[i] *= inv; z[i] *= inv;
+		}
+	}
+
+	void MulMat4BatchScalar(const mat4* a, const mat4* b, mat4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			mat4 result(0.0f);
+			for (int c = 0; c < 4; ++c)
+				for (int k = 0; k < 4; ++k)
+					result[c] += a[i][k] * b[i][c][k];
+			out[i] = result;
+		}
+	}
+
+#if defined(PR_SIMD_AVX2)
+	using simd_t = __m256;
+#define PR_SIMD_SET1 _mm256_set1_ps
+#define PR_SIMD_LOAD _mm256_loadu_ps
+#define PR_SIMD_STORE _mm256_storeu_ps
+#define PR_SIMD_ADD _mm256_add_ps
+#define PR_SIMD_MUL _mm256_mul_ps
+#define PR_SIMD_SQRT _mm256_sqrt_ps
+#define PR_SIMD_DIV _mm256_div_ps
+#elif defined(PR_SIMD_SSE)
+	using simd_t = __m128;
+#define PR_SIMD_SET1 _mm_set1_ps
+#define PR_SIMD_LOAD _mm_loadu_ps
+#define PR_SIMD_STORE _mm_storeu_ps
+#define PR_SIMD_ADD _mm_add_ps
+#define PR_SIMD_MUL _mm_mul_ps
+#define PR_SIMD_SQRT _mm_sqrt_ps
+#define PR_SIMD_DIV _mm_div_ps
+#endif
+
+	void TransformPoints(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count)
+	{
+		size_t i = 0;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t m00 = PR_SIMD_SET1(m[0].x), m10 = PR_SIMD_SET1(m[1].x), m20 = PR_SIMD_SET1(m[2].x), m30 = PR_SIMD_SET1(m[3].x);
+		const simd_t m01 = PR_SIMD_SET1(m[0].y), m11 = PR_SIMD_SET1(m[1].y), m21 = PR_SIMD_SET1(m[2].y), m31 = PR_SIMD_SET1(m[3].y);
+		const simd_t m02 = PR_SIMD_SET1(m[0].z), m12 = PR_SIMD_SET1(m[1].z), m22 = PR_SIMD_SET1(m[2].z), m32 = PR_SIMD_SET1(m[3].z);
+
+		for (; i + PR_SIMD_WIDTH <= count; i += PR_SIMD_WIDTH)
+		{
+			const simd_t px = PR_SIMD_LOAD(x + i), py = PR_SIMD_LOAD(y + i), pz = PR_SIMD_LOAD(z + i);
+			PR_SIMD_STORE(outX + i, PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(m00, px), PR_SIMD_MUL(m10, py)), PR_SIMD_MUL(m20, pz)), m30));
+			PR_SIMD_STORE(outY + i, PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(m01, px), PR_SIMD_MUL(m11, py)), PR_SIMD_MUL(m21, pz)), m31));
+			PR_SIMD_STORE(outZ + i, PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(m02, px), PR_SIMD_MUL(m12, py)), PR_SIMD_MUL(m22, pz)), m32));
+		}
+#endif
+		TransformPointsScalar(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i);
+	}
+
+	void TransformDirections(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count)
+	{
+		size_t i = 0;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t m00 = PR_SIMD_SET1(m[0].x), m10 = PR_SIMD_SET1(m[1].x), m20 = PR_SIMD_SET1(m[2].x);
+		const simd_t m01 = PR_SIMD_SET1(m[0].y), m11 = PR_SIMD_SET1(m[1].y), m21 = PR_SIMD_SET1(m[2].y);
+		const simd_t m02 = PR_SIMD_SET1(m[0].z), m12 = PR_SIMD_SET1(m[1].z), m22 = PR_SIMD_SET1(m[2].z);
+
+		for (; i + PR_SIMD_WIDTH <= count; i += PR_SIMD_WIDTH)
+		{
+			const simd_t dx = PR_SIMD_LOAD(x + i), dy = PR_SIMD_LOAD(y + i), dz = PR_SIMD_LOAD(z + i);
+			PR_SIMD_STORE(outX + i, PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(m00, dx), PR_SIMD_MUL(m10, dy)), PR_SIMD_MUL(m20, dz)));
+			PR_SIMD_STORE(outY + i, PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(m01, dx), PR_SIMD_MUL(m11, dy)), PR_SIMD_MUL(m21, dz)));
+			PR_SIMD_STORE(outZ + i, PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(m02, dx), PR_SIMD_MUL(m12, dy)), PR_SIMD_MUL(m22, dz)));
+		}
+#endif
+		TransformDirectionsScalar(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i);
+	}
+
+	void NormalizeBatch(float* x, float* y, float* z, size_t count)
+	{
+		size_t i = 0;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t one = PR_SIMD_SET1(1.0f);
+		for (; i + PR_SIMD_WIDTH <= count; i += PR_SIMD_WIDTH)
+		{
+			const simd_t vx = PR_SIMD_LOAD(x + i), vy = PR_SIMD_LOAD(y + i), vz = PR_SIMD_LOAD(z + i);
+			const simd_t lengthSq = PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(vx, vx), PR_SIMD_MUL(vy, vy)), PR_SIMD_MUL(vz, vz));
+			// exact sqrt + div (not rsqrt) to match the scalar reference
+			const simd_t inv = PR_SIMD_DIV(one, PR_SIMD_SQRT(lengthSq));
+			PR_SIMD_STORE(x + i, PR_SIMD_MUL(vx, inv));
+			PR_SIMD_STORE(y + i, PR_SIMD_MUL(vy, inv));
+			PR_SIMD_STORE(z + i, PR_SIMD_MUL(vz, inv));
+		}
+#endif
+		NormalizeBatchScalar(x + i, y + i, z + i, count - i);
+	}
+
+	void MulMat4Batch(const mat4* a, const mat4* b, mat4* out, size_t count)
+	{
+#if defined(PR_SIMD_AVX2)
+		// two result columns per register: lane 0 = column j, lane 1 = column j+1
+		// (mat4 is only 16 byte aligned, so unaligned 256 bit loads/stores)
+		for (size_t i = 0; i < count; ++i)
+		{
+			const __m256 a0 = _mm256_broadcast_ps((const __m128*)&a[i][0].x);
+			const __m256 a1 = _mm256_broadcast_ps((const __m128*)&a[i][1].x);
+			const __m256 a2 = _mm256_broadcast_ps((const __m128*)&a[i][2].x);
+			const __m256 a3 = _mm256_broadcast_ps((const __m128*)&a[i][3].x);
+
+			for (int j = 0; j < 4; j += 2)
+			{
+				const __m256 bj = _mm256_loadu_ps(&b[i][j].x);
+				__m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+				r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+				r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+				r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm256_storeu_ps(&out[i][j].x, r);
+			}
+		}
+#elif defined(PR_SIMD_SSE)
+		for (size_t i = 0; i < count; ++i)
+			out[i] = a[i] * b[i];
+#else
+		MulMat4BatchScalar(a, b, out, count);
+#endif
+	}
+
+	void MulMat4Batch(const mat4& a, const mat4* b, mat4* out, size_t count)
+	{
+#if defined(PR_SIMD_AVX2)
+		const __m256 a0 = _mm256_broadcast_ps((const __m128*)&a[0].x);
+		const __m256 a1 = _mm256_broadcast_ps((const __m128*)&a[1].x);
+		const __m256 a2 = _mm256_broadcast_ps((const __m128*)&a[2].x);
+		const __m256 a3 = _mm256_broadcast_ps((const __m128*)&a[3].x);
+
+		for (size_t i = 0; i < count; ++i)
+			for (int j = 0; j < 4; j += 2)
+			{
+				const __m256 bj = _mm256_loadu_ps(&b[i][j].x);
+				__m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+				r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+				r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+				r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm256_storeu_ps(&out[i][j].x, r);
+			}
+#else
+		for (size_t i = 0; i < count; ++i)
+			out[i] = a * b[i];
+#endif
+	}
+}
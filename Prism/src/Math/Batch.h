@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Matrix.h"
+
+#include <cstddef>
+
+namespace Prism {
+
+	/**
+	 * SoA batch kernels
+	 *
+	 * Process PR_SIMD_WIDTH elements per instruction (AVX2: 8, SSE: 4),
+	 * the remainder is handled by the scalar reference implementation.
+	 * The *Scalar variants are the plain reference versions of the same
+	 * operation (also used to benchmark and verify the kernels).
+	 * Input and output arrays may alias but must not partially overlap.
+	 */
+
+	// out = m * (x, y, z, 1) for count points (affine m)
+	void TransformPoints(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count);
+	void TransformPointsScalar(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count);
+
+	// out = m * (x, y, z, 0) for count directions
+	void TransformDirections(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count);
+	void TransformDirectionsScalar(const mat4& m, const float* x, const float* y, const float* z,
+		float* outX, float* outY, float* outZ, size_t count);
+
+	// normalizes count vectors in place
+	void NormalizeBatch(float* x, float* y, float* z, size_t count);
+	void NormalizeBatchScalar(float* x, float* y, float* z, size_t count);
+
+	// out[i] = a[i] * b[i]
+	void MulMat4Batch(const mat4* a, const mat4* b, mat4* out, size_t count);
+	void MulMat4BatchScalar(const mat4* a, const mat4* b, mat4* out, size_t count);
+
+	// out[i] = a * b[i]
+	void MulMat4Batch(const mat4& a, const mat4* b, mat4* out, size_t count);
+}
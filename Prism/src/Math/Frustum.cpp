@@ -0,0 +1,144 @@
+#include "Frustum.h"
+
+namespace Prism {
+
+	Frustum::Frustum(const mat4& m)
+	{
+		// rows of the column-major matrix
+		const vec4 row0{ m[0].x, m[1].x, m[2].x, m[3].x };
+		const vec4 row1{ m[0].y, m[1].y, m[2].y, m[3].y };
+		const vec4 row2{ m[0].z, m[1].z, m[2].z, m[3].z };
+		const vec4 row3{ m[0].w, m[1].w, m[2].w, m[3].w };
+
+		// -w <= x <= w, -w <= y <= w, 0 <= z <= w
+		const vec4 equations[6] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2 };
+
+		for (int i = 0; i < 6; ++i)
+		{
+			planes[i] = Plane{ equations[i].xyz(), equations[i].w }.Normalized();
+			normalX[i] = planes[i].normal.x;
+			normalY[i] = planes[i].normal.y;
+			normalZ[i] = planes[i].normal.z;
+			distance[i] = planes[i].d;
+		}
+	}
+
+	bool Frustum::Intersects(const Sphere& sphere) const
+	{
+		for (const auto& plane : planes)
+			if (plane.Distance(sphere.center) < -sphere.radius)
+				return false;
+		return true;
+	}
+
+	bool Frustum::Intersects(const AABB& box) const
+	{
+		const vec3 center = box.Center();
+		const vec3 extents = box.Extents();
+		for (const auto& plane : planes)
+			if (plane.Distance(center) + Dot(Abs(plane.normal), extents) < 0.0f)
+				return false;
+		return true;
+	}
+
+	template<bool Spheres, bool Boxes>
+	static bool visibleScalar(const Frustum& f, const BoundsSoA& b, uint32_t i)
+	{
+		for (int p = 0; p < 6; ++p)
+		{
+			const float d = f.normalX[p] * b.centerX[i] + f.normalY[p] * b.centerY[i] + f.normalZ[p] * b.centerZ[i] + f.distance[p];
+			if (Spheres && d + b.radius[i] < 0.0f) return false;
+			if (Boxes && d + (std::abs(f.normalX[p]) * b.extentX[i] + std::abs(f.normalY[p]) * b.extentY[i]
+				+ std::abs(f.normalZ[p]) * b.extentZ[i]) < 0.0f) return false;
+		}
+		return true;
+	}
+
+	template<bool Spheres, bool Boxes>
+	static uint32_t cullScalar(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		uint32_t count = 0;
+		for (uint32_t i = begin; i < end; ++i)
+			if (visibleScalar<Spheres, Boxes>(f, b, i))
+				visible[count++] = i;
+		return count;
+	}
+
+#if defined(PR_SIMD_AVX2)
+	using simd_t = __m256;
+#define PR_SIMD_SET1 _mm256_set1_ps
+#define PR_SIMD_LOAD _mm256_loadu_ps
+#define PR_SIMD_ADD _mm256_add_ps
+#define PR_SIMD_MUL _mm256_mul_ps
+#define PR_SIMD_AND _mm256_and_ps
+#define PR_SIMD_CMPGE(a, b) _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define PR_SIMD_ALLTRUE _mm256_castsi256_ps(_mm256_set1_epi32(-1))
+#define PR_SIMD_MOVEMASK _mm256_movemask_ps
+#elif defined(PR_SIMD_SSE)
+	using simd_t = __m128;
+#define PR_SIMD_SET1 _mm_set1_ps
+#define PR_SIMD_LOAD _mm_loadu_ps
+#define PR_SIMD_ADD _mm_add_ps
+#define PR_SIMD_MUL _mm_mul_ps
+#define PR_SIMD_AND _mm_and_ps
+#define PR_SIMD_CMPGE(a, b) _mm_cmpge_ps(a, b)
+#define PR_SIMD_ALLTRUE _mm_castsi128_ps(_mm_set1_epi32(-1))
+#define PR_SIMD_MOVEMASK _mm_movemask_ps
+#endif
+
+	template<bool Spheres, bool Boxes>
+	static uint32_t cull(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible)
+	{
+		uint32_t count = 0;
+		uint32_t i = begin;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		simd_t nx[6], ny[6], nz[6], d[6], ax[6], ay[6], az[6];
+		for (int p = 0; p < 6; ++p)
+		{
+			nx[p] = PR_SIMD_SET1(f.normalX[p]); ny[p] = PR_SIMD_SET1(f.normalY[p]);
+			nz[p] = PR_SIMD_SET1(f.normalZ[p]); d[p] = PR_SIMD_SET1(f.distance[p]);
+			ax[p] = PR_SIMD_SET1(std::abs(f.normalX[p])); ay[p] = PR_SIMD_SET1(std::abs(f.normalY[p]));
+			az[p] = PR_SIMD_SET1(std::abs(f.normalZ[p]));
+		}
+		const simd_t zero = PR_SIMD_SET1(0.0f);
+
+		for (; i + PR_SIMD_WIDTH <= end; i += PR_SIMD_WIDTH)
+		{
+			const simd_t cx = PR_SIMD_LOAD(b.centerX + i), cy = PR_SIMD_LOAD(b.centerY + i), cz = PR_SIMD_LOAD(b.centerZ + i);
+			simd_t r, ex, ey, ez;
+			if (Spheres) r = PR_SIMD_LOAD(b.radius + i);
+			if (Boxes) { ex = PR_SIMD_LOAD(b.extentX + i); ey = PR_SIMD_LOAD(b.extentY + i); ez = PR_SIMD_LOAD(b.extentZ + i); }
+
+			simd_t inside = PR_SIMD_ALLTRUE;
+			for (int p = 0; p < 6; ++p)
+			{
+				const simd_t dist = PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(nx[p], cx), PR_SIMD_MUL(ny[p], cy)), PR_SIMD_MUL(nz[p], cz)), d[p]);
+				if (Spheres)
+					inside = PR_SIMD_AND(inside, PR_SIMD_CMPGE(PR_SIMD_ADD(dist, r), zero));
+				if (Boxes)
+				{
+					const simd_t extent = PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(ax[p], ex), PR_SIMD_MUL(ay[p], ey)), PR_SIMD_MUL(az[p], ez));
+					inside = PR_SIMD_AND(inside, PR_SIMD_CMPGE(PR_SIMD_ADD(dist, extent), zero));
+				}
+			}
+
+			// compact the visible lanes into the index list
+			uint32_t mask = static_cast<uint32_t>(PR_SIMD_MOVEMASK(inside));
+			while (mask)
+			{
+				visible[count++] = i + LowestBitIndex(mask);
+				mask &= mask - 1;
+			}
+		}
+#endif
+		return count + cullScalar<Spheres, Boxes>(f, b, i, end, visible + count);
+	}
+
+	uint32_t CullSpheres(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible) { return cull<true, false>(f, b, begin, end, visible); }
+	uint32_t CullAABBs(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible) { return cull<false, true>(f, b, begin, end, visible); }
+	uint32_t CullBounds(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible) { return cull<true, true>(f, b, begin, end, visible); }
+
+	uint32_t CullSpheresScalar(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible) { return cullScalar<true, false>(f, b, begin, end, visible); }
+	uint32_t CullAABBsScalar(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible) { return cullScalar<false, true>(f, b, begin, end, visible); }
+	uint32_t CullBoundsScalar(const Frustum& f, const BoundsSoA& b, uint32_t begin, uint32_t end, uint32_t* visible) { return cullScalar<true, true>(f, b, begin, end, visible); }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "SIMD.h"
+#include "Matrix.h"
+#include "AABB.h"
+
+#include <cstdint>
+
+namespace Prism {
+
+	/**
+	 * View frustum as six inward-facing planes
+	 * (left, right, bottom, top, near, far)
+	 *
+	 * The planes are also stored SoA for the SIMD culling kernels.
+	 */
+	struct Frustum {
+		Plane planes[6];
+
+		float normalX[6], normalY[6], normalZ[6], distance[6];
+
+		Frustum() = default;
+		// extracts the planes of a Vulkan clip space (depth [0, 1]) view-projection matrix
+		explicit Frustum(const mat4& viewProjection);
+
+		bool Intersects(const Sphere& sphere) const;
+		bool Intersects(const AABB& box) const;
+	};
+
+	// SoA bounding volumes sharing their center: spheres (radius) and boxes (half extents)
+	struct BoundsSoA {
+		const float* centerX;
+		const float* centerY;
+		const float* centerZ;
+		const float* radius;
+		const float* extentX;
+		const float* extentY;
+		const float* extentZ;
+	};
+
+	/**
+	 * Frustum culling kernels, test the bounds [begin, end)
+	 *
+	 * Indices of the visible bounds are written compactly to visible
+	 * (which must have room for end - begin entries).
+	 * Process 8 bounds per instruction with AVX2, 4 with SSE.
+	 *
+	 * @returns the number of visible bounds
+	 */
+	uint32_t CullSpheres(const Frustum& frustum, const BoundsSoA& bounds, uint32_t begin, uint32_t end, uint32_t* visible);
+	uint32_t CullAABBs(const Frustum& frustum, const BoundsSoA& bounds, uint32_t begin, uint32_t end, uint32_t* visible);
+	// visible only if both the sphere and the box intersect the frustum
+	uint32_t CullBounds(const Frustum& frustum, const BoundsSoA& bounds, uint32_t begin, uint32_t end, uint32_t* visible);
+
+	// scalar reference implementations
+	uint32_t CullSpheresScalar(const Frustum& frustum, const BoundsSoA& bounds, uint32_t begin, uint32_t end, uint32_t* visible);
+	uint32_t CullAABBsScalar(const Frustum& frustum, const BoundsSoA& bounds, uint32_t begin, uint32_t end, uint32_t* visible);
+	uint32_t CullBoundsScalar(const Frustum& frustum, const BoundsSoA& bounds, uint32_t begin, uint32_t end, uint32_t* visible);
+}
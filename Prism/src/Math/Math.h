@@ -0,0 +1,17 @@
+#pragma once
+
+#include "SIMD.h"
+#include "Vector.h"
+#include "Quaternion.h"
+#include "Matrix.h"
+#include "AABB.h"
+#include "Frustum.h"
+#include "Batch.h"
+
+namespace Prism {
+
+	constexpr float PI = 3.14159265358979323846f;
+
+	constexpr float Radians(float degrees) { return degrees * (PI / 180.0f); }
+	constexpr float Degrees(float radians) { return radians * (180.0f / PI); }
+}
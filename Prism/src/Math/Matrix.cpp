@@ -0,0 +1,190 @@
+#include "Matrix.h"
+
+namespace Prism {
+
+	mat3 operator*(const mat3& a, const mat3& b)
+	{
+		return { a * b[0], a * b[1], a * b[2] };
+	}
+
+	vec3 operator*(const mat3& m, const vec3& v)
+	{
+		return m[0] * v.x + m[1] * v.y + m[2] * v.z;
+	}
+
+	mat4 mat4::Translation(const vec3& t)
+	{
+		mat4 result;
+		result[3] = { t, 1.0f };
+		return result;
+	}
+
+	mat4 mat4::Scaling(const vec3& s)
+	{
+		return { { s.x, 0.0f, 0.0f, 0.0f }, { 0.0f, s.y, 0.0f, 0.0f }, { 0.0f, 0.0f, s.z, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } };
+	}
+
+	mat4 mat4::Rotation(const quat& q)
+	{
+		return mat4(ToMat3(q));
+	}
+
+	mat4 mat4::Compose(const vec3& translation, const quat& rotation, const vec3& scale)
+	{
+		const mat3 r = ToMat3(rotation);
+		return { { r[0] * scale.x, 0.0f }, { r[1] * scale.y, 0.0f }, { r[2] * scale.z, 0.0f }, { translation, 1.0f } };
+	}
+
+	mat4 mat4::Perspective(float fovY, float aspect, float zNear, float zFar)
+	{
+		const float f = 1.0f / std::tan(fovY * 0.5f);
+
+		mat4 result(0.0f);
+		result[0][0] = f / aspect;
+		result[1][1] = -f;
+		result[2][2] = zFar / (zNear - zFar);
+		result[2][3] = -1.0f;
+		result[3][2] = zNear * zFar / (zNear - zFar);
+		return result;
+	}
+
+	mat4 mat4::Orthographic(float left, float right, float bottom, float top, float zNear, float zFar)
+	{
+		mat4 result;
+		result[0][0] = 2.0f / (right - left);
+		result[1][1] = -2.0f / (top - bottom);
+		result[2][2] = 1.0f / (zNear - zFar);
+		result[3][0] = -(right + left) / (right - left);
+		result[3][1] = (top + bottom) / (top - bottom);
+		result[3][2] = zNear / (zNear - zFar);
+		return result;
+	}
+
+	mat4 mat4::LookAt(const vec3& eye, const vec3& center, const vec3& up)
+	{
+		const vec3 f = Normalize(center - eye);
+		const vec3 s = Normalize(Cross(f, up));
+		const vec3 u = Cross(s, f);
+
+		return {
+			{ s.x, u.x, -f.x, 0.0f },
+			{ s.y, u.y, -f.y, 0.0f },
+			{ s.z, u.z, -f.z, 0.0f },
+			{ -Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1.0f } };
+	}
+
+	mat3 Transpose(const mat3& m)
+	{
+		return {
+			{ m[0].x, m[1].x, m[2].x },
+			{ m[0].y, m[1].y, m[2].y },
+			{ m[0].z, m[1].z, m[2].z } };
+	}
+
+	mat4 Transpose(const mat4& m)
+	{
+		mat4 result = m;
+#if defined(PR_SIMD_SSE)
+		__m128 c0 = _mm_load_ps(&m[0].x), c1 = _mm_load_ps(&m[1].x);
+		__m128 c2 = _mm_load_ps(&m[2].x), c3 = _mm_load_ps(&m[3].x);
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+		_mm_store_ps(&result[0].x, c0);
+		_mm_store_ps(&result[1].x, c1);
+		_mm_store_ps(&result[2].x, c2);
+		_mm_store_ps(&result[3].x, c3);
+#else
+		for (int c = 0; c < 4; ++c)
+			for (int r = 0; r < 4; ++r)
+				result[c][r] = m[r][c];
+#endif
+		return result;
+	}
+
+	float Determinant(const mat3& m)
+	{
+		return Dot(m[0], Cross(m[1], m[2]));
+	}
+
+	mat3 Inverse(const mat3& m)
+	{
+		// rows of the inverse are the cross products of the columns
+		const vec3 r0 = Cross(m[1], m[2]);
+		const vec3 r1 = Cross(m[2], m[0]);
+		const vec3 r2 = Cross(m[0], m[1]);
+		const float invDet = 1.0f / Dot(m[0], r0);
+		return Transpose(mat3{ r0 * invDet, r1 * invDet, r2 * invDet });
+	}
+
+	mat4 Inverse(const mat4& mat)
+	{
+		// cofactor expansion, valid for any storage order
+		const float* m = mat.data();
+		mat4 result;
+		float* inv = result.data();
+
+		inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+		inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+		inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+		inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+		inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+		inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+		inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+		inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+		const float invDet = 1.0f / (m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12]);
+		for (int i = 0; i < 16; ++i)
+			inv[i] *= invDet;
+		return result;
+	}
+
+	mat4 AffineInverse(const mat4& m)
+	{
+		const mat3 invLinear = Inverse(ToMat3(m));
+		const vec3 t = -(invLinear * m[3].xyz());
+		return { { invLinear[0], 0.0f }, { invLinear[1], 0.0f }, { invLinear[2], 0.0f }, { t, 1.0f } };
+	}
+
+	mat3 ToMat3(const quat& q)
+	{
+		const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		return {
+			{ 1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy) },
+			{ 2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx) },
+			{ 2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy) } };
+	}
+
+	quat Slerp(const quat& a, const quat& b, float t)
+	{
+		float cosTheta = Dot(a, b);
+		quat end = b;
+		if (cosTheta < 0.0f) // take the shortest arc
+		{
+			cosTheta = -cosTheta;
+			end = { -b.x, -b.y, -b.z, -b.w };
+		}
+
+		float wa = 1.0f - t, wb = t;
+		if (cosTheta < 0.9995f) // fall back to nlerp for (nearly) parallel quaternions
+		{
+			const float theta = std::acos(cosTheta);
+			const float invSin = 1.0f / std::sin(theta);
+			wa = std::sin((1.0f - t) * theta) * invSin;
+			wb = std::sin(t * theta) * invSin;
+		}
+
+		return Normalize(quat{
+			a.x * wa + end.x * wb, a.y * wa + end.y * wb,
+			a.z * wa + end.z * wb, a.w * wa + end.w * wb });
+	}
+}
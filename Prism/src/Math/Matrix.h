@@ -0,0 +1,91 @@
+#pragma once
+
+#include "SIMD.h"
+#include "Vector.h"
+#include "Quaternion.h"
+
+namespace Prism {
+
+	// column-major 3x3 matrix, m[column][row]
+	struct mat3 {
+		vec3 columns[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+
+		constexpr mat3() = default;
+		constexpr explicit mat3(float diagonal)
+			: columns{ { diagonal, 0.0f, 0.0f }, { 0.0f, diagonal, 0.0f }, { 0.0f, 0.0f, diagonal } } {}
+		constexpr mat3(const vec3& c0, const vec3& c1, const vec3& c2) : columns{ c0, c1, c2 } {}
+
+		vec3& operator[](int i) { return columns[i]; }
+		constexpr const vec3& operator[](int i) const { return columns[i]; }
+	};
+
+	// column-major 4x4 matrix, m[column][row], columns are SSE aligned
+	struct alignas(16) mat4 {
+		vec4 columns[4] = {
+			{ 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } };
+
+		constexpr mat4() = default;
+		constexpr explicit mat4(float diagonal)
+			: columns{ { diagonal, 0.0f, 0.0f, 0.0f }, { 0.0f, diagonal, 0.0f, 0.0f },
+				{ 0.0f, 0.0f, diagonal, 0.0f }, { 0.0f, 0.0f, 0.0f, diagonal } } {}
+		constexpr mat4(const vec4& c0, const vec4& c1, const vec4& c2, const vec4& c3) : columns{ c0, c1, c2, c3 } {}
+		constexpr explicit mat4(const mat3& m)
+			: columns{ { m[0], 0.0f }, { m[1], 0.0f }, { m[2], 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } {}
+
+		vec4& operator[](int i) { return columns[i]; }
+		constexpr const vec4& operator[](int i) const { return columns[i]; }
+
+		const float* data() const { return &columns[0].x; }
+		float* data() { return &columns[0].x; }
+
+		static mat4 Translation(const vec3& t);
+		static mat4 Scaling(const vec3& s);
+		static mat4 Rotation(const quat& q);
+		// translation * rotation * scale
+		static mat4 Compose(const vec3& translation, const quat& rotation, const vec3& scale);
+
+		// right-handed, depth range [0, 1], y pointing down (Vulkan clip space)
+		static mat4 Perspective(float fovY, float aspect, float zNear, float zFar);
+		static mat4 Orthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+		static mat4 LookAt(const vec3& eye, const vec3& center, const vec3& up);
+	};
+
+	mat3 operator*(const mat3& a, const mat3& b);
+	vec3 operator*(const mat3& m, const vec3& v);
+
+	inline vec4 operator*(const mat4& m, const vec4& v)
+	{
+#if defined(PR_SIMD_SSE)
+		vec4 result;
+		__m128 r = _mm_mul_ps(_mm_load_ps(&m[0].x), _mm_set1_ps(v.x));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&m[1].x), _mm_set1_ps(v.y)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&m[2].x), _mm_set1_ps(v.z)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&m[3].x), _mm_set1_ps(v.w)));
+		_mm_store_ps(&result.x, r);
+		return result;
+#else
+		return m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3] * v.w;
+#endif
+	}
+
+	inline mat4 operator*(const mat4& a, const mat4& b)
+	{
+		return { a * b[0], a * b[1], a * b[2], a * b[3] };
+	}
+
+	// affine transformations (ignore the projective row)
+	inline vec3 TransformPoint(const mat4& m, const vec3& p) { return (m * vec4(p, 1.0f)).xyz(); }
+	inline vec3 TransformDirection(const mat4& m, const vec3& d) { return (m * vec4(d, 0.0f)).xyz(); }
+
+	mat3 Transpose(const mat3& m);
+	mat4 Transpose(const mat4& m);
+	float Determinant(const mat3& m);
+	mat3 Inverse(const mat3& m);
+	mat4 Inverse(const mat4& m);
+	// cheaper inverse for matrices without projective part (e.g. model matrices)
+	mat4 AffineInverse(const mat4& m);
+
+	mat3 ToMat3(const quat& q);
+	inline mat3 ToMat3(const mat4& m) { return { m[0].xyz(), m[1].xyz(), m[2].xyz() }; }
+}
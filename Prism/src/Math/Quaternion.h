@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Vector.h"
+
+namespace Prism {
+
+	// unit quaternion representing a rotation, w is the scalar part
+	struct alignas(16) quat {
+		float x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f;
+
+		constexpr quat() = default;
+		constexpr quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+		static quat AxisAngle(const vec3& axis, float radians)
+		{
+			const float s = std::sin(radians * 0.5f);
+			const vec3 n = Normalize(axis);
+			return { n.x * s, n.y * s, n.z * s, std::cos(radians * 0.5f) };
+		}
+
+		constexpr vec3 xyz() const { return { x, y, z }; }
+	};
+
+	// Hamilton product, applies b first, then a
+	constexpr quat operator*(const quat& a, const quat& b)
+	{
+		return {
+			a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+		};
+	}
+
+	constexpr float Dot(const quat& a, const quat& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+	constexpr quat Conjugate(const quat& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+	inline quat Normalize(const quat& q)
+	{
+		const float inv = 1.0f / std::sqrt(Dot(q, q));
+		return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+	}
+
+	// rotates v by the unit quaternion q
+	constexpr vec3 Rotate(const quat& q, const vec3& v)
+	{
+		const vec3 u = q.xyz();
+		const vec3 t = 2.0f * Cross(u, v);
+		return v + q.w * t + Cross(u, t);
+	}
+
+	// spherical interpolation along the shortest arc
+	quat Slerp(const quat& a, const quat& b, float t);
+}
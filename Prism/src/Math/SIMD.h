@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * Compile-time SIMD feature selection for the math kernels
+ *
+ * SSE2 is the baseline on x64, AVX2 kernels are enabled when compiling
+ * with AVX2 support (premake5 --avx2, /arch:AVX2 or -mavx2).
+ * Define PR_SIMD_DISABLE to force the scalar fallbacks.
+ */
+#if !defined(PR_SIMD_DISABLE)
+	#if defined(__AVX2__)
+		#define PR_SIMD_AVX2
+	#endif
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define PR_SIMD_SSE
+	#endif
+#endif
+
+#if defined(PR_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(PR_SIMD_SSE)
+#include <emmintrin.h>
+#endif
+
+// number of floats processed per instruction by the widest enabled kernels
+#if defined(PR_SIMD_AVX2)
+#define PR_SIMD_WIDTH 8
+#elif defined(PR_SIMD_SSE)
+#define PR_SIMD_WIDTH 4
+#else
+#define PR_SIMD_WIDTH 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <cstdint>
+
+namespace Prism {
+
+	// index of the lowest set bit, mask must not be 0
+	inline uint32_t LowestBitIndex(uint32_t mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+namespace Prism {
+
+	struct vec2 {
+		float x = 0.0f, y = 0.0f;
+
+		constexpr vec2() = default;
+		constexpr explicit vec2(float s) : x(s), y(s) {}
+		constexpr vec2(float x, float y) : x(x), y(y) {}
+
+		float& operator[](int i) { return (&x)[i]; }
+		const float& operator[](int i) const { return (&x)[i]; }
+	};
+
+	struct vec3 {
+		float x = 0.0f, y = 0.0f, z = 0.0f;
+
+		constexpr vec3() = default;
+		constexpr explicit vec3(float s) : x(s), y(s), z(s) {}
+		constexpr vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+		constexpr vec3(const vec2& v, float z) : x(v.x), y(v.y), z(z) {}
+
+		float& operator[](int i) { return (&x)[i]; }
+		const float& operator[](int i) const { return (&x)[i]; }
+	};
+
+	// 16 byte aligned to be loaded directly into SSE registers
+	struct alignas(16) vec4 {
+		float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+
+		constexpr vec4() = default;
+		constexpr explicit vec4(float s) : x(s), y(s), z(s), w(s) {}
+		constexpr vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+		constexpr vec4(const vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+		constexpr vec3 xyz() const { return { x, y, z }; }
+
+		float& operator[](int i) { return (&x)[i]; }
+		const float& operator[](int i) const { return (&x)[i]; }
+	};
+
+	// component-wise operators
+#define PR_VEC_OPERATORS(type, components)\
+	constexpr type operator+(const type& a, const type& b) { return { components(+) }; }\
+	constexpr type operator-(const type& a, const type& b) { return { components(-) }; }\
+	constexpr type operator*(const type& a, const type& b) { return { components(*) }; }\
+	constexpr type operator/(const type& a, const type& b) { return { components(/) }; }\
+	constexpr type operator*(const type& a, float s) { return a * type(s); }\
+	constexpr type operator*(float s, const type& a) { return a * type(s); }\
+	constexpr type operator/(const type& a, float s) { return a * type(1.0f / s); }\
+	constexpr type operator-(const type& a) { return type(0.0f) - a; }\
+	constexpr type& operator+=(type& a, const type& b) { return a = a + b; }\
+	constexpr type& operator-=(type& a, const type& b) { return a = a - b; }\
+	constexpr type& operator*=(type& a, const type& b) { return a = a * b; }\
+	constexpr type& operator*=(type& a, float s) { return a = a * s; }\
+	constexpr type& operator/=(type& a, float s) { return a = a / s; }
+
+#define PR_VEC2_OP(op) a.x op b.x, a.y op b.y
+#define PR_VEC3_OP(op) a.x op b.x, a.y op b.y, a.z op b.z
+#define PR_VEC4_OP(op) a.x op b.x, a.y op b.y, a.z op b.z, a.w op b.w
+
+	PR_VEC_OPERATORS(vec2, PR_VEC2_OP)
+	PR_VEC_OPERATORS(vec3, PR_VEC3_OP)
+	PR_VEC_OPERATORS(vec4, PR_VEC4_OP)
+
+#undef PR_VEC2_OP
+#undef PR_VEC3_OP
+#undef PR_VEC4_OP
+#undef PR_VEC_OPERATORS
+
+	constexpr bool operator==(const vec2& a, const vec2& b) { return a.x == b.x && a.y == b.y; }
+	constexpr bool operator==(const vec3& a, const vec3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+	constexpr bool operator==(const vec4& a, const vec4& b) { return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w; }
+	constexpr bool operator!=(const vec2& a, const vec2& b) { return !(a == b); }
+	constexpr bool operator!=(const vec3& a, const vec3& b) { return !(a == b); }
+	constexpr bool operator!=(const vec4& a, const vec4& b) { return !(a == b); }
+
+	constexpr float Dot(const vec2& a, const vec2& b) { return a.x * b.x + a.y * b.y; }
+	constexpr float Dot(const vec3& a, const vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	constexpr float Dot(const vec4& a, const vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+	constexpr vec3 Cross(const vec3& a, const vec3& b)
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	template<typename V> constexpr float LengthSquared(const V& v) { return Dot(v, v); }
+	template<typename V> inline float Length(const V& v) { return std::sqrt(Dot(v, v)); }
+	template<typename V> inline V Normalize(const V& v) { return v * (1.0f / Length(v)); }
+	template<typename V> constexpr V Lerp(const V& a, const V& b, float t) { return a + (b - a) * t; }
+
+	inline vec3 Min(const vec3& a, const vec3& b) { return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) }; }
+	inline vec3 Max(const vec3& a, const vec3& b) { return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) }; }
+	inline vec3 Abs(const vec3& v) { return { std::abs(v.x), std::abs(v.y), std::abs(v.z) }; }
+	inline vec4 Min(const vec4& a, const vec4& b) { return { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z), std::min(a.w, b.w) }; }
+	inline vec4 Max(const vec4& a, const vec4& b) { return { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w) }; }
+}
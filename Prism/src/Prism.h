@@ -2,8 +2,13 @@
 
 #include "Core/Application.h"
 #include "Core/TaskSystem/TaskSystem.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Math/Math.h"
 
+#include "Util/FileReader/FileReader.h"
 #include "Util/Log/Log.h"
+#include "Util/Profiler/Profiler.h"
 
 /** 
  * Client must implement a derived class of Prism::Application and use this Macro to
@@ -18,7 +23,10 @@ extern Prism::Application* Prism::CreateApplication();
 int main(int argc, char** argv)
 {
 	Prism::Log::Init();
+	// formatting and sink I/O happen on the log thread from here on
+	Prism::Log::StartAsync();
 	Prism::TaskSystem::Init();
+	Prism::FileReader::Init();
 
 	PR_CORE_INFO("Creating Application");
 	Prism::Application* app = Prism::CreateApplication();
@@ -28,6 +36,8 @@ int main(int argc, char** argv)
 	app->Run();
 	PR_CORE_INFO("Closing Application...");
 
+	// reads still in flight complete, their callbacks may use the app
+	Prism::FileReader::Shutdown();
 
 	// other threads may still be running tasks...
 	Prism::TaskSystem::Wait();
@@ -36,5 +46,7 @@ int main(int argc, char** argv)
 
 	// deconstruction may have started new tasks...
 	Prism::TaskSystem::Finish();
+
+	Prism::Log::StopAsync();
 	return 0;
 }
\ No newline at end of file
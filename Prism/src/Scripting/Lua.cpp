@@ -3,13 +3,37 @@
 #include "LuaUtil.h"
 #include "LuaBase.h"
 
+#include "Core/Memory/MemoryTracker.h"
+#include "Util/FileSystem/VirtualFileSystem.h"
+
+#include <cstdlib>
+
 namespace Prism {
 
 #define L (lua_State*)m_Instance
 
+	// lua_Alloc counting into MemoryTag::Lua (osize is the old block size if ptr is set)
+	static void* luaAllocate(void*, void* ptr, size_t osize, size_t nsize)
+	{
+		if (nsize == 0)
+		{
+			if (ptr) MemoryTracker::TrackFree(MemoryTag::Lua, osize);
+			std::free(ptr);
+			return nullptr;
+		}
+
+		void* result = std::realloc(ptr, nsize);
+		if (result)
+		{
+			if (ptr) MemoryTracker::TrackFree(MemoryTag::Lua, osize);
+			MemoryTracker::TrackAllocation(MemoryTag::Lua, nsize);
+		}
+		return result;
+	}
+
 	Lua::Lua()
 	{
-		m_Instance = (void*)luaL_newstate();
+		m_Instance = (void*)lua_newstate(luaAllocate, nullptr);
 
 		lua_gc(L, LUA_GCSTOP, 0);
 		luaL_openlibs(L);
@@ -31,7 +55,13 @@ namespace Prism {
 
 	bool Lua::ExecuteFile(const std::string& file)
 	{
-		if (checkLua(L, luaL_dofile(L, file.c_str())))
+		auto script = VirtualFileSystem::Open(file);
+		if (!script)
+			return false;
+
+		// like luaL_dofile, "@" marks the chunk name as a file name in error messages
+		const std::string chunkName = "@" + file;
+		if (checkLua(L, luaL_loadbuffer(L, script->GetData(), script->GetSize(), chunkName.c_str()) || lua_pcall(L, 0, LUA_MULTRET, 0)))
 			return true;
 		else
 			return false;
@@ -0,0 +1,279 @@
+#include "BroadphaseSystem.h"
+#include "TransformSystem.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <limits>
+#include <iterator>
+
+namespace Prism {
+
+	// bodies swept per task
+	constexpr uint32_t c_SweepBatchSize = 2048;
+	// sentinel bodies appended to the sorted arrays, so SIMD loads never run past the end
+	constexpr uint32_t c_Padding = PR_SIMD_WIDTH;
+
+	void BroadphaseSystem::Add(Entity* entity)
+	{
+		const Bounds* bounds = entity->components.Find<Bounds>();
+		if (!bounds)
+		{
+			PR_ECS_WARN("Entity {0} has no Bounds, not added to BroadphaseSystem", entity->id);
+			return;
+		}
+		push(entity->id, bounds->box, entity->components.Find<Transform>() != nullptr);
+	}
+
+	void BroadphaseSystem::Add(World& world, const World::EntityRange& range)
+	{
+		const Bounds* bounds = world.GetColumn<Bounds>(range);
+		if (!bounds)
+		{
+			PR_ECS_WARN("Prefab has no Bounds, entities not added to BroadphaseSystem");
+			return;
+		}
+
+		const bool transformed = world.GetColumn<Transform>(range) != nullptr;
+		for (uint32_t i = 0; i < range.count; ++i)
+			push(range.first + i, bounds[i].box, transformed);
+	}
+
+	void BroadphaseSystem::push(EntityID entity, const AABB& box, bool transformed)
+	{
+		const uint32_t index = static_cast<uint32_t>(m_Entities.size());
+		m_Entities.push_back(entity);
+		m_Local.push_back(box);
+		m_Transformed.push_back(transformed);
+		m_Index.emplace(entity, index);
+		m_Pending.push_back(index);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			m_Min[axis].push_back(box.min[axis]);
+			m_Max[axis].push_back(box.max[axis]);
+		}
+
+		// new bodies go to the end of the order, the insertion sort moves them into place
+		if (m_Axis >= 0) m_Order.push_back(index);
+	}
+
+	void BroadphaseSystem::Remove(EntityID entity)
+	{
+		auto itr = m_Index.find(entity);
+		if (itr == m_Index.end())
+		{
+			PR_ECS_WARN("Entity {0} not found in BroadphaseSystem", entity);
+			return;
+		}
+
+		const uint32_t index = itr->second;
+		const uint32_t last = static_cast<uint32_t>(m_Entities.size() - 1);
+		m_Index.erase(itr);
+		m_Pending.erase(std::remove(m_Pending.begin(), m_Pending.end(), index), m_Pending.end());
+		std::replace(m_Pending.begin(), m_Pending.end(), last, index);
+
+		// swap with the last body
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			m_Min[axis][index] = m_Min[axis].back(); m_Min[axis].pop_back();
+			m_Max[axis][index] = m_Max[axis].back(); m_Max[axis].pop_back();
+		}
+		m_Local[index] = m_Local.back(); m_Local.pop_back();
+		m_Transformed[index] = m_Transformed.back(); m_Transformed.pop_back();
+		m_Entities[index] = m_Entities.back(); m_Entities.pop_back();
+		if (index != last) m_Index[m_Entities[index]] = index;
+
+		// keep the order of the remaining bodies
+		m_Order.erase(std::remove(m_Order.begin(), m_Order.end(), index), m_Order.end());
+		std::replace(m_Order.begin(), m_Order.end(), last, index);
+	}
+
+	void BroadphaseSystem::Update(const TransformSystem& transforms)
+	{
+		PR_PROFILE_FUNCTION();
+		for (uint32_t index : m_Pending)
+			if (m_Transformed[index])
+				setWorldBounds(index, TransformBounds(transforms.GetWorldMatrix(m_Entities[index]), m_Local[index]));
+		m_Pending.clear();
+
+		const mat4* matrices = transforms.GetWorldMatrices();
+		const EntityID* entities = transforms.GetEntities();
+		for (uint32_t changed : transforms.GetChanged())
+		{
+			auto itr = m_Index.find(entities[changed]);
+			if (itr != m_Index.end())
+				setWorldBounds(itr->second, TransformBounds(matrices[changed], m_Local[itr->second]));
+		}
+	}
+
+	void BroadphaseSystem::setWorldBounds(uint32_t index, const AABB& box)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			m_Min[axis][index] = box.min[axis];
+			m_Max[axis][index] = box.max[axis];
+		}
+	}
+
+	int BroadphaseSystem::selectAxis() const
+	{
+		// axis with the largest variance of the body centers
+		const size_t count = m_Entities.size();
+		float variance[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			double sum = 0.0, sumSq = 0.0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				const double c = 0.5 * (double(m_Min[axis][i]) + double(m_Max[axis][i]));
+				sum += c; sumSq += c * c;
+			}
+			variance[axis] = count > 0 ? float(sumSq / count - (sum / count) * (sum / count)) : 0.0f;
+		}
+		return variance[0] > variance[1] ? (variance[0] > variance[2] ? 0 : 2) : (variance[1] > variance[2] ? 1 : 2);
+	}
+
+	void BroadphaseSystem::sortBodies(int axis)
+	{
+		const std::vector<float>& key = m_Min[axis];
+		if (axis != m_Axis || m_Order.size() != m_Entities.size())
+		{
+			// axis changed (or first frame): full sort
+			m_Order.resize(m_Entities.size());
+			for (uint32_t i = 0; i < m_Order.size(); ++i)
+				m_Order[i] = i;
+			std::sort(m_Order.begin(), m_Order.end(), [&](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+			m_Axis = axis;
+		}
+		else
+		{
+			// order of the last frame is nearly sorted: insertion sort
+			for (size_t i = 1; i < m_Order.size(); ++i)
+			{
+				const uint32_t body = m_Order[i];
+				const float value = key[body];
+				size_t j = i;
+				for (; j > 0 && key[m_Order[j - 1]] > value; --j)
+					m_Order[j] = m_Order[j - 1];
+				m_Order[j] = body;
+			}
+		}
+
+		// gather the bounds in sorted order, padded with sentinels that never overlap
+		// (NaN compares false, even against infinite bounds)
+		const size_t count = m_Order.size();
+		const float sentinel = std::numeric_limits<float>::quiet_NaN();
+		for (int a = 0; a < 3; ++a)
+		{
+			m_SortedMin[a].resize(count + c_Padding);
+			m_SortedMax[a].resize(count + c_Padding);
+			for (size_t i = 0; i < count; ++i)
+			{
+				m_SortedMin[a][i] = m_Min[a][m_Order[i]];
+				m_SortedMax[a][i] = m_Max[a][m_Order[i]];
+			}
+			std::fill(m_SortedMin[a].begin() + count, m_SortedMin[a].end(), sentinel);
+			std::fill(m_SortedMax[a].begin() + count, m_SortedMax[a].end(), sentinel);
+		}
+	}
+
+	static BroadphaseSystem::Pair makePair(EntityID a, EntityID b)
+	{
+		return a < b ? BroadphaseSystem::Pair{ a, b } : BroadphaseSystem::Pair{ b, a };
+	}
+
+#if defined(PR_SIMD_AVX2)
+	using simd_t = __m256;
+#define PR_SIMD_SET1 _mm256_set1_ps
+#define PR_SIMD_LOAD _mm256_loadu_ps
+#define PR_SIMD_AND _mm256_and_ps
+#define PR_SIMD_CMPLE(a, b) _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define PR_SIMD_MOVEMASK _mm256_movemask_ps
+#elif defined(PR_SIMD_SSE)
+	using simd_t = __m128;
+#define PR_SIMD_SET1 _mm_set1_ps
+#define PR_SIMD_LOAD _mm_loadu_ps
+#define PR_SIMD_AND _mm_and_ps
+#define PR_SIMD_CMPLE(a, b) _mm_cmple_ps(a, b)
+#define PR_SIMD_MOVEMASK _mm_movemask_ps
+#endif
+
+	void BroadphaseSystem::sweep(uint32_t begin, uint32_t end, std::vector<Pair>& pairs) const
+	{
+		const int s = m_Axis, b = (m_Axis + 1) % 3, c = (m_Axis + 2) % 3;
+		const float* sweepMin = m_SortedMin[s].data();
+		const float* minB = m_SortedMin[b].data();
+		const float* maxB = m_SortedMax[b].data();
+		const float* minC = m_SortedMin[c].data();
+		const float* maxC = m_SortedMax[c].data();
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			const float maxS = m_SortedMax[s][i];
+			const EntityID entity = m_Entities[m_Order[i]];
+			uint32_t j = i + 1;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+			const simd_t vMaxS = PR_SIMD_SET1(maxS);
+			const simd_t vMinB = PR_SIMD_SET1(minB[i]), vMaxB = PR_SIMD_SET1(maxB[i]);
+			const simd_t vMinC = PR_SIMD_SET1(minC[i]), vMaxC = PR_SIMD_SET1(maxC[i]);
+			constexpr uint32_t full = (1u << PR_SIMD_WIDTH) - 1;
+
+			// candidates start before i ends on the sweep axis, sentinels end the loop
+			while (true)
+			{
+				const simd_t active = PR_SIMD_CMPLE(PR_SIMD_LOAD(sweepMin + j), vMaxS);
+				const simd_t overlapB = PR_SIMD_AND(PR_SIMD_CMPLE(PR_SIMD_LOAD(minB + j), vMaxB), PR_SIMD_CMPLE(vMinB, PR_SIMD_LOAD(maxB + j)));
+				const simd_t overlapC = PR_SIMD_AND(PR_SIMD_CMPLE(PR_SIMD_LOAD(minC + j), vMaxC), PR_SIMD_CMPLE(vMinC, PR_SIMD_LOAD(maxC + j)));
+
+				const uint32_t activeMask = static_cast<uint32_t>(PR_SIMD_MOVEMASK(active));
+				uint32_t mask = static_cast<uint32_t>(PR_SIMD_MOVEMASK(PR_SIMD_AND(active, PR_SIMD_AND(overlapB, overlapC))));
+				while (mask)
+				{
+					const uint32_t other = j + LowestBitIndex(mask);
+					pairs.push_back(makePair(entity, m_Entities[m_Order[other]]));
+					mask &= mask - 1;
+				}
+
+				if (activeMask != full) break; // sorted: all following bodies start later
+				j += PR_SIMD_WIDTH;
+			}
+#else
+			for (; j < m_Order.size() && sweepMin[j] <= maxS; ++j)
+				if (minB[j] <= maxB[i] && minB[i] <= maxB[j] && minC[j] <= maxC[i] && minC[i] <= maxC[j])
+					pairs.push_back(makePair(entity, m_Entities[m_Order[j]]));
+#endif
+		}
+	}
+
+	void BroadphaseSystem::FindPairs()
+	{
+		sortBodies(selectAxis());
+
+		const uint32_t count = static_cast<uint32_t>(m_Order.size());
+		const uint32_t batches = (count + c_SweepBatchSize - 1) / c_SweepBatchSize;
+		m_BatchPairs.resize(batches);
+
+		TaskSystem::ParallelFor(count, c_SweepBatchSize, [&](uint32_t begin, uint32_t end)
+			{
+				auto& pairs = m_BatchPairs[begin / c_SweepBatchSize];
+				pairs.clear();
+				sweep(begin, end, pairs);
+			});
+
+		std::vector<Pair> pairs;
+		size_t total = 0;
+		for (const auto& batch : m_BatchPairs) total += batch.size();
+		pairs.reserve(total);
+		for (const auto& batch : m_BatchPairs)
+			pairs.insert(pairs.end(), batch.begin(), batch.end());
+		std::sort(pairs.begin(), pairs.end());
+
+		// deltas against the pairs of the last frame, the previous frame's lists are in reset frame memory
+		m_Added = FrameVector<Pair>();
+		m_Removed = FrameVector<Pair>();
+		std::set_difference(pairs.begin(), pairs.end(), m_Pairs.begin(), m_Pairs.end(), std::back_inserter(m_Added));
+		std::set_difference(m_Pairs.begin(), m_Pairs.end(), pairs.begin(), pairs.end(), std::back_inserter(m_Removed));
+		m_Pairs.swap(pairs);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "System.h"
+#include "Components/Bounds.h"
+#include "Entities/World.h"
+#include "Core/Memory/FrameAllocator.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace Prism {
+
+	class TransformSystem;
+
+	/**
+	 * Broadphase collision detection (sweep and prune)
+	 *
+	 * Bodies are kept sorted along the axis with the largest spread of their
+	 * centers. The order persists between frames and is repaired with an
+	 * insertion sort, which is close to linear for coherent motion.
+	 * The sweep runs in parallel on the TaskSystem and tests the two other
+	 * axes with SIMD. The overlap pairs are kept between frames so the
+	 * added/removed pairs can be reported as deltas.
+	 */
+	class BroadphaseSystem : public System {
+	public:
+		struct Pair {
+			EntityID a, b; // a < b
+
+			bool operator==(const Pair& o) const { return a == o.a && b == o.b; }
+			bool operator<(const Pair& o) const { return a < o.a || (a == o.a && b < o.b); }
+		};
+
+		void Add(Entity* entity);
+		void Add(World& world, const World::EntityRange& range);
+		void Remove(EntityID entity);
+
+		// pulls world bounds of moved entities (must be called after TransformSystem::Update)
+		void Update(const TransformSystem& transforms);
+
+		// sorts, sweeps and computes the pair deltas
+		void FindPairs();
+
+		// all overlapping pairs, sorted
+		const std::vector<Pair>& GetPairs() const { return m_Pairs; }
+		// pairs that started / stopped overlapping in the last FindPairs, frame memory (valid until the next frame)
+		const FrameVector<Pair>& GetAddedPairs() const { return m_Added; }
+		const FrameVector<Pair>& GetRemovedPairs() const { return m_Removed; }
+
+		size_t GetSize() const { return m_Entities.size(); }
+
+	private:
+		void push(EntityID entity, const AABB& box, bool transformed);
+		void setWorldBounds(uint32_t index, const AABB& box);
+		int selectAxis() const;
+		void sortBodies(int axis);
+		void sweep(uint32_t begin, uint32_t end, std::vector<Pair>& pairs) const;
+
+	private:
+		// SoA world bounds per body
+		std::vector<float> m_Min[3], m_Max[3];
+		std::vector<EntityID> m_Entities;
+		std::vector<AABB> m_Local;
+		std::vector<uint8_t> m_Transformed;
+		std::unordered_map<EntityID, uint32_t> m_Index;
+		std::vector<uint32_t> m_Pending; // not yet transformed to world space
+
+		// persistent sort order along m_Axis, plus padded copies of the bounds in that order
+		int m_Axis = -1;
+		std::vector<uint32_t> m_Order;
+		std::vector<float> m_SortedMin[3], m_SortedMax[3];
+
+		std::vector<std::vector<Pair>> m_BatchPairs;
+		std::vector<Pair> m_Pairs;
+		FrameVector<Pair> m_Added, m_Removed;
+	};
+}
@@ -0,0 +1,159 @@
+#include "CullingSystem.h"
+#include "TransformSystem.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+
+namespace Prism {
+
+	// bounds per task, multiple of the SIMD width
+	constexpr uint32_t c_ChunkSize = 4096;
+
+	void CullingSystem::Add(Entity* entity)
+	{
+		const Bounds* bounds = entity->components.Find<Bounds>();
+		if (!bounds)
+		{
+			PR_ECS_WARN("Entity {0} has no Bounds, not added to CullingSystem", entity->id);
+			return;
+		}
+		push(entity->id, bounds->box, entity->components.Find<Transform>() != nullptr);
+	}
+
+	void CullingSystem::Add(World& world, const World::EntityRange& range)
+	{
+		const Bounds* bounds = world.GetColumn<Bounds>(range);
+		if (!bounds)
+		{
+			PR_ECS_WARN("Prefab has no Bounds, entities not added to CullingSystem");
+			return;
+		}
+
+		const bool transformed = world.GetColumn<Transform>(range) != nullptr;
+		for (uint32_t i = 0; i < range.count; ++i)
+			push(range.first + i, bounds[i].box, transformed);
+	}
+
+	void CullingSystem::push(EntityID entity, const AABB& box, bool transformed)
+	{
+		const uint32_t index = static_cast<uint32_t>(m_Entities.size());
+		m_Entities.push_back(entity);
+		m_Local.push_back({ box, transformed });
+		m_Index.emplace(entity, index);
+		m_Added.push_back(index);
+
+		for (auto* v : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+			v->push_back(0.0f);
+		setWorldBounds(index, mat4{});
+	}
+
+	void CullingSystem::Remove(EntityID entity)
+	{
+		auto itr = m_Index.find(entity);
+		if (itr == m_Index.end())
+		{
+			PR_ECS_WARN("Entity {0} not found in CullingSystem", entity);
+			return;
+		}
+
+		// swap with the last element in every array
+		const uint32_t index = itr->second;
+		const uint32_t last = static_cast<uint32_t>(m_Entities.size() - 1);
+		m_Index.erase(itr);
+		m_Added.erase(std::remove(m_Added.begin(), m_Added.end(), index), m_Added.end());
+		std::replace(m_Added.begin(), m_Added.end(), last, index);
+
+		for (auto* v : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_Radius, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+		{
+			(*v)[index] = v->back();
+			v->pop_back();
+		}
+		m_Local[index] = m_Local.back();
+		m_Local.pop_back();
+		m_Entities[index] = m_Entities.back();
+		m_Entities.pop_back();
+		if (index != last) m_Index[m_Entities[index]] = index;
+	}
+
+	void CullingSystem::Update(const TransformSystem& transforms)
+	{
+		PR_PROFILE_FUNCTION();
+		for (uint32_t index : m_Added)
+			if (m_Local[index].transformed)
+				setWorldBounds(index, transforms.GetWorldMatrix(m_Entities[index]));
+		m_Added.clear();
+
+		const mat4* matrices = transforms.GetWorldMatrices();
+		const EntityID* entities = transforms.GetEntities();
+		for (uint32_t changed : transforms.GetChanged())
+		{
+			auto itr = m_Index.find(entities[changed]);
+			if (itr != m_Index.end())
+				setWorldBounds(itr->second, matrices[changed]);
+		}
+	}
+
+	void CullingSystem::setWorldBounds(uint32_t index, const mat4& world)
+	{
+		const AABB& local = m_Local[index].box;
+		const AABB box = TransformBounds(world, local);
+		const vec3 center = box.Center();
+		const vec3 extents = box.Extents();
+
+		// sphere around the local box, rotation invariant (tighter than the box for rotated objects)
+		const float scale = std::sqrt(std::max({ LengthSquared(world[0].xyz()), LengthSquared(world[1].xyz()), LengthSquared(world[2].xyz()) }));
+
+		m_CenterX[index] = center.x;
+		m_CenterY[index] = center.y;
+		m_CenterZ[index] = center.z;
+		m_Radius[index] = Length(local.Extents()) * scale;
+		m_ExtentX[index] = extents.x;
+		m_ExtentY[index] = extents.y;
+		m_ExtentZ[index] = extents.z;
+	}
+
+	BoundsSoA CullingSystem::GetBounds() const
+	{
+		return {
+			m_CenterX.data(), m_CenterY.data(), m_CenterZ.data(), m_Radius.data(),
+			m_ExtentX.data(), m_ExtentY.data(), m_ExtentZ.data() };
+	}
+
+	const FrameVector<EntityID>& CullingSystem::Cull(const mat4& viewProjection)
+	{
+		PR_PROFILE_FUNCTION();
+		const Frustum frustum(viewProjection);
+		const BoundsSoA bounds = GetBounds();
+
+		const uint32_t count = static_cast<uint32_t>(m_Entities.size());
+		const uint32_t chunks = (count + c_ChunkSize - 1) / c_ChunkSize;
+		FrameVector<uint32_t> chunkVisible(count);
+		FrameVector<uint32_t> chunkCounts(chunks, 0);
+
+		// each chunk writes its visible indices into its own slice
+		TaskSystem::ParallelFor(count, c_ChunkSize, [&](uint32_t begin, uint32_t end)
+			{
+				chunkCounts[begin / c_ChunkSize] = CullBounds(frustum, bounds, begin, end, chunkVisible.data() + begin);
+			});
+
+		// then compacted, the last results are in reset frame memory by now
+		size_t visible = 0;
+		for (uint32_t chunkCount : chunkCounts) visible += chunkCount;
+		m_VisibleIndices = FrameVector<uint32_t>();
+		m_Visible = FrameVector<EntityID>();
+		m_VisibleIndices.reserve(visible);
+		m_Visible.reserve(visible);
+		for (uint32_t chunk = 0; chunk < chunks; ++chunk)
+		{
+			const uint32_t* indices = chunkVisible.data() + chunk * c_ChunkSize;
+			for (uint32_t i = 0; i < chunkCounts[chunk]; ++i)
+			{
+				m_VisibleIndices.push_back(indices[i]);
+				m_Visible.push_back(m_Entities[indices[i]]);
+			}
+		}
+		return m_Visible;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "System.h"
+#include "Components/Bounds.h"
+#include "Entities/World.h"
+#include "Math/Frustum.h"
+#include "Core/Memory/FrameAllocator.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace Prism {
+
+	class TransformSystem;
+
+	/**
+	 * CPU visibility stage: culls the bounds of all registered entities
+	 * against the camera frustum
+	 *
+	 * World bounds are kept SoA (center, sphere radius, box extents) and tested
+	 * chunk-parallel with the SIMD kernels from Math/Frustum.h.
+	 * The visible list is for the caller to draw from (the Renderer doesn't
+	 * record entity draws yet). It lives in frame memory and is valid until
+	 * the next FrameAllocator::NewFrame.
+	 */
+	class CullingSystem : public System {
+	public:
+		void Add(Entity* entity);
+		void Add(World& world, const World::EntityRange& range);
+		void Remove(EntityID entity);
+
+		// pulls world bounds of moved entities (must be called after TransformSystem::Update)
+		void Update(const TransformSystem& transforms);
+
+		// culls all entities, returns the visible ones
+		const FrameVector<EntityID>& Cull(const mat4& viewProjection);
+
+		const FrameVector<EntityID>& GetVisible() const { return m_Visible; }
+		// indices into the SoA bounds of the visible entities
+		const FrameVector<uint32_t>& GetVisibleIndices() const { return m_VisibleIndices; }
+
+		BoundsSoA GetBounds() const;
+		const EntityID* GetEntities() const { return m_Entities.data(); }
+		size_t GetSize() const { return m_Entities.size(); }
+
+	private:
+		struct Local {
+			AABB box;
+			bool transformed;
+		};
+		void setWorldBounds(uint32_t index, const mat4& world);
+		void push(EntityID entity, const AABB& box, bool transformed);
+
+	private:
+		// SoA world bounds
+		std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+		std::vector<float> m_Radius;
+		std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+
+		std::vector<EntityID> m_Entities;
+		std::vector<Local> m_Local;
+		std::unordered_map<EntityID, uint32_t> m_Index;
+		std::vector<uint32_t> m_Added; // not yet transformed to world space
+
+		// results of the last Cull
+		FrameVector<uint32_t> m_VisibleIndices;
+		FrameVector<EntityID> m_Visible;
+	};
+}
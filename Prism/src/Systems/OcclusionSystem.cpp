@@ -0,0 +1,267 @@
+#include "OcclusionSystem.h"
+#include "CullingSystem.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Prism {
+
+	// rows per rasterisation task (tasks never write the same rows)
+	constexpr uint32_t c_BandHeight = 16;
+	// bounds per occlusion test task
+	constexpr uint32_t c_TestBatchSize = 1024;
+	// clip space w below which a vertex counts as behind the near plane
+	constexpr float c_MinW = 1e-5f;
+
+	static_assert(OcclusionSystem::Width % 8 == 0, "Width must be a multiple of the SIMD width.");
+
+	OcclusionSystem::OcclusionSystem()
+	{
+		for (uint32_t w = Width, h = Height; w > 0 && h > 0; w /= 2, h /= 2)
+			m_Levels.emplace_back(size_t(w) * h, 1.0f);
+	}
+
+	void OcclusionSystem::AddOccluder(const OccluderMesh& mesh, const mat4& world)
+	{
+		const uint32_t offset = static_cast<uint32_t>(m_Vertices.size());
+		for (const auto& v : mesh.vertices)
+			m_Vertices.push_back(TransformPoint(world, v));
+		for (uint32_t index : mesh.indices)
+			m_Indices.push_back(offset + index);
+	}
+
+	void OcclusionSystem::ClearOccluders()
+	{
+		m_Vertices.clear();
+		m_Indices.clear();
+	}
+
+	void OcclusionSystem::RenderOccluders(const mat4& viewProjection)
+	{
+		PR_PROFILE_FUNCTION();
+		m_ViewProjection = viewProjection;
+
+		// project all occluder vertices once
+		m_ScreenVertices.resize(m_Vertices.size());
+		for (size_t i = 0; i < m_Vertices.size(); ++i)
+		{
+			const vec4 clip = viewProjection * vec4(m_Vertices[i], 1.0f);
+			if (clip.w < c_MinW)
+			{
+				m_ScreenVertices[i] = { 0.0f, 0.0f, 0.0f, -1.0f };
+				continue;
+			}
+			const float invW = 1.0f / clip.w;
+			m_ScreenVertices[i] = {
+				(clip.x * invW * 0.5f + 0.5f) * Width,
+				(clip.y * invW * 0.5f + 0.5f) * Height,
+				clip.z * invW, 1.0f };
+		}
+
+		std::fill(m_Levels[0].begin(), m_Levels[0].end(), 1.0f);
+		TaskSystem::ParallelFor(Height, c_BandHeight, [&](uint32_t begin, uint32_t end) { rasterize(begin, end); });
+		buildHiZ();
+
+		m_Stats = {};
+		m_Stats.occluderTriangles = static_cast<uint32_t>(m_Indices.size() / 3);
+	}
+
+#if defined(PR_SIMD_AVX2)
+	using simd_t = __m256;
+#define PR_SIMD_SET1 _mm256_set1_ps
+#define PR_SIMD_LOAD _mm256_loadu_ps
+#define PR_SIMD_STORE _mm256_storeu_ps
+#define PR_SIMD_ADD _mm256_add_ps
+#define PR_SIMD_MUL _mm256_mul_ps
+#define PR_SIMD_MIN _mm256_min_ps
+#define PR_SIMD_AND _mm256_and_ps
+#define PR_SIMD_CMPGE(a, b) _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define PR_SIMD_SELECT(mask, a, b) _mm256_blendv_ps(b, a, mask)
+#define PR_SIMD_LANES _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f)
+#elif defined(PR_SIMD_SSE)
+	using simd_t = __m128;
+#define PR_SIMD_SET1 _mm_set1_ps
+#define PR_SIMD_LOAD _mm_loadu_ps
+#define PR_SIMD_STORE _mm_storeu_ps
+#define PR_SIMD_ADD _mm_add_ps
+#define PR_SIMD_MUL _mm_mul_ps
+#define PR_SIMD_MIN _mm_min_ps
+#define PR_SIMD_AND _mm_and_ps
+#define PR_SIMD_CMPGE(a, b) _mm_cmpge_ps(a, b)
+#define PR_SIMD_SELECT(mask, a, b) _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b))
+#define PR_SIMD_LANES _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f)
+#endif
+
+	void OcclusionSystem::rasterize(uint32_t rowBegin, uint32_t rowEnd)
+	{
+		float* depth = m_Levels[0].data();
+
+		for (size_t t = 0; t + 2 < m_Indices.size(); t += 3)
+		{
+			const vec4& v0 = m_ScreenVertices[m_Indices[t]];
+			const vec4& v1 = m_ScreenVertices[m_Indices[t + 1]];
+			const vec4& v2 = m_ScreenVertices[m_Indices[t + 2]];
+
+			// triangles crossing the near plane are skipped (conservative: less occlusion)
+			if (v0.w < 0.0f || v1.w < 0.0f || v2.w < 0.0f) continue;
+
+			// bounding rectangle within this band
+			const int x0 = std::max(0, int(std::floor(std::min({ v0.x, v1.x, v2.x }))));
+			const int x1 = std::min(int(Width) - 1, int(std::ceil(std::max({ v0.x, v1.x, v2.x }))));
+			const int y0 = std::max(int(rowBegin), int(std::floor(std::min({ v0.y, v1.y, v2.y }))));
+			const int y1 = std::min(int(rowEnd) - 1, int(std::ceil(std::max({ v0.y, v1.y, v2.y }))));
+			if (x0 > x1 || y0 > y1) continue;
+
+			// edge functions E_i(x, y) = A_i * x + B_i * y + C_i, E_i is the weight of vertex i
+			float A[3] = { v1.y - v2.y, v2.y - v0.y, v0.y - v1.y };
+			float B[3] = { v2.x - v1.x, v0.x - v2.x, v1.x - v0.x };
+			float C[3] = { -(A[0] * v1.x + B[0] * v1.y), -(A[1] * v2.x + B[1] * v2.y), -(A[2] * v0.x + B[2] * v0.y) };
+
+			float area = C[0] + C[1] + C[2]; // sum of the edge functions (constant)
+			if (std::abs(area) < 1e-6f) continue;
+			if (area < 0.0f)
+			{
+				for (int i = 0; i < 3; ++i) { A[i] = -A[i]; B[i] = -B[i]; C[i] = -C[i]; }
+				area = -area;
+			}
+
+			// depth plane z(x, y) = zA * x + zB * y + zC
+			const float invArea = 1.0f / area;
+			const float zA = (A[0] * v0.z + A[1] * v1.z + A[2] * v2.z) * invArea;
+			const float zB = (B[0] * v0.z + B[1] * v1.z + B[2] * v2.z) * invArea;
+			const float zC = (C[0] * v0.z + C[1] * v1.z + C[2] * v2.z) * invArea;
+
+			const int xStart = x0 - x0 % PR_SIMD_WIDTH;
+			for (int y = y0; y <= y1; ++y)
+			{
+				const float py = float(y) + 0.5f;
+				float* row = depth + size_t(y) * Width;
+				int x = xStart;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+				const simd_t lanes = PR_SIMD_LANES;
+				const simd_t zero = PR_SIMD_SET1(0.0f);
+				for (; x <= x1; x += PR_SIMD_WIDTH)
+				{
+					const simd_t px = PR_SIMD_ADD(PR_SIMD_SET1(float(x)), lanes);
+					const simd_t e0 = PR_SIMD_ADD(PR_SIMD_MUL(PR_SIMD_SET1(A[0]), px), PR_SIMD_SET1(B[0] * py + C[0]));
+					const simd_t e1 = PR_SIMD_ADD(PR_SIMD_MUL(PR_SIMD_SET1(A[1]), px), PR_SIMD_SET1(B[1] * py + C[1]));
+					const simd_t e2 = PR_SIMD_ADD(PR_SIMD_MUL(PR_SIMD_SET1(A[2]), px), PR_SIMD_SET1(B[2] * py + C[2]));
+					const simd_t inside = PR_SIMD_AND(PR_SIMD_AND(PR_SIMD_CMPGE(e0, zero), PR_SIMD_CMPGE(e1, zero)), PR_SIMD_CMPGE(e2, zero));
+
+					const simd_t z = PR_SIMD_ADD(PR_SIMD_MUL(PR_SIMD_SET1(zA), px), PR_SIMD_SET1(zB * py + zC));
+					const simd_t current = PR_SIMD_LOAD(row + x);
+					PR_SIMD_STORE(row + x, PR_SIMD_SELECT(inside, PR_SIMD_MIN(current, z), current));
+				}
+#else
+				for (; x <= x1; ++x)
+				{
+					const float px = float(x) + 0.5f;
+					if (A[0] * px + B[0] * py + C[0] < 0.0f || A[1] * px + B[1] * py + C[1] < 0.0f
+						|| A[2] * px + B[2] * py + C[2] < 0.0f) continue;
+					row[x] = std::min(row[x], zA * px + zB * py + zC);
+				}
+#endif
+			}
+		}
+	}
+
+	void OcclusionSystem::buildHiZ()
+	{
+		// each texel stores the farthest depth of the 2x2 texels below it
+		for (size_t level = 1; level < m_Levels.size(); ++level)
+		{
+			const uint32_t w = Width >> level, h = Height >> level;
+			const float* src = m_Levels[level - 1].data();
+			float* dst = m_Levels[level].data();
+			const uint32_t srcWidth = w * 2;
+
+			for (uint32_t y = 0; y < h; ++y)
+				for (uint32_t x = 0; x < w; ++x)
+				{
+					const float* s = src + size_t(2 * y) * srcWidth + 2 * x;
+					dst[size_t(y) * w + x] = std::max(std::max(s[0], s[1]), std::max(s[srcWidth], s[srcWidth + 1]));
+				}
+		}
+	}
+
+	bool OcclusionSystem::IsVisible(const AABB& box) const
+	{
+		float minX = float(Width), minY = float(Height), maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+		float minZ = 1.0f;
+
+		for (int corner = 0; corner < 8; ++corner)
+		{
+			const vec3 p{
+				corner & 1 ? box.max.x : box.min.x,
+				corner & 2 ? box.max.y : box.min.y,
+				corner & 4 ? box.max.z : box.min.z };
+			const vec4 clip = m_ViewProjection * vec4(p, 1.0f);
+
+			// crossing the near plane: cannot be occluded
+			if (clip.w < c_MinW) return true;
+
+			const float invW = 1.0f / clip.w;
+			const float sx = (clip.x * invW * 0.5f + 0.5f) * Width;
+			const float sy = (clip.y * invW * 0.5f + 0.5f) * Height;
+			minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+			minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+			minZ = std::min(minZ, clip.z * invW);
+		}
+
+		int x0 = std::max(0, int(std::floor(minX)));
+		int y0 = std::max(0, int(std::floor(minY)));
+		int x1 = std::min(int(Width) - 1, int(std::floor(maxX)));
+		int y1 = std::min(int(Height) - 1, int(std::floor(maxY)));
+		if (x0 > x1 || y0 > y1) return true; // off-screen, left to frustum culling
+
+		// coarsest level at which the rectangle covers at most 2x2 texels
+		uint32_t level = 0;
+		while (level + 1 < m_Levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+			++level;
+
+		const uint32_t w = Width >> level;
+		const float* hiz = m_Levels[level].data();
+		float maxDepth = 0.0f;
+		for (int y = y0 >> level; y <= (y1 >> level); ++y)
+			for (int x = x0 >> level; x <= (x1 >> level); ++x)
+				maxDepth = std::max(maxDepth, hiz[size_t(y) * w + x]);
+
+		return minZ <= maxDepth;
+	}
+
+	const FrameVector<EntityID>& OcclusionSystem::Cull(const CullingSystem& culling)
+	{
+		PR_PROFILE_FUNCTION();
+		const FrameVector<uint32_t>& candidates = culling.GetVisibleIndices();
+		const BoundsSoA bounds = culling.GetBounds();
+		const uint32_t count = static_cast<uint32_t>(candidates.size());
+
+		FrameVector<uint8_t> visibleFlags(count);
+		TaskSystem::ParallelFor(count, c_TestBatchSize, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					const uint32_t b = candidates[i];
+					const vec3 center{ bounds.centerX[b], bounds.centerY[b], bounds.centerZ[b] };
+					const vec3 extents{ bounds.extentX[b], bounds.extentY[b], bounds.extentZ[b] };
+					visibleFlags[i] = IsVisible(AABB::FromCenterExtents(center, extents));
+				}
+			});
+
+		m_Visible = FrameVector<EntityID>();
+		m_Visible.reserve(count);
+		const EntityID* entities = culling.GetEntities();
+		for (uint32_t i = 0; i < count; ++i)
+			if (visibleFlags[i])
+				m_Visible.push_back(entities[candidates[i]]);
+
+		m_Stats.tested = count;
+		m_Stats.occluded = count - static_cast<uint32_t>(m_Visible.size());
+		PR_ECS_TRACE("Occlusion culling: {0}/{1} occluded ({2:.1f}%)", m_Stats.occluded, m_Stats.tested, 100.0f * m_Stats.CullRate());
+		return m_Visible;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "System.h"
+#include "Entities/Entity.h"
+#include "Math/Math.h"
+#include "Core/Memory/FrameAllocator.h"
+
+#include <vector>
+
+namespace Prism {
+
+	class CullingSystem;
+
+	// triangle mesh used as occluder (should be simple and conservative, i.e. inside the visual mesh)
+	struct OccluderMesh {
+		std::vector<vec3> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	/**
+	 * CPU occlusion culling with a software-rasterised hierarchical Z-buffer
+	 *
+	 * Occluders are rasterised into a low-resolution depth buffer (SIMD,
+	 * screen split into bands processed on the TaskSystem), from which a
+	 * max-depth pyramid is built. Bounds are occluded if their nearest depth
+	 * lies behind the farthest occluder depth of the covered Hi-Z texels.
+	 *
+	 * Runs entirely on the CPU, no GPU or window required.
+	 */
+	class OcclusionSystem : public System {
+	public:
+		static constexpr uint32_t Width = 256;
+		static constexpr uint32_t Height = 128;
+
+		struct Stats {
+			uint32_t occluderTriangles = 0;
+			uint32_t tested = 0;
+			uint32_t occluded = 0;
+
+			float CullRate() const { return tested > 0 ? float(occluded) / float(tested) : 0.0f; }
+		};
+
+		OcclusionSystem();
+
+		// occluders are stored in world space
+		void AddOccluder(const OccluderMesh& mesh, const mat4& world);
+		void ClearOccluders();
+
+		// rasterises all occluders and builds the Hi-Z pyramid
+		void RenderOccluders(const mat4& viewProjection);
+
+		// if the world-space box is (potentially) visible, valid after RenderOccluders
+		bool IsVisible(const AABB& box) const;
+
+		// filters the frustum-visible entities of the CullingSystem in parallel, frame memory like its input
+		const FrameVector<EntityID>& Cull(const CullingSystem& culling);
+
+		const FrameVector<EntityID>& GetVisible() const { return m_Visible; }
+		const Stats& GetStats() const { return m_Stats; }
+
+		uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_Levels.size()); }
+		// depth buffer (level 0) or Hi-Z level, row-major, (Width >> level) x (Height >> level)
+		const float* GetDepth(uint32_t level = 0) const { return m_Levels[level].data(); }
+
+	private:
+		void rasterize(uint32_t rowBegin, uint32_t rowEnd);
+		void buildHiZ();
+
+	private:
+		std::vector<vec3> m_Vertices; // world space
+		std::vector<uint32_t> m_Indices;
+
+		// screen-space vertices (x, y in pixels, z in [0, 1], w < 0 if behind the near plane)
+		std::vector<vec4> m_ScreenVertices;
+		mat4 m_ViewProjection;
+
+		std::vector<std::vector<float>> m_Levels; // [0] is the depth buffer
+
+		FrameVector<EntityID> m_Visible;
+		Stats m_Stats;
+	};
+}
@@ -0,0 +1,288 @@
+#include "ParticleSystem.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Prism {
+
+	static uint32_t s_EmitterSeed = 0x9E3779B9u;
+
+	ParticleEmitter::ParticleEmitter(const ParticleEmitterSettings& settings)
+		: settings(settings)
+		, m_RandomState(s_EmitterSeed += 0x6D2B79F5u)
+	{
+		resize();
+	}
+
+	void ParticleEmitter::resize()
+	{
+		// shrinking drops the newest particles
+		m_Count = std::min(m_Count, settings.maxParticles);
+		for (auto* v : { &m_PositionX, &m_PositionY, &m_PositionZ, &m_VelocityX, &m_VelocityY, &m_VelocityZ,
+			&m_Life, &m_ColorR, &m_ColorG, &m_ColorB, &m_ColorA })
+			v->resize(settings.maxParticles);
+	}
+
+	void ParticleEmitter::Update(float dt)
+	{
+		if (settings.maxParticles != m_Life.size())
+			resize();
+
+		integrate(dt);
+		compact();
+		spawn(dt);
+		updateColors();
+	}
+
+	float ParticleEmitter::random()
+	{
+		// xorshift32
+		m_RandomState ^= m_RandomState << 13;
+		m_RandomState ^= m_RandomState >> 17;
+		m_RandomState ^= m_RandomState << 5;
+		return float(m_RandomState) * (2.0f / 4294967295.0f) - 1.0f;
+	}
+
+	void ParticleEmitter::spawn(float dt)
+	{
+		m_SpawnAccumulator += settings.rate * dt;
+		uint32_t spawned = static_cast<uint32_t>(m_SpawnAccumulator);
+		m_SpawnAccumulator -= float(spawned);
+		spawned = std::min(spawned, settings.maxParticles - m_Count);
+
+		const vec3& p = settings.position;
+		const vec3& v = settings.velocity;
+		const vec3& var = settings.velocityVariance;
+		for (uint32_t i = m_Count; i < m_Count + spawned; ++i)
+		{
+			m_PositionX[i] = p.x; m_PositionY[i] = p.y; m_PositionZ[i] = p.z;
+			m_VelocityX[i] = v.x + var.x * random();
+			m_VelocityY[i] = v.y + var.y * random();
+			m_VelocityZ[i] = v.z + var.z * random();
+			m_Life[i] = settings.lifetime;
+		}
+		m_Count += spawned;
+	}
+
+#if defined(PR_SIMD_AVX2)
+	using simd_t = __m256;
+#define PR_SIMD_SET1 _mm256_set1_ps
+#define PR_SIMD_LOAD _mm256_loadu_ps
+#define PR_SIMD_STORE _mm256_storeu_ps
+#define PR_SIMD_ADD _mm256_add_ps
+#define PR_SIMD_SUB _mm256_sub_ps
+#define PR_SIMD_MUL _mm256_mul_ps
+#define PR_SIMD_CMPGT(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define PR_SIMD_MOVEMASK _mm256_movemask_ps
+#elif defined(PR_SIMD_SSE)
+	using simd_t = __m128;
+#define PR_SIMD_SET1 _mm_set1_ps
+#define PR_SIMD_LOAD _mm_loadu_ps
+#define PR_SIMD_STORE _mm_storeu_ps
+#define PR_SIMD_ADD _mm_add_ps
+#define PR_SIMD_SUB _mm_sub_ps
+#define PR_SIMD_MUL _mm_mul_ps
+#define PR_SIMD_CMPGT(a, b) _mm_cmpgt_ps(a, b)
+#define PR_SIMD_MOVEMASK _mm_movemask_ps
+#endif
+
+	void ParticleEmitter::integrate(float dt)
+	{
+		float* px = m_PositionX.data(); float* py = m_PositionY.data(); float* pz = m_PositionZ.data();
+		float* vx = m_VelocityX.data(); float* vy = m_VelocityY.data(); float* vz = m_VelocityZ.data();
+		float* life = m_Life.data();
+		const vec3 dv = settings.gravity * dt;
+
+		uint32_t i = 0;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t vdt = PR_SIMD_SET1(dt);
+		const simd_t dvx = PR_SIMD_SET1(dv.x), dvy = PR_SIMD_SET1(dv.y), dvz = PR_SIMD_SET1(dv.z);
+		for (; i + PR_SIMD_WIDTH <= m_Count; i += PR_SIMD_WIDTH)
+		{
+			const simd_t nvx = PR_SIMD_ADD(PR_SIMD_LOAD(vx + i), dvx);
+			const simd_t nvy = PR_SIMD_ADD(PR_SIMD_LOAD(vy + i), dvy);
+			const simd_t nvz = PR_SIMD_ADD(PR_SIMD_LOAD(vz + i), dvz);
+			PR_SIMD_STORE(vx + i, nvx); PR_SIMD_STORE(vy + i, nvy); PR_SIMD_STORE(vz + i, nvz);
+			PR_SIMD_STORE(px + i, PR_SIMD_ADD(PR_SIMD_LOAD(px + i), PR_SIMD_MUL(nvx, vdt)));
+			PR_SIMD_STORE(py + i, PR_SIMD_ADD(PR_SIMD_LOAD(py + i), PR_SIMD_MUL(nvy, vdt)));
+			PR_SIMD_STORE(pz + i, PR_SIMD_ADD(PR_SIMD_LOAD(pz + i), PR_SIMD_MUL(nvz, vdt)));
+			PR_SIMD_STORE(life + i, PR_SIMD_SUB(PR_SIMD_LOAD(life + i), vdt));
+		}
+#endif
+		for (; i < m_Count; ++i)
+		{
+			vx[i] += dv.x; vy[i] += dv.y; vz[i] += dv.z;
+			px[i] += vx[i] * dt; py[i] += vy[i] * dt; pz[i] += vz[i] * dt;
+			life[i] -= dt;
+		}
+	}
+
+	void ParticleEmitter::updateColors()
+	{
+		// t = 1 - life / lifetime, color = start + (end - start) * t
+		const float invLifetime = 1.0f / settings.lifetime;
+		const vec4 start = settings.colorStart;
+		const vec4 delta = settings.colorEnd - settings.colorStart;
+		const float* life = m_Life.data();
+		float* channels[4] = { m_ColorR.data(), m_ColorG.data(), m_ColorB.data(), m_ColorA.data() };
+
+		uint32_t i = 0;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t one = PR_SIMD_SET1(1.0f), vInvLifetime = PR_SIMD_SET1(invLifetime);
+		for (; i + PR_SIMD_WIDTH <= m_Count; i += PR_SIMD_WIDTH)
+		{
+			const simd_t t = PR_SIMD_SUB(one, PR_SIMD_MUL(PR_SIMD_LOAD(life + i), vInvLifetime));
+			for (int c = 0; c < 4; ++c)
+				PR_SIMD_STORE(channels[c] + i, PR_SIMD_ADD(PR_SIMD_SET1(start[c]), PR_SIMD_MUL(PR_SIMD_SET1(delta[c]), t)));
+		}
+#endif
+		for (; i < m_Count; ++i)
+		{
+			const float t = 1.0f - life[i] * invLifetime;
+			for (int c = 0; c < 4; ++c)
+				channels[c][i] = start[c] + delta[c] * t;
+		}
+	}
+
+	void ParticleEmitter::compact()
+	{
+		// stable stream compaction of the alive particles, the SIMD mask skips untouched runs
+		float* arrays[] = { m_PositionX.data(), m_PositionY.data(), m_PositionZ.data(),
+			m_VelocityX.data(), m_VelocityY.data(), m_VelocityZ.data(), m_Life.data() };
+		const float* life = m_Life.data();
+
+		uint32_t write = 0;
+		uint32_t i = 0;
+		auto move = [&](uint32_t from)
+		{
+			if (from != write)
+				for (float* a : arrays) a[write] = a[from];
+			++write;
+		};
+
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t zero = PR_SIMD_SET1(0.0f);
+		constexpr uint32_t full = (1u << PR_SIMD_WIDTH) - 1;
+		for (; i + PR_SIMD_WIDTH <= m_Count; i += PR_SIMD_WIDTH)
+		{
+			uint32_t alive = static_cast<uint32_t>(PR_SIMD_MOVEMASK(PR_SIMD_CMPGT(PR_SIMD_LOAD(life + i), zero)));
+			if (alive == full && write == i)
+			{
+				write += PR_SIMD_WIDTH; // nothing died so far
+				continue;
+			}
+			while (alive)
+			{
+				move(i + LowestBitIndex(alive));
+				alive &= alive - 1;
+			}
+		}
+#endif
+		for (; i < m_Count; ++i)
+			if (life[i] > 0.0f)
+				move(i);
+
+		m_Count = write;
+	}
+
+	void ParticleEmitter::Sort(const vec3& cameraPosition, const vec3& viewDirection)
+	{
+		m_Depth.resize(m_Count);
+		m_Keys.resize(m_Count);
+		m_KeysTemp.resize(m_Count);
+		m_Sorted.resize(m_Count);
+		m_SortedTemp.resize(m_Count);
+
+		// view depth, negated for back-to-front, mapped to an ascending integer key
+		const float* px = m_PositionX.data(); const float* py = m_PositionY.data(); const float* pz = m_PositionZ.data();
+		float* depth = m_Depth.data();
+		const float offset = Dot(cameraPosition, viewDirection);
+
+		uint32_t i = 0;
+#if defined(PR_SIMD_SSE) || defined(PR_SIMD_AVX2)
+		const simd_t dx = PR_SIMD_SET1(-viewDirection.x), dy = PR_SIMD_SET1(-viewDirection.y), dz = PR_SIMD_SET1(-viewDirection.z);
+		const simd_t vOffset = PR_SIMD_SET1(-offset);
+		for (; i + PR_SIMD_WIDTH <= m_Count; i += PR_SIMD_WIDTH)
+			PR_SIMD_STORE(depth + i, PR_SIMD_SUB(PR_SIMD_ADD(PR_SIMD_ADD(PR_SIMD_MUL(dx, PR_SIMD_LOAD(px + i)),
+				PR_SIMD_MUL(dy, PR_SIMD_LOAD(py + i))), PR_SIMD_MUL(dz, PR_SIMD_LOAD(pz + i))), vOffset));
+#endif
+		for (; i < m_Count; ++i)
+			depth[i] = -viewDirection.x * px[i] - viewDirection.y * py[i] - viewDirection.z * pz[i] + offset;
+
+		for (i = 0; i < m_Count; ++i)
+		{
+			// flip sign bit for positives, all bits for negatives: float order == unsigned order
+			uint32_t bits;
+			std::memcpy(&bits, depth + i, sizeof(bits));
+			m_Keys[i] = bits ^ ((bits >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+			m_Sorted[i] = i;
+		}
+
+		// LSD radix sort, 4 passes of 8 bits
+		for (uint32_t shift = 0; shift < 32; shift += 8)
+		{
+			uint32_t histogram[257] = {};
+			for (i = 0; i < m_Count; ++i)
+				histogram[((m_Keys[i] >> shift) & 0xFF) + 1]++;
+			for (int b = 0; b < 256; ++b)
+				histogram[b + 1] += histogram[b];
+
+			for (i = 0; i < m_Count; ++i)
+			{
+				const uint32_t dst = histogram[(m_Keys[i] >> shift) & 0xFF]++;
+				m_KeysTemp[dst] = m_Keys[i];
+				m_SortedTemp[dst] = m_Sorted[i];
+			}
+			m_Keys.swap(m_KeysTemp);
+			m_Sorted.swap(m_SortedTemp);
+		}
+	}
+
+	ParticleEmitter* ParticleSystem::CreateEmitter(const ParticleEmitterSettings& settings)
+	{
+		m_Emitters.push_back(std::make_unique<ParticleEmitter>(settings));
+		return m_Emitters.back().get();
+	}
+
+	void ParticleSystem::DestroyEmitter(ParticleEmitter* emitter)
+	{
+		auto itr = std::find_if(m_Emitters.begin(), m_Emitters.end(), [=](const auto& e) { return e.get() == emitter; });
+		if (itr == m_Emitters.end())
+		{
+			PR_ECS_WARN("Emitter not found in ParticleSystem");
+			return;
+		}
+		m_Emitters.erase(itr);
+	}
+
+	void ParticleSystem::Update(float dt)
+	{
+		PR_PROFILE_FUNCTION();
+		TaskSystem::ParallelFor(static_cast<uint32_t>(m_Emitters.size()), 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+					m_Emitters[i]->Update(dt);
+			});
+	}
+
+	void ParticleSystem::Sort(const vec3& cameraPosition, const vec3& viewDirection)
+	{
+		PR_PROFILE_FUNCTION();
+		TaskSystem::ParallelFor(static_cast<uint32_t>(m_Emitters.size()), 1, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+					m_Emitters[i]->Sort(cameraPosition, viewDirection);
+			});
+	}
+
+	size_t ParticleSystem::GetParticleCount() const
+	{
+		size_t count = 0;
+		for (const auto& emitter : m_Emitters)
+			count += emitter->GetCount();
+		return count;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "System.h"
+#include "Math/Math.h"
+
+#include <vector>
+#include <memory>
+
+namespace Prism {
+
+	struct ParticleEmitterSettings {
+		vec3 position{ 0.0f };
+		float rate = 100.0f; // particles per second
+		float lifetime = 1.0f; // seconds
+		uint32_t maxParticles = 10000;
+
+		vec3 velocity{ 0.0f, 1.0f, 0.0f };
+		vec3 velocityVariance{ 0.5f }; // uniform in [-variance, variance] per axis
+		vec3 gravity{ 0.0f, -9.81f, 0.0f };
+
+		vec4 colorStart{ 1.0f };
+		vec4 colorEnd{ 1.0f, 1.0f, 1.0f, 0.0f };
+	};
+
+	/**
+	 * Particles of one emitter, stored SoA
+	 *
+	 * Updated by SIMD kernels: integrate, colour over lifetime, compaction of
+	 * dead particles, depth sort (radix sort on the view depth).
+	 */
+	class ParticleEmitter {
+	public:
+		ParticleEmitter(const ParticleEmitterSettings& settings);
+
+		void Update(float dt);
+		// back-to-front order of the particles for the given camera
+		void Sort(const vec3& cameraPosition, const vec3& viewDirection);
+
+		// may be changed between updates, a new maxParticles reallocates the particles
+		ParticleEmitterSettings settings;
+
+		uint32_t GetCount() const { return m_Count; }
+		const float* GetPositionX() const { return m_PositionX.data(); }
+		const float* GetPositionY() const { return m_PositionY.data(); }
+		const float* GetPositionZ() const { return m_PositionZ.data(); }
+		const float* GetColorR() const { return m_ColorR.data(); }
+		const float* GetColorG() const { return m_ColorG.data(); }
+		const float* GetColorB() const { return m_ColorB.data(); }
+		const float* GetColorA() const { return m_ColorA.data(); }
+		const float* GetLife() const { return m_Life.data(); }
+		// valid after Sort()
+		const std::vector<uint32_t>& GetSortedIndices() const { return m_Sorted; }
+
+	private:
+		// sizes the particle arrays to settings.maxParticles
+		void resize();
+		void spawn(float dt);
+		void integrate(float dt);
+		void updateColors();
+		void compact();
+
+		float random(); // [-1, 1]
+
+	private:
+		uint32_t m_Count = 0;
+		float m_SpawnAccumulator = 0.0f;
+		uint32_t m_RandomState;
+
+		std::vector<float> m_PositionX, m_PositionY, m_PositionZ;
+		std::vector<float> m_VelocityX, m_VelocityY, m_VelocityZ;
+		std::vector<float> m_Life; // remaining seconds
+		std::vector<float> m_ColorR, m_ColorG, m_ColorB, m_ColorA;
+
+		// sort scratch buffers
+		std::vector<float> m_Depth;
+		std::vector<uint32_t> m_Keys, m_KeysTemp, m_Sorted, m_SortedTemp;
+	};
+
+	/**
+	 * Owns all particle emitters and updates them in parallel on the TaskSystem
+	 */
+	class ParticleSystem : public System {
+	public:
+		ParticleEmitter* CreateEmitter(const ParticleEmitterSettings& settings);
+		void DestroyEmitter(ParticleEmitter* emitter);
+
+		void Update(float dt);
+		void Sort(const vec3& cameraPosition, const vec3& viewDirection);
+
+		size_t GetParticleCount() const;
+		const std::vector<std::unique_ptr<ParticleEmitter>>& GetEmitters() const { return m_Emitters; }
+
+	private:
+		std::vector<std::unique_ptr<ParticleEmitter>> m_Emitters;
+	};
+}
@@ -0,0 +1,398 @@
+#include "SpatialIndexSystem.h"
+#include "TransformSystem.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace Prism {
+
+	// queries per task in the batched variants
+	constexpr uint32_t c_QueryBatchSize = 64;
+	// rebuild once refitting grew the root surface area by this factor
+	constexpr float c_RebuildThreshold = 2.0f;
+	// fixed size traversal stack, enough for any tree built by median splits
+	constexpr uint32_t c_StackSize = 64;
+
+	void SpatialIndexSystem::Add(Entity* entity)
+	{
+		const Bounds* bounds = entity->components.Find<Bounds>();
+		if (!bounds)
+		{
+			PR_ECS_WARN("Entity {0} has no Bounds, not added to SpatialIndexSystem", entity->id);
+			return;
+		}
+
+		const bool transformed = entity->components.Find<Transform>() != nullptr;
+		m_ProxyIndex.emplace(entity->id, static_cast<uint32_t>(m_Proxies.size()));
+		m_Added.push_back(static_cast<uint32_t>(m_Proxies.size()));
+		m_Proxies.push_back({ entity->id, bounds->box, bounds->box, InvalidIndex, transformed });
+		m_NeedsRebuild = true;
+	}
+
+	void SpatialIndexSystem::Add(World& world, const World::EntityRange& range)
+	{
+		const Bounds* bounds = world.GetColumn<Bounds>(range);
+		if (!bounds)
+		{
+			PR_ECS_WARN("Prefab has no Bounds, entities not added to SpatialIndexSystem");
+			return;
+		}
+
+		const bool transformed = world.GetColumn<Transform>(range) != nullptr;
+		m_Proxies.reserve(m_Proxies.size() + range.count);
+		for (uint32_t i = 0; i < range.count; ++i)
+		{
+			m_ProxyIndex.emplace(range.first + i, static_cast<uint32_t>(m_Proxies.size()));
+			m_Added.push_back(static_cast<uint32_t>(m_Proxies.size()));
+			m_Proxies.push_back({ range.first + i, bounds[i].box, bounds[i].box, InvalidIndex, transformed });
+		}
+		m_NeedsRebuild = true;
+	}
+
+	void SpatialIndexSystem::Remove(EntityID entity)
+	{
+		auto itr = m_ProxyIndex.find(entity);
+		if (itr == m_ProxyIndex.end())
+		{
+			PR_ECS_WARN("Entity {0} not found in SpatialIndexSystem", entity);
+			return;
+		}
+
+		// swap with the last proxy, the tree stays valid until the next
+		// rebuild: the removed primitive is skipped, the moved one remapped
+		const uint32_t index = itr->second;
+		const uint32_t last = static_cast<uint32_t>(m_Proxies.size() - 1);
+		m_ProxyIndex.erase(itr);
+		m_Added.erase(std::remove(m_Added.begin(), m_Added.end(), index), m_Added.end());
+		replacePrimitive(m_Proxies[index].leaf, index, InvalidIndex);
+		if (index != last)
+		{
+			replacePrimitive(m_Proxies[last].leaf, last, index);
+			m_Proxies[index] = m_Proxies.back();
+			m_ProxyIndex[m_Proxies[index].entity] = index;
+			std::replace(m_Added.begin(), m_Added.end(), last, index);
+		}
+		m_Proxies.pop_back();
+		m_NeedsRebuild = true;
+	}
+
+	void SpatialIndexSystem::replacePrimitive(uint32_t leaf, uint32_t proxy, uint32_t replacement)
+	{
+		if (leaf == InvalidIndex) return;
+		const Node& node = m_Nodes[leaf];
+		for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			if (m_Primitives[i] == proxy)
+			{
+				m_Primitives[i] = replacement;
+				return;
+			}
+	}
+
+	void SpatialIndexSystem::Update(const TransformSystem& transforms)
+	{
+		PR_PROFILE_FUNCTION();
+		for (uint32_t index : m_Added)
+		{
+			Proxy& proxy = m_Proxies[index];
+			if (proxy.transformed)
+				proxy.world = TransformBounds(transforms.GetWorldMatrix(proxy.entity), proxy.local);
+		}
+		m_Added.clear();
+
+		// pull world bounds of all entities moved in this frame
+		const mat4* matrices = transforms.GetWorldMatrices();
+		const EntityID* entities = transforms.GetEntities();
+		FrameVector<uint32_t> movedLeaves;
+		for (uint32_t changed : transforms.GetChanged())
+		{
+			auto itr = m_ProxyIndex.find(entities[changed]);
+			if (itr == m_ProxyIndex.end()) continue;
+
+			Proxy& proxy = m_Proxies[itr->second];
+			proxy.world = TransformBounds(matrices[changed], proxy.local);
+			if (proxy.leaf != InvalidIndex)
+				movedLeaves.push_back(proxy.leaf);
+		}
+
+		if (m_NeedsRebuild)
+		{
+			Rebuild();
+			return;
+		}
+		if (movedLeaves.empty()) return;
+
+		if (movedLeaves.size() * 4 > m_Nodes.size())
+		{
+			// many moved: one reverse pass (children are stored after their parents)
+			for (size_t i = m_Nodes.size(); i-- > 0;)
+				refit(static_cast<uint32_t>(i));
+		}
+		else
+		{
+			// few moved: walk up from each leaf until the bounds stop changing
+			for (uint32_t node : movedLeaves)
+				while (node != InvalidIndex)
+				{
+					const AABB before = m_Nodes[node].bounds;
+					refit(node);
+					if (before.min == m_Nodes[node].bounds.min && before.max == m_Nodes[node].bounds.max
+						&& m_Nodes[node].count == 0)
+						break;
+					node = m_Nodes[node].parent;
+				}
+		}
+
+		if (m_Nodes[0].bounds.SurfaceArea() > c_RebuildThreshold * m_BuildSurfaceArea)
+			Rebuild();
+	}
+
+	void SpatialIndexSystem::Rebuild()
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Proxies.size());
+
+		m_Primitives.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+			m_Primitives[i] = i;
+
+		m_Nodes.clear();
+		m_Nodes.reserve(count > 0 ? 2 * ((count + LeafSize - 1) / LeafSize) : 0);
+		if (count > 0)
+		{
+			m_Nodes.emplace_back();
+			build(0, 0, count);
+		}
+
+		m_BuildSurfaceArea = count > 0 ? m_Nodes[0].bounds.SurfaceArea() : 0.0f;
+		m_NeedsRebuild = false;
+		PR_ECS_TRACE("SpatialIndexSystem rebuilt: {0} entities, {1} nodes", count, m_Nodes.size());
+	}
+
+	void SpatialIndexSystem::build(uint32_t node, uint32_t begin, uint32_t end)
+	{
+		AABB bounds, centroids;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			bounds.Merge(m_Proxies[m_Primitives[i]].world);
+			centroids.Merge(m_Proxies[m_Primitives[i]].world.Center());
+		}
+		m_Nodes[node].bounds = bounds;
+
+		if (end - begin <= LeafSize)
+		{
+			m_Nodes[node].first = begin;
+			m_Nodes[node].count = end - begin;
+			for (uint32_t i = begin; i < end; ++i)
+				m_Proxies[m_Primitives[i]].leaf = node;
+			return;
+		}
+
+		// median split along the largest extent of the centroids
+		const vec3 extent = centroids.max - centroids.min;
+		const int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		const uint32_t mid = begin + (end - begin) / 2;
+		std::nth_element(m_Primitives.begin() + begin, m_Primitives.begin() + mid, m_Primitives.begin() + end,
+			[&](uint32_t a, uint32_t b) {
+				return m_Proxies[a].world.min[axis] + m_Proxies[a].world.max[axis]
+					< m_Proxies[b].world.min[axis] + m_Proxies[b].world.max[axis];
+			});
+
+		const uint32_t left = static_cast<uint32_t>(m_Nodes.size());
+		m_Nodes[node].first = left;
+		m_Nodes[node].count = 0;
+		m_Nodes.emplace_back().parent = node;
+		m_Nodes.emplace_back().parent = node;
+
+		build(left, begin, mid);
+		build(left + 1, mid, end);
+	}
+
+	void SpatialIndexSystem::refit(uint32_t index)
+	{
+		Node& node = m_Nodes[index];
+		if (node.count == 0)
+		{
+			node.bounds = Merge(m_Nodes[node.first].bounds, m_Nodes[node.first + 1].bounds);
+			return;
+		}
+
+		AABB bounds;
+		for (uint32_t i = node.first; i < node.first + node.count; ++i)
+			if (m_Primitives[i] != InvalidIndex)
+				bounds.Merge(m_Proxies[m_Primitives[i]].world);
+		node.bounds = bounds;
+	}
+
+	template<typename Overlaps>
+	void SpatialIndexSystem::queryRange(const Overlaps& overlaps, std::vector<EntityID>& result) const
+	{
+		if (m_Nodes.empty()) return;
+
+		uint32_t stack[c_StackSize];
+		uint32_t size = 0;
+		stack[size++] = 0;
+
+		while (size > 0)
+		{
+			const Node& node = m_Nodes[stack[--size]];
+			if (!overlaps(node.bounds)) continue;
+
+			if (node.count > 0)
+			{
+				for (uint32_t i = node.first; i < node.first + node.count; ++i)
+					if (m_Primitives[i] != InvalidIndex && overlaps(m_Proxies[m_Primitives[i]].world))
+						result.push_back(m_Proxies[m_Primitives[i]].entity);
+			}
+			else
+			{
+				stack[size++] = node.first;
+				stack[size++] = node.first + 1;
+			}
+		}
+	}
+
+	void SpatialIndexSystem::QueryRange(const AABB& box, std::vector<EntityID>& result) const
+	{
+		queryRange([&](const AABB& bounds) { return box.Overlaps(bounds); }, result);
+	}
+
+	void SpatialIndexSystem::QueryRange(const Sphere& sphere, std::vector<EntityID>& result) const
+	{
+		const float radiusSq = sphere.radius * sphere.radius;
+		queryRange([&](const AABB& bounds) { return SquaredDistance(bounds, sphere.center) <= radiusSq; }, result);
+	}
+
+	uint32_t SpatialIndexSystem::QueryNearest(const vec3& point, uint32_t k, EntityID* result, float* distances) const
+	{
+		if (m_Nodes.empty() || k == 0) return 0;
+
+		// best-first traversal: nodes by distance (min-heap), k best so far (max-heap)
+		using Entry = std::pair<float, uint32_t>;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> nodes;
+		std::priority_queue<Entry> best;
+
+		nodes.push({ SquaredDistance(m_Nodes[0].bounds, point), 0 });
+		while (!nodes.empty())
+		{
+			const auto [distance, index] = nodes.top();
+			nodes.pop();
+			if (best.size() == k && distance > best.top().first) break;
+
+			const Node& node = m_Nodes[index];
+			if (node.count > 0)
+			{
+				for (uint32_t i = node.first; i < node.first + node.count; ++i)
+				{
+					if (m_Primitives[i] == InvalidIndex) continue;
+					const float d = SquaredDistance(m_Proxies[m_Primitives[i]].world, point);
+					if (best.size() < k) best.push({ d, m_Primitives[i] });
+					else if (d < best.top().first)
+					{
+						best.pop();
+						best.push({ d, m_Primitives[i] });
+					}
+				}
+			}
+			else
+			{
+				nodes.push({ SquaredDistance(m_Nodes[node.first].bounds, point), node.first });
+				nodes.push({ SquaredDistance(m_Nodes[node.first + 1].bounds, point), node.first + 1 });
+			}
+		}
+
+		// the max-heap pops the farthest first
+		const uint32_t found = static_cast<uint32_t>(best.size());
+		for (uint32_t i = found; i-- > 0; best.pop())
+		{
+			result[i] = m_Proxies[best.top().second].entity;
+			if (distances) distances[i] = std::sqrt(best.top().first);
+		}
+		return found;
+	}
+
+	SpatialIndexSystem::RayHit SpatialIndexSystem::Raycast(const Ray& ray, float maxDistance) const
+	{
+		RayHit hit;
+		if (m_Nodes.empty()) return hit;
+
+		float closest = maxDistance;
+		uint32_t stack[c_StackSize];
+		uint32_t size = 0;
+		stack[size++] = 0;
+
+		while (size > 0)
+		{
+			const Node& node = m_Nodes[stack[--size]];
+			float t;
+			if (!Intersect(ray, node.bounds, closest, t)) continue;
+
+			if (node.count > 0)
+			{
+				for (uint32_t i = node.first; i < node.first + node.count; ++i)
+					if (m_Primitives[i] != InvalidIndex && Intersect(ray, m_Proxies[m_Primitives[i]].world, closest, t))
+					{
+						closest = t;
+						hit = { m_Proxies[m_Primitives[i]].entity, t };
+					}
+			}
+			else
+			{
+				// visit the nearer child first to shrink closest early
+				float tLeft = 0.0f, tRight = 0.0f;
+				const bool hitLeft = Intersect(ray, m_Nodes[node.first].bounds, closest, tLeft);
+				const bool hitRight = Intersect(ray, m_Nodes[node.first + 1].bounds, closest, tRight);
+				if (hitLeft && hitRight && tLeft < tRight)
+				{
+					stack[size++] = node.first + 1;
+					stack[size++] = node.first;
+				}
+				else
+				{
+					if (hitLeft) stack[size++] = node.first;
+					if (hitRight) stack[size++] = node.first + 1;
+				}
+			}
+		}
+		return hit;
+	}
+
+	void SpatialIndexSystem::QueryRangeBatch(const AABB* boxes, size_t count, std::vector<std::vector<EntityID>>& results) const
+	{
+		results.resize(count);
+		TaskSystem::ParallelFor(static_cast<uint32_t>(count), c_QueryBatchSize, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					results[i].clear();
+					QueryRange(boxes[i], results[i]);
+				}
+			});
+	}
+
+	void SpatialIndexSystem::QueryNearestBatch(const vec3* points, size_t count, uint32_t k, EntityID* results, float* distances) const
+	{
+		// each query writes k slots, unused ones are set to 0
+		TaskSystem::ParallelFor(static_cast<uint32_t>(count), c_QueryBatchSize, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+				{
+					EntityID* out = results + size_t(i) * k;
+					float* outDistances = distances ? distances + size_t(i) * k : nullptr;
+					const uint32_t found = QueryNearest(points[i], k, out, outDistances);
+					std::fill(out + found, out + k, 0);
+				}
+			});
+	}
+
+	void SpatialIndexSystem::RaycastBatch(const Ray* rays, size_t count, float maxDistance, RayHit* hits) const
+	{
+		TaskSystem::ParallelFor(static_cast<uint32_t>(count), c_QueryBatchSize, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t i = begin; i < end; ++i)
+					hits[i] = Raycast(rays[i], maxDistance);
+			});
+	}
+}
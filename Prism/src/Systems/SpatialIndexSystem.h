@@ -0,0 +1,95 @@
+#pragma once
+
+#include "System.h"
+#include "Components/Bounds.h"
+#include "Entities/World.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace Prism {
+
+	class TransformSystem;
+
+	/**
+	 * Bounding volume hierarchy over the world bounds of entities
+	 *
+	 * Moved entities (reported by the TransformSystem) are refitted
+	 * incrementally, the tree is rebuilt when entities are added/removed
+	 * or when refitting degraded it too much.
+	 *
+	 * All queries are const and may run concurrently from any thread,
+	 * as long as Update/Add/Remove are not called at the same time.
+	 */
+	class SpatialIndexSystem : public System {
+	public:
+		struct RayHit {
+			EntityID entity = 0; // 0 if nothing was hit
+			float distance = 0.0f;
+		};
+
+		// registers the entity's Bounds (in local space of its Transform)
+		void Add(Entity* entity);
+		void Add(World& world, const World::EntityRange& range);
+		void Remove(EntityID entity);
+
+		// pulls world bounds of moved entities, refits or rebuilds the tree
+		// (must be called after TransformSystem::Update)
+		void Update(const TransformSystem& transforms);
+		void Rebuild();
+
+		// entities whose bounds overlap the box/sphere are appended to result
+		void QueryRange(const AABB& box, std::vector<EntityID>& result) const;
+		void QueryRange(const Sphere& sphere, std::vector<EntityID>& result) const;
+		// up to k nearest entities (by distance to their bounds), closest first
+		uint32_t QueryNearest(const vec3& point, uint32_t k, EntityID* result, float* distances = nullptr) const;
+		// closest entity bounds hit by the ray within maxDistance
+		RayHit Raycast(const Ray& ray, float maxDistance) const;
+
+		// batched variants, distributed over the TaskSystem
+		void QueryRangeBatch(const AABB* boxes, size_t count, std::vector<std::vector<EntityID>>& results) const;
+		void QueryNearestBatch(const vec3* points, size_t count, uint32_t k, EntityID* results, float* distances = nullptr) const;
+		void RaycastBatch(const Ray* rays, size_t count, float maxDistance, RayHit* hits) const;
+
+		size_t GetSize() const { return m_Proxies.size(); }
+		AABB GetWorldBounds() const { return m_Nodes.empty() ? AABB{} : m_Nodes[0].bounds; }
+
+	private:
+		void build(uint32_t node, uint32_t begin, uint32_t end);
+		void refit(uint32_t node);
+		// swaps proxy for replacement in the leaf's primitives
+		void replacePrimitive(uint32_t leaf, uint32_t proxy, uint32_t replacement);
+
+		template<typename Overlaps>
+		void queryRange(const Overlaps& overlaps, std::vector<EntityID>& result) const;
+
+	private:
+		static constexpr uint32_t InvalidIndex = ~0u;
+		static constexpr uint32_t LeafSize = 4;
+
+		struct Proxy {
+			EntityID entity;
+			AABB local;
+			AABB world;
+			uint32_t leaf = InvalidIndex;
+			bool transformed; // if the entity has a Transform
+		};
+		std::vector<Proxy> m_Proxies;
+		std::unordered_map<EntityID, uint32_t> m_ProxyIndex;
+
+		// leaf: count > 0, primitives m_Primitives[first .. first + count]
+		// inner: count == 0, children at first and first + 1
+		struct Node {
+			AABB bounds;
+			uint32_t first = 0;
+			uint32_t count = 0;
+			uint32_t parent = InvalidIndex;
+		};
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t> m_Primitives; // proxy indices, grouped by leaf (InvalidIndex if removed)
+
+		std::vector<uint32_t> m_Added; // proxies without world bounds yet
+		bool m_NeedsRebuild = false;
+		float m_BuildSurfaceArea = 0.0f; // root surface area after the last build
+	};
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "Util/Log/Log.h"
+#include "Core/Memory/MemoryTracker.h"
+
 #include <typeinfo>
 #include <typeindex>
 #include <unordered_map>
+#include <memory>
 
 namespace Prism {
 
@@ -26,6 +30,7 @@ namespace Prism {
 		constexpr T* Create(Args&&... args)
 		{
 			static_assert(std::is_base_of<System, T>::value, "System classes must be derivatives of System.");
+			PR_MEMORY_TAG(ECS);
 			T* system = new T(std::forward<Args>(args)...);
 			systems.insert(std::pair(&typeid(T), std::unique_ptr<System>(system)));
 			return system;
@@ -37,7 +42,7 @@ namespace Prism {
 			const auto itr = systems.find(&typeid(T));
 			if (itr != systems.end())
 				return static_cast<T*>(itr->second.get());
-			PR_CORE_CRITICAL("System not found!");
+			PR_ECS_CRITICAL("System not found!");
 			return nullptr;
 		}
 
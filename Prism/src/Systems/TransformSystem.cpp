@@ -0,0 +1,200 @@
+#include "TransformSystem.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Profiler/Profiler.h"
+
+namespace Prism {
+
+	// nodes per task when propagating a level
+	constexpr uint32_t c_BatchSize = 2048;
+
+	void TransformSystem::Add(Entity* entity)
+	{
+		Transform* transform = entity->components.Find<Transform>();
+		if (!transform)
+		{
+			PR_ECS_WARN("Entity {0} has no Transform, not added to TransformSystem", entity->id);
+			return;
+		}
+
+		const Parent* parent = entity->components.Find<Parent>();
+		m_Nodes.push_back({ entity->id, parent ? parent->parent : 0, transform });
+		m_HierarchyChanged = true;
+	}
+
+	void TransformSystem::Add(World& world, const World::EntityRange& range)
+	{
+		Transform* transforms = world.GetColumn<Transform>(range);
+		if (!transforms)
+		{
+			PR_ECS_WARN("Prefab has no Transform, entities not added to TransformSystem");
+			return;
+		}
+		const Parent* parents = world.GetColumn<Parent>(range);
+
+		m_Nodes.reserve(m_Nodes.size() + range.count);
+		for (uint32_t i = 0; i < range.count; ++i)
+			m_Nodes.push_back({ range.first + i, parents ? parents[i].parent : 0, transforms + i });
+		m_HierarchyChanged = true;
+	}
+
+	void TransformSystem::Remove(EntityID entity)
+	{
+		auto itr = std::find_if(m_Nodes.begin(), m_Nodes.end(), [=](const Node& n) { return n.entity == entity; });
+		if (itr == m_Nodes.end())
+		{
+			PR_ECS_WARN("Entity {0} not found in TransformSystem", entity);
+			return;
+		}
+
+		*itr = m_Nodes.back();
+		m_Nodes.pop_back();
+		m_HierarchyChanged = true;
+	}
+
+	void TransformSystem::SetParent(EntityID entity, EntityID parent)
+	{
+		for (auto& node : m_Nodes)
+			if (node.entity == entity)
+			{
+				node.parent = parent;
+				m_HierarchyChanged = true;
+				return;
+			}
+		PR_ECS_WARN("Entity {0} not found in TransformSystem", entity);
+	}
+
+	void TransformSystem::Update()
+	{
+		PR_PROFILE_FUNCTION();
+		if (m_HierarchyChanged) rebuild();
+
+		// one pass per level, parents are final before their children are visited
+		for (size_t level = 0; level + 1 < m_LevelStart.size(); ++level)
+		{
+			const uint32_t levelBegin = m_LevelStart[level];
+			TaskSystem::ParallelFor(m_LevelStart[level + 1] - levelBegin, c_BatchSize, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t i = levelBegin + begin; i < levelBegin + end; ++i)
+					{
+						Transform* transform = m_Transforms[i];
+						const uint32_t parent = m_Parents[i];
+
+						const bool dirty = m_Dirty[i] || transform->m_Dirty
+							|| (parent != InvalidIndex && m_Dirty[parent]);
+						if (!dirty) continue;
+
+						const mat4 local = transform->GetLocalMatrix();
+						m_World[i] = parent != InvalidIndex ? m_World[parent] * local : local;
+						transform->m_Dirty = false;
+						m_Dirty[i] = true;
+					}
+				});
+		}
+
+		m_Changed.clear();
+		for (uint32_t i = 0; i < m_Dirty.size(); ++i)
+			if (m_Dirty[i])
+			{
+				m_Changed.push_back(i);
+				m_Dirty[i] = false;
+			}
+	}
+
+	const mat4& TransformSystem::GetWorldMatrix(EntityID entity) const
+	{
+		static const mat4 identity{};
+
+		auto itr = m_Index.find(entity);
+		if (itr == m_Index.end())
+		{
+			PR_ECS_WARN_LIMITED("Entity {0} not found in TransformSystem", entity);
+			return identity;
+		}
+		return m_World[itr->second];
+	}
+
+	void TransformSystem::rebuild()
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Nodes.size());
+
+		std::unordered_map<EntityID, uint32_t> nodeIndex;
+		nodeIndex.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+			nodeIndex.emplace(m_Nodes[i].entity, i);
+
+		// children in CSR layout: m_Nodes indices of the children of node n
+		// are childList[childStart[n] .. childStart[n + 1]]
+		std::vector<uint32_t> parentNode(count, InvalidIndex);
+		std::vector<uint32_t> childStart(count + 1, 0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (m_Nodes[i].parent == 0) continue;
+			auto itr = nodeIndex.find(m_Nodes[i].parent);
+			if (itr == nodeIndex.end())
+			{
+				PR_ECS_WARN("Parent {0} of entity {1} not in TransformSystem, treated as root", m_Nodes[i].parent, m_Nodes[i].entity);
+				continue;
+			}
+			parentNode[i] = itr->second;
+			childStart[itr->second + 1]++;
+		}
+		for (uint32_t i = 0; i < count; ++i)
+			childStart[i + 1] += childStart[i];
+
+		std::vector<uint32_t> childList(childStart[count]);
+		std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+		for (uint32_t i = 0; i < count; ++i)
+			if (parentNode[i] != InvalidIndex)
+				childList[fill[parentNode[i]]++] = i;
+
+		// breadth-first order: roots, then the children of each level in parent order
+		std::vector<uint32_t> order;
+		order.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+			if (parentNode[i] == InvalidIndex)
+				order.push_back(i);
+
+		m_LevelStart.clear();
+		size_t levelBegin = 0;
+		while (levelBegin < order.size())
+		{
+			m_LevelStart.push_back(static_cast<uint32_t>(levelBegin));
+			const size_t levelEnd = order.size();
+			for (size_t i = levelBegin; i < levelEnd; ++i)
+				for (uint32_t c = childStart[order[i]]; c < childStart[order[i] + 1]; ++c)
+					order.push_back(childList[c]);
+			levelBegin = levelEnd;
+		}
+		m_LevelStart.push_back(static_cast<uint32_t>(order.size()));
+
+		if (order.size() != count)
+			PR_ECS_ERROR("TransformSystem: {0} entities are part of a parent cycle and are ignored", count - order.size());
+
+		// fill the sorted arrays
+		const size_t sorted = order.size();
+		std::vector<uint32_t> sortedIndex(count, InvalidIndex);
+		for (uint32_t i = 0; i < sorted; ++i)
+			sortedIndex[order[i]] = i;
+
+		m_Entities.resize(sorted);
+		m_Transforms.resize(sorted);
+		m_Parents.resize(sorted);
+		m_World.resize(sorted);
+		m_Dirty.assign(sorted, true); // everything is recomputed after a rebuild
+		m_Index.clear();
+		m_Index.reserve(sorted);
+
+		for (uint32_t i = 0; i < sorted; ++i)
+		{
+			const Node& node = m_Nodes[order[i]];
+			m_Entities[i] = node.entity;
+			m_Transforms[i] = node.transform;
+			m_Parents[i] = parentNode[order[i]] != InvalidIndex ? sortedIndex[parentNode[order[i]]] : InvalidIndex;
+			m_Index.emplace(node.entity, i);
+		}
+
+		m_HierarchyChanged = false;
+		PR_ECS_TRACE("TransformSystem rebuilt: {0} nodes, {1} levels", sorted, m_LevelStart.size() - 1);
+	}
+}
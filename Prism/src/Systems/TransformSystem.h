@@ -0,0 +1,67 @@
+#pragma once
+
+#include "System.h"
+#include "Components/Transform.h"
+#include "Entities/World.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace Prism {
+
+	/**
+	 * Computes world matrices of all registered Transforms
+	 *
+	 * Nodes are stored breadth-first (sorted by depth, siblings next to each
+	 * other), so parents are always updated before their children and the
+	 * propagation is one forward pass over contiguous arrays.
+	 * Each level is processed in parallel on the TaskSystem.
+	 */
+	class TransformSystem : public System {
+	public:
+		static constexpr uint32_t InvalidIndex = ~0u;
+
+		// registers the entity's Transform (and Parent, if any)
+		void Add(Entity* entity);
+		// registers all entities of a prefab instantiation
+		void Add(World& world, const World::EntityRange& range);
+		void Remove(EntityID entity);
+		void SetParent(EntityID entity, EntityID parent);
+
+		// recomputes world matrices of dirty subtrees
+		void Update();
+
+		const mat4& GetWorldMatrix(EntityID entity) const;
+
+		// depth-sorted data, valid after Update()
+		size_t GetSize() const { return m_World.size(); }
+		const mat4* GetWorldMatrices() const { return m_World.data(); }
+		const EntityID* GetEntities() const { return m_Entities.data(); }
+		// indices of the nodes changed by the last Update()
+		const std::vector<uint32_t>& GetChanged() const { return m_Changed; }
+
+	private:
+		void rebuild();
+
+	private:
+		// registration data, in insertion order
+		struct Node {
+			EntityID entity;
+			EntityID parent; // 0 for roots
+			Transform* transform;
+		};
+		std::vector<Node> m_Nodes;
+		bool m_HierarchyChanged = false;
+
+		// depth-sorted arrays (SoA)
+		std::vector<EntityID> m_Entities;
+		std::vector<Transform*> m_Transforms;
+		std::vector<uint32_t> m_Parents; // index into the sorted arrays
+		std::vector<mat4> m_World;
+		std::vector<uint8_t> m_Dirty;
+		std::vector<uint32_t> m_LevelStart; // first node of each level, plus end
+		std::unordered_map<EntityID, uint32_t> m_Index; // entity -> sorted index
+
+		std::vector<uint32_t> m_Changed;
+	};
+}
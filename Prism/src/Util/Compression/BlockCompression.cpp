@@ -0,0 +1,183 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Prism {
+
+	constexpr size_t c_MinMatch = 4;
+	constexpr size_t c_LastLiterals = 5; // the format ends with at least this many literals
+	constexpr size_t c_MatchLimit = 12; // no match starts within the last bytes
+	constexpr size_t c_MaxOffset = 65535;
+	constexpr uint32_t c_HashBits = 12;
+
+	static uint32_t read32(const uint8_t* p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	static uint32_t hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - c_HashBits);
+	}
+
+	// length in the token (up to 15), the rest as 255-sums
+	static uint8_t* writeLength(uint8_t* out, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			*out++ = 255;
+		*out++ = static_cast<uint8_t>(length);
+		return out;
+	}
+
+	size_t BlockCompression::Compress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity)
+	{
+		uint8_t* out = destination;
+		uint8_t* const outEnd = destination + capacity;
+
+		// emits literals [anchor, end) followed by a match (unless it's the last sequence)
+		auto emit = [&](const uint8_t* anchor, const uint8_t* end, size_t offset, size_t matchLength)
+		{
+			const size_t literals = end - anchor;
+			// token, lengths, literals, offset
+			if (static_cast<size_t>(outEnd - out) < 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1)
+				return false;
+
+			uint8_t* token = out++;
+			*token = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+			if (literals >= 15) out = writeLength(out, literals - 15);
+			if (literals > 0) std::memcpy(out, anchor, literals);
+			out += literals;
+
+			if (matchLength == 0)
+				return true;
+			*out++ = static_cast<uint8_t>(offset);
+			*out++ = static_cast<uint8_t>(offset >> 8);
+			matchLength -= c_MinMatch;
+			*token |= static_cast<uint8_t>(std::min<size_t>(matchLength, 15));
+			if (matchLength >= 15) out = writeLength(out, matchLength - 15);
+			return true;
+		};
+
+		const uint8_t* anchor = source;
+		if (size > c_MatchLimit)
+		{
+			uint32_t table[1 << c_HashBits] = {}; // last position of each hashed sequence
+			const uint8_t* const matchLimit = source + size - c_MatchLimit;
+			const uint8_t* const matchEnd = source + size - c_LastLiterals;
+
+			const uint8_t* in = source + 1;
+			table[hash(read32(source))] = 0;
+			while (in < matchLimit)
+			{
+				const uint32_t sequence = read32(in);
+				const uint32_t h = hash(sequence);
+				const uint8_t* candidate = source + table[h];
+				table[h] = static_cast<uint32_t>(in - source);
+
+				if (candidate >= in || static_cast<size_t>(in - candidate) > c_MaxOffset || read32(candidate) != sequence)
+				{
+					// skip faster through incompressible data
+					in += 1 + ((in - anchor) >> 6);
+					continue;
+				}
+
+				// extend backwards into the literals, then forwards
+				while (in > anchor && candidate > source && in[-1] == candidate[-1])
+					--in, --candidate;
+				size_t length = c_MinMatch;
+				while (in + length < matchEnd && in[length] == candidate[length])
+					++length;
+
+				if (!emit(anchor, in, in - candidate, length))
+					return 0;
+				in += length;
+				anchor = in;
+				if (in < matchLimit)
+					table[hash(read32(in - 2))] = static_cast<uint32_t>(in - 2 - source);
+			}
+		}
+
+		if (!emit(anchor, source + size, 0, 0))
+			return 0;
+		return out - destination;
+	}
+
+	// reads the 255-sum continuation of a length
+	static bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length)
+	{
+		uint8_t byte;
+		do
+		{
+			if (in >= end) return false;
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	bool BlockCompression::Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t size)
+	{
+		const uint8_t* in = source;
+		const uint8_t* const inEnd = source + sourceSize;
+		uint8_t* out = destination;
+		uint8_t* const outEnd = destination + size;
+
+		while (in < inEnd)
+		{
+			const uint8_t token = *in++;
+
+			size_t literals = token >> 4;
+			if (literals < 15 && inEnd - in >= 16 && outEnd - out >= 16)
+				std::memcpy(out, in, 16); // fixed size copies are much faster, the extra bytes are overwritten
+			else
+			{
+				if (literals == 15 && !readLength(in, inEnd, literals))
+					return false;
+				if (literals > static_cast<size_t>(inEnd - in) || literals > static_cast<size_t>(outEnd - out))
+					return false;
+				if (literals > 0) std::memcpy(out, in, literals);
+			}
+			in += literals;
+			out += literals;
+
+			if (in == inEnd)
+				break; // the last sequence has no match
+			if (inEnd - in < 2)
+				return false;
+			const size_t offset = in[0] | (in[1] << 8);
+			in += 2;
+			if (offset == 0 || offset > static_cast<size_t>(out - destination))
+				return false;
+
+			size_t length = token & 15;
+			if (length == 15 && !readLength(in, inEnd, length))
+				return false;
+			length += c_MinMatch;
+			if (length > static_cast<size_t>(outEnd - out))
+				return false;
+
+			const uint8_t* match = out - offset;
+			if (offset >= 16 && length <= 32 && outEnd - out >= 32)
+			{
+				// neither copy overlaps itself
+				std::memcpy(out, match, 16);
+				std::memcpy(out + 16, match + 16, 16);
+				out += length;
+				continue;
+			}
+
+			// overlapping matches repeat the last offset bytes, copy in growing chunks
+			while (length > 0)
+			{
+				const size_t chunk = std::min<size_t>(length, out - match);
+				std::memcpy(out, match, chunk);
+				out += chunk;
+				length -= chunk;
+			}
+		}
+		return out == outEnd;
+	}
+}
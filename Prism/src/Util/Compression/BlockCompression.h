@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Prism {
+
+	/**
+	 * Fast LZ77 compression of independent blocks (up to a few MB each)
+	 *
+	 * Writes the LZ4 block format (token, literals, 16 bit offset, match
+	 * length), so blocks can be decoded by any LZ4 implementation and vice
+	 * versa. The compressor is a simple greedy one, speed over ratio.
+	 * Decompression checks every bound, corrupt input fails, never overruns.
+	 *
+	 * Only depends on the standard library, Tools/Packer compiles it in.
+	 */
+	class BlockCompression {
+	public:
+		// upper bound of the compressed size of size bytes
+		static size_t GetMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+		// @returns the compressed size, 0 if it doesn't fit into capacity
+		static size_t Compress(const uint8_t* source, size_t size, uint8_t* destination, size_t capacity);
+
+		// @returns if source decompressed to exactly size bytes
+		static bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t size);
+	};
+}
@@ -0,0 +1,615 @@
+#include "FileReader.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Log/Log.h"
+#include "Util/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define PR_IO_URING 1
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#else
+#define PR_IO_URING 0
+#endif
+
+namespace Prism {
+
+	struct ReadRequest {
+		std::string filepath;
+		std::shared_ptr<const FileReader::Callback> callback;
+	};
+
+	struct ReadResult {
+		ReadRequest request;
+		std::optional<std::string> data;
+	};
+
+	constexpr uint32_t c_BlockingIOThreads = 4; // blocked threads cost no CPU, more of them overlap more reads
+	constexpr uint32_t c_RingEntries = 64; // io_uring reads in flight
+
+	// requests waiting for the I/O threads
+	std::mutex g_ReadRequestMutex;
+	std::condition_variable g_ReadRequestSignal;
+	std::deque<ReadRequest> g_ReadRequests;
+	std::vector<std::thread> g_IOThreads;
+	bool g_IORunning = false;
+	bool g_IOStopping = false;
+	std::atomic<bool> g_IONative = false;
+
+	// completed reads waiting for their callback
+	std::mutex g_ReadCompletionMutex;
+	std::condition_variable g_ReadCompletionSignal;
+	std::deque<ReadResult> g_ReadCompletions;
+	uint32_t g_ReadCompletionLanes = 0; // tasks currently running callbacks
+	uint64_t g_PendingReads = 0; // requested, but the callback didn't return yet
+
+	// whole file, with plain system calls
+	static std::optional<std::string> readFile(const std::string& filepath)
+	{
+		std::string data;
+		size_t done = 0;
+		bool failed = false;
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return std::nullopt;
+
+		LARGE_INTEGER size;
+		failed = !GetFileSizeEx(file, &size);
+		if (!failed)
+			data.resize(static_cast<size_t>(size.QuadPart));
+		while (!failed && done < data.size())
+		{
+			DWORD count = 0;
+			const DWORD chunk = static_cast<DWORD>(std::min<size_t>(data.size() - done, 1u << 30));
+			failed = !::ReadFile(file, data.data() + done, chunk, &count, nullptr);
+			if (count == 0)
+				break; // the file got shorter
+			done += count;
+		}
+		CloseHandle(file);
+#else
+		const int file = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			return std::nullopt;
+
+		struct stat info;
+		failed = fstat(file, &info) != 0;
+		if (!failed)
+			data.resize(static_cast<size_t>(info.st_size));
+		while (!failed && done < data.size())
+		{
+			const ssize_t count = read(file, data.data() + done, data.size() - done);
+			if (count < 0 && errno == EINTR)
+				continue;
+			failed = count < 0;
+			if (count <= 0)
+				break; // the file got shorter
+			done += static_cast<size_t>(count);
+		}
+		close(file);
+#endif
+		if (failed)
+			return std::nullopt;
+		data.resize(done);
+		return data;
+	}
+
+	static uint32_t maxReadCompletionLanes()
+	{
+		return std::max(1u, TaskSystem::GetWorkerCount() / 2);
+	}
+
+	// runs the next callback (unlocked), false if there is none
+	static bool runNextReadCallback(std::unique_lock<std::mutex>& lock)
+	{
+		if (g_ReadCompletions.empty())
+			return false;
+		ReadResult result = std::move(g_ReadCompletions.front());
+		g_ReadCompletions.pop_front();
+
+		lock.unlock();
+		(*result.request.callback)(result.request.filepath, std::move(result.data));
+		lock.lock();
+
+		if (--g_PendingReads == 0)
+			g_ReadCompletionSignal.notify_all();
+		return true;
+	}
+
+	// a lane keeps running callbacks, so callbacks never occupy more than maxReadCompletionLanes() workers
+	static void runReadCompletionLane()
+	{
+		PR_PROFILE_SCOPE("FileReadCallback");
+		std::unique_lock<std::mutex> lock(g_ReadCompletionMutex);
+		while (runNextReadCallback(lock));
+		--g_ReadCompletionLanes;
+	}
+
+	// hands a finished read to the TaskSystem, I/O threads only
+	static void completeRead(ReadRequest request, std::optional<std::string> data)
+	{
+		if (!data)
+			PR_CORE_ERROR("Could not read file '{0}'", request.filepath);
+		{
+			std::lock_guard<std::mutex> lock(g_ReadCompletionMutex);
+			g_ReadCompletions.push_back({ std::move(request), std::move(data) });
+			g_ReadCompletionSignal.notify_all(); // Wait() runs callbacks too
+			if (g_ReadCompletionLanes >= maxReadCompletionLanes())
+				return;
+			++g_ReadCompletionLanes;
+		}
+		TaskSystem::Submit(Task(runReadCompletionLane));
+	}
+
+	// thread pool fallback, every thread does one blocking read at a time
+	static void runBlockingIO()
+	{
+		while (true)
+		{
+			ReadRequest request;
+			{
+				std::unique_lock<std::mutex> lock(g_ReadRequestMutex);
+				g_ReadRequestSignal.wait(lock, []() { return !g_ReadRequests.empty() || g_IOStopping; });
+				if (g_ReadRequests.empty())
+					return;
+				request = std::move(g_ReadRequests.front());
+				g_ReadRequests.pop_front();
+			}
+			std::optional<std::string> data = readFile(request.filepath);
+			completeRead(std::move(request), std::move(data));
+		}
+	}
+
+	// g_ReadRequestMutex must be held, Shutdown joins the threads
+	static void startBlockingIO(uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+			g_IOThreads.emplace_back(runBlockingIO);
+	}
+
+#if PR_IO_URING
+	/**
+	 * Minimal io_uring (system calls only, there is no liburing): a
+	 * submission and a completion queue, shared with the kernel through
+	 * mapped memory. Only used by the I/O thread.
+	 */
+	class IoRing {
+	public:
+		IoRing() = default;
+		~IoRing() { release(); }
+		IoRing(const IoRing&) = delete;
+		IoRing& operator=(const IoRing&) = delete;
+
+		// false if io_uring isn't available (old kernel, disabled, seccomp)
+		bool Init(uint32_t entries)
+		{
+			io_uring_params params{};
+			const long ring = syscall(__NR_io_uring_setup, entries, &params);
+			if (ring < 0)
+				return false;
+			m_Ring = static_cast<int>(ring);
+			m_Entries = params.sq_entries;
+
+			m_SqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+			m_CqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+			if (singleMap)
+				m_SqSize = m_CqSize = std::max(m_SqSize, m_CqSize);
+			m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+			m_SqRing = map(m_SqSize, IORING_OFF_SQ_RING);
+			m_CqRing = singleMap ? m_SqRing : map(m_CqSize, IORING_OFF_CQ_RING);
+			m_Sqes = static_cast<io_uring_sqe*>(map(m_SqesSize, IORING_OFF_SQES));
+			if (!m_SqRing || !m_CqRing || !m_Sqes)
+			{
+				release();
+				return false;
+			}
+
+			uint8_t* sq = static_cast<uint8_t*>(m_SqRing);
+			m_SqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+			m_SqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+			m_SqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+			m_SqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+			uint8_t* cq = static_cast<uint8_t*>(m_CqRing);
+			m_CqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+			m_CqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+			m_CqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+			m_Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+			return true;
+		}
+
+		uint32_t GetCapacity() const { return m_Entries; }
+
+		// queues a read into vector (which must live until it completes), false if the queue is full
+		bool Read(int file, const iovec* vector, uint64_t offset, uint64_t userData)
+		{
+			const uint32_t tail = *m_SqTail;
+			if (tail - __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE) >= m_Entries)
+				return false;
+
+			const uint32_t index = tail & m_SqMask;
+			io_uring_sqe& entry = m_Sqes[index];
+			std::memset(&entry, 0, sizeof(entry));
+			entry.opcode = IORING_OP_READV; // READ needs 5.6, READV works since io_uring exists
+			entry.fd = file;
+			entry.addr = reinterpret_cast<uint64_t>(vector);
+			entry.len = 1;
+			entry.off = offset;
+			entry.user_data = userData;
+			m_SqArray[index] = index;
+			__atomic_store_n(m_SqTail, tail + 1, __ATOMIC_RELEASE);
+			++m_Unsubmitted;
+			return true;
+		}
+
+		// submits the queued reads and blocks until at least one read completed
+		bool SubmitAndWait()
+		{
+			while (true)
+			{
+				const long submitted = syscall(__NR_io_uring_enter, m_Ring, m_Unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (submitted >= 0)
+				{
+					m_Unsubmitted -= static_cast<uint32_t>(submitted);
+					return true;
+				}
+				if (errno == EAGAIN || errno == EBUSY)
+					std::this_thread::yield();
+				else if (errno != EINTR)
+					return false;
+			}
+		}
+
+		// calls function(userData) for the queued reads the kernel didn't take (yet)
+		template<typename F>
+		void ForEachUnsubmitted(const F& function) const
+		{
+			const uint32_t tail = *m_SqTail;
+			for (uint32_t head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE); head != tail; ++head)
+				function(m_Sqes[m_SqArray[head & m_SqMask]].user_data);
+		}
+
+		// calls function(userData, result) for every completion, result is the byte count or -errno
+		template<typename F>
+		void Reap(const F& function)
+		{
+			uint32_t head = *m_CqHead;
+			const uint32_t tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe& completion = m_Cqes[head & m_CqMask];
+				const uint64_t userData = completion.user_data;
+				const int32_t result = completion.res;
+				__atomic_store_n(m_CqHead, head + 1, __ATOMIC_RELEASE);
+				function(userData, result);
+			}
+		}
+
+	private:
+		void* map(size_t size, off_t offset)
+		{
+			void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Ring, offset);
+			return memory == MAP_FAILED ? nullptr : memory;
+		}
+
+		void release()
+		{
+			if (m_Sqes) munmap(m_Sqes, m_SqesSize);
+			if (m_CqRing && m_CqRing != m_SqRing) munmap(m_CqRing, m_CqSize);
+			if (m_SqRing) munmap(m_SqRing, m_SqSize);
+			if (m_Ring >= 0) close(m_Ring);
+			m_Sqes = nullptr;
+			m_SqRing = m_CqRing = nullptr;
+			m_Ring = -1;
+		}
+
+		int m_Ring = -1;
+		uint32_t m_Entries = 0;
+		uint32_t m_Unsubmitted = 0;
+
+		void* m_SqRing = nullptr;
+		void* m_CqRing = nullptr;
+		io_uring_sqe* m_Sqes = nullptr;
+		size_t m_SqSize = 0, m_CqSize = 0, m_SqesSize = 0;
+
+		uint32_t* m_SqHead = nullptr;
+		uint32_t* m_SqTail = nullptr;
+		uint32_t* m_SqArray = nullptr;
+		uint32_t m_SqMask = 0;
+
+		uint32_t* m_CqHead = nullptr;
+		uint32_t* m_CqTail = nullptr;
+		io_uring_cqe* m_Cqes = nullptr;
+		uint32_t m_CqMask = 0;
+	};
+
+	std::unique_ptr<IoRing> g_IORing;
+
+	struct RingRead {
+		RingRead(ReadRequest request, int file, size_t size) : request(std::move(request)), file(file), data(size, '\0') {}
+		~RingRead() { close(file); }
+		RingRead(const RingRead&) = delete;
+		RingRead& operator=(const RingRead&) = delete;
+
+		ReadRequest request;
+		int file;
+		std::string data;
+		size_t done = 0;
+		iovec vector{};
+	};
+
+	/**
+	 * Hands the reads in flight to blocking I/O threads (started here), after
+	 * the kernel is done with their buffers, and closes the ring. Reads
+	 * the kernel didn't take can go right away, the others are waited for.
+	 */
+	static void fallBackToBlockingIO(std::vector<std::unique_ptr<RingRead>>& reads, uint32_t& inFlight)
+	{
+		std::vector<ReadRequest> requests;
+		auto requeue = [&](uint64_t slot)
+		{
+			requests.push_back(std::move(reads[slot]->request));
+			reads[slot].reset();
+			--inFlight;
+		};
+		g_IORing->ForEachUnsubmitted(requeue);
+		while (inFlight > 0)
+		{
+			// the completion queue is filled without io_uring_enter
+			g_IORing->Reap([&](uint64_t slot, int32_t) { requeue(slot); });
+			if (inFlight > 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		g_IORing.reset();
+		g_IONative = false;
+
+		{
+			std::lock_guard<std::mutex> lock(g_ReadRequestMutex);
+			g_ReadRequests.insert(g_ReadRequests.begin(), std::make_move_iterator(requests.begin()), std::make_move_iterator(requests.end()));
+			// once Shutdown took the threads to join, this one finishes the requests alone
+			if (!g_IOStopping)
+				startBlockingIO(c_BlockingIOThreads - 1);
+		}
+		g_ReadRequestSignal.notify_all();
+		PR_CORE_INFO("FileReader: reading on {0} I/O threads", c_BlockingIOThreads);
+		runBlockingIO();
+	}
+
+	// the only I/O thread with io_uring: opens files, keeps up to GetCapacity() reads in flight
+	static void runRingIO()
+	{
+		IoRing& ring = *g_IORing;
+		std::vector<std::unique_ptr<RingRead>> reads(ring.GetCapacity()); // user data is the index
+		uint32_t inFlight = 0;
+
+		// queues the rest of the file, there is room for every read in flight
+		auto submit = [&](uint32_t slot)
+		{
+			RingRead& read = *reads[slot];
+			read.vector.iov_base = read.data.data() + read.done;
+			read.vector.iov_len = std::min<size_t>(read.data.size() - read.done, 1u << 30);
+			const bool queued = ring.Read(read.file, &read.vector, read.done, slot);
+			PR_CORE_ASSERT(queued, "io_uring submission queue is full");
+		};
+		auto finish = [&](uint32_t slot, bool success)
+		{
+			std::unique_ptr<RingRead> read = std::move(reads[slot]);
+			--inFlight;
+			completeRead(std::move(read->request), success ? std::optional<std::string>(std::move(read->data)) : std::nullopt);
+		};
+
+		std::vector<ReadRequest> requests;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(g_ReadRequestMutex);
+				if (inFlight == 0)
+				{
+					g_ReadRequestSignal.wait(lock, []() { return !g_ReadRequests.empty() || g_IOStopping; });
+					if (g_ReadRequests.empty())
+						return;
+				}
+				// new requests wait for a free slot, or while blocked in SubmitAndWait for the next completion
+				while (!g_ReadRequests.empty() && inFlight + requests.size() < ring.GetCapacity())
+				{
+					requests.push_back(std::move(g_ReadRequests.front()));
+					g_ReadRequests.pop_front();
+				}
+			}
+
+			for (ReadRequest& request : requests)
+			{
+				struct stat info;
+				const int file = open(request.filepath.c_str(), O_RDONLY | O_CLOEXEC);
+				const bool opened = file >= 0 && fstat(file, &info) == 0;
+				if (!opened || info.st_size == 0)
+				{
+					if (file >= 0) close(file);
+					completeRead(std::move(request), opened ? std::optional<std::string>(std::string()) : std::nullopt);
+					continue;
+				}
+				const uint32_t slot = static_cast<uint32_t>(std::find(reads.begin(), reads.end(), nullptr) - reads.begin());
+				reads[slot] = std::make_unique<RingRead>(std::move(request), file, static_cast<size_t>(info.st_size));
+				++inFlight;
+				submit(slot);
+			}
+			requests.clear();
+			if (inFlight == 0)
+				continue;
+
+			if (!ring.SubmitAndWait())
+			{
+				PR_CORE_CRITICAL("io_uring failed ({0}), falling back to blocking reads", std::strerror(errno));
+				fallBackToBlockingIO(reads, inFlight);
+				return;
+			}
+
+			ring.Reap([&](uint64_t slot, int32_t result)
+				{
+					RingRead& read = *reads[slot];
+					if (result == -EINTR || result == -EAGAIN)
+						submit(static_cast<uint32_t>(slot));
+					else if (result <= 0)
+					{
+						if (result == 0) read.data.resize(read.done); // the file got shorter
+						finish(static_cast<uint32_t>(slot), result == 0);
+					}
+					else if ((read.done += static_cast<size_t>(result)) < read.data.size())
+						submit(static_cast<uint32_t>(slot)); // short read
+					else
+						finish(static_cast<uint32_t>(slot), true);
+				});
+		}
+	}
+#endif
+
+	void FileReader::Init()
+	{
+		std::lock_guard<std::mutex> lock(g_ReadRequestMutex);
+		if (g_IORunning)
+			return;
+		g_IORunning = true;
+		g_IOStopping = false;
+
+#if PR_IO_URING
+		auto ring = std::make_unique<IoRing>();
+		if (ring->Init(c_RingEntries))
+		{
+			g_IORing = std::move(ring);
+			g_IONative = true;
+			g_IOThreads.emplace_back(runRingIO);
+			PR_CORE_INFO("FileReader: reading through io_uring ({0} reads in flight)", g_IORing->GetCapacity());
+			return;
+		}
+#endif
+		startBlockingIO(c_BlockingIOThreads);
+		PR_CORE_INFO("FileReader: reading on {0} I/O threads", c_BlockingIOThreads);
+	}
+
+	void FileReader::Shutdown()
+	{
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> lock(g_ReadRequestMutex);
+			if (!g_IORunning)
+				return;
+			g_IORunning = false;
+			g_IOStopping = true; // the I/O threads finish all requests first
+			threads = std::move(g_IOThreads);
+			g_IOThreads.clear();
+		}
+		g_ReadRequestSignal.notify_all();
+		for (std::thread& thread : threads)
+			thread.join();
+
+		Wait();
+#if PR_IO_URING
+		g_IORing.reset();
+#endif
+		g_IONative = false;
+	}
+
+	std::optional<std::string> FileReader::Read(const std::string& filepath)
+	{
+		return readFile(filepath);
+	}
+
+	std::optional<MappedFile> FileReader::Map(const std::string& filepath, AccessPattern pattern)
+	{
+		MappedFile file;
+		if (!file.Open(filepath))
+		{
+			PR_CORE_ERROR("Could not map file '{0}'", filepath);
+			return std::nullopt;
+		}
+		file.Advise(pattern);
+		return file;
+	}
+
+	void FileReader::ReadAsync(std::vector<std::string> filepaths, Callback callback)
+	{
+		if (filepaths.empty())
+			return;
+		auto shared = std::make_shared<const Callback>(std::move(callback));
+		{
+			std::lock_guard<std::mutex> lock(g_ReadCompletionMutex);
+			g_PendingReads += filepaths.size();
+		}
+
+		std::unique_lock<std::mutex> lock(g_ReadRequestMutex);
+		if (!g_IORunning)
+		{
+			// no I/O threads, read right here
+			lock.unlock();
+			for (std::string& filepath : filepaths)
+			{
+				std::optional<std::string> data = readFile(filepath);
+				completeRead({ std::move(filepath), shared }, std::move(data));
+			}
+			return;
+		}
+
+		for (std::string& filepath : filepaths)
+			g_ReadRequests.push_back({ std::move(filepath), shared });
+		lock.unlock();
+		g_ReadRequestSignal.notify_all();
+	}
+
+	void FileReader::Wait()
+	{
+		std::unique_lock<std::mutex> lock(g_ReadCompletionMutex);
+		while (g_PendingReads > 0)
+			if (!runNextReadCallback(lock))
+				g_ReadCompletionSignal.wait(lock);
+	}
+
+	void FileReader::Prefetch(const std::vector<std::string>& filepaths)
+	{
+#if defined(POSIX_FADV_WILLNEED)
+		for (const std::string& filepath : filepaths)
+		{
+			const int file = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+			if (file < 0)
+				continue;
+			posix_fadvise(file, 0, 0, POSIX_FADV_WILLNEED);
+			close(file);
+		}
+#else
+		// nothing comparable for files that aren't open (Windows), Map with AccessPattern::WillNeed works
+		(void)filepaths;
+#endif
+	}
+
+	bool FileReader::IsAsyncNative()
+	{
+		return g_IONative;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Prism {
+
+	/**
+	 * File I/O beyond StringReader::ReadFile
+	 *
+	 * - Read: synchronous, no iostreams
+	 * - Map: zero-copy, the file is mapped and read through a string_view
+	 * - ReadAsync: whole files read in the background, many at once, with
+	 *   io_uring where the kernel supports it and on a few blocking I/O
+	 *   threads otherwise. Callbacks run on the TaskSystem, at most half
+	 *   the workers at a time (like resource loads).
+	 * - Prefetch: readahead hints, so later reads hit the page cache
+	 *
+	 * Init after TaskSystem::Init, Shutdown before TaskSystem::Finish.
+	 * Without Init, ReadAsync reads on the calling thread.
+	 */
+	class FileReader {
+	public:
+		// data is nullopt if the file couldn't be read
+		using Callback = std::function<void(const std::string& filepath, std::optional<std::string> data)>;
+
+		static void Init();
+		// completes all requested reads (callbacks included), then stops the I/O threads
+		static void Shutdown();
+
+		// whole file, read right away with plain system calls (nullopt if it can't be read)
+		static std::optional<std::string> Read(const std::string& filepath);
+		// nullopt if the file can't be mapped, the view is valid while the MappedFile lives
+		static std::optional<MappedFile> Map(const std::string& filepath, AccessPattern pattern = AccessPattern::Sequential);
+
+		/**
+		 * Reads the files in the background, all requests are in flight
+		 * at the same time. callback is called once per file, in order of
+		 * completion, on a TaskSystem worker.
+		 */
+		static void ReadAsync(std::vector<std::string> filepaths, Callback callback);
+
+		/**
+		 * Blocks until every read requested so far is done and its callback
+		 * returned, running callbacks on this thread meanwhile. Must not be
+		 * called from a callback.
+		 */
+		static void Wait();
+
+		// asks the OS to read the files into the page cache in the background (POSIX only)
+		static void Prefetch(const std::vector<std::string>& filepaths);
+
+		// if reads go through io_uring (instead of blocking I/O threads)
+		static bool IsAsyncNative();
+	};
+}
@@ -0,0 +1,131 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Prism {
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			std::swap(m_Data, other.m_Data);
+			std::swap(m_Size, other.m_Size);
+			std::swap(m_Open, other.m_Open);
+			std::swap(m_File, other.m_File);
+#if defined(_WIN32)
+			std::swap(m_Mapping, other.m_Mapping);
+#endif
+		}
+		return *this;
+	}
+
+	bool MappedFile::Open(const std::string& filepath)
+	{
+		Close();
+#if defined(_WIN32)
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+		m_File = file;
+		m_Size = static_cast<size_t>(size.QuadPart);
+		m_Open = true;
+		if (m_Size == 0)
+			return true; // can't map empty files
+
+		m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_Mapping)
+			m_Data = static_cast<const uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		const int file = open(filepath.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(file, &info) != 0)
+		{
+			close(file);
+			return false;
+		}
+		m_File = file;
+		m_Size = static_cast<size_t>(info.st_size);
+		m_Open = true;
+		if (m_Size == 0)
+			return true; // can't map empty files
+
+		void* view = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED)
+			m_Data = static_cast<const uint8_t*>(view);
+#endif
+		if (!m_Data)
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void MappedFile::Advise(AccessPattern pattern) const
+	{
+		if (!m_Data)
+			return;
+#if defined(_WIN32)
+		// Windows only knows prefetching, the rest is up to its own heuristics
+		if (pattern == AccessPattern::WillNeed)
+		{
+			WIN32_MEMORY_RANGE_ENTRY range{ const_cast<uint8_t*>(m_Data), m_Size };
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+		}
+#else
+		int advice = MADV_NORMAL;
+		switch (pattern)
+		{
+		case AccessPattern::Sequential: advice = MADV_SEQUENTIAL; break;
+		case AccessPattern::Random: advice = MADV_RANDOM; break;
+		case AccessPattern::WillNeed: advice = MADV_WILLNEED; break;
+		default: break;
+		}
+		madvise(const_cast<uint8_t*>(m_Data), m_Size, advice);
+#endif
+	}
+
+	void MappedFile::Close()
+	{
+		if (!m_Open)
+			return;
+#if defined(_WIN32)
+		if (m_Data) UnmapViewOfFile(m_Data);
+		if (m_Mapping) CloseHandle(m_Mapping);
+		CloseHandle(m_File);
+		m_Mapping = nullptr;
+		m_File = nullptr;
+#else
+		if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		close(m_File);
+		m_File = -1;
+#endif
+		m_Data = nullptr;
+		m_Size = 0;
+		m_Open = false;
+	}
+}
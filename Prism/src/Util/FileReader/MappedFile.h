@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Prism {
+
+	// how a mapping (or file) is going to be read, for the OS's readahead
+	enum class AccessPattern {
+		Normal,
+		Sequential, // front to back, read ahead aggressively
+		Random, // no readahead
+		WillNeed // start reading it into memory now
+	};
+
+	/**
+	 * Read-only memory mapping of a whole file
+	 *
+	 * Pages are loaded by the OS on first access, reading from the mapping
+	 * costs no syscall and no copy. Views into it are valid while the
+	 * MappedFile is alive (and open).
+	 */
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// false if the file can't be opened or mapped (empty files map to an empty view)
+		bool Open(const std::string& filepath);
+		void Close();
+		// readahead hint for the whole mapping, best effort
+		void Advise(AccessPattern pattern) const;
+
+		bool IsOpen() const { return m_Open; }
+		const uint8_t* GetData() const { return m_Data; }
+		size_t GetSize() const { return m_Size; }
+		std::string_view GetView() const { return { reinterpret_cast<const char*>(m_Data), m_Size }; }
+
+	private:
+		const uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+		bool m_Open = false;
+#if defined(_WIN32)
+		void* m_File = nullptr;
+		void* m_Mapping = nullptr;
+#else
+		int m_File = -1;
+#endif
+	};
+}
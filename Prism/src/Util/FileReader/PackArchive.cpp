@@ -0,0 +1,209 @@
+#include "PackArchive.h"
+
+#include "Core/TaskSystem/TaskSystem.h"
+#include "Util/Compression/BlockCompression.h"
+#include "Util/Log/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace Prism {
+
+	namespace {
+
+		// count elements of stride bytes starting at offset end at or before end, without sums that could wrap
+		bool inRange(uint64_t offset, uint64_t count, uint64_t stride, uint64_t end)
+		{
+			return offset <= end && count <= (end - offset) / stride;
+		}
+	}
+
+	bool PackArchive::Open(const std::string& filepath)
+	{
+		Close();
+		if (!m_File.Open(filepath))
+		{
+			PR_RESOURCES_ERROR("Could not map pack '{0}'", filepath);
+			return false;
+		}
+
+		m_Path = filepath;
+		m_Header = reinterpret_cast<const PackFormat::Header*>(m_File.GetData());
+		if (!validate())
+		{
+			PR_RESOURCES_ERROR("'{0}' is not a valid pack (version {1} expected)", filepath, PackFormat::Version);
+			Close();
+			return false;
+		}
+
+		const uint8_t* data = m_File.GetData();
+		m_Entries = reinterpret_cast<const PackFormat::Entry*>(data + m_Header->tocOffset);
+		m_Blocks = reinterpret_cast<const PackFormat::Block*>(data + m_Header->blocksOffset);
+		m_Index = reinterpret_cast<const uint32_t*>(data + m_Header->indexOffset);
+		m_Names = reinterpret_cast<const char*>(data + m_Header->namesOffset);
+		PR_RESOURCES_TRACE("Opened pack '{0}' with {1} entries", filepath, m_Header->entryCount);
+		return true;
+	}
+
+	void PackArchive::Close()
+	{
+		m_File.Close();
+		m_Path.clear();
+		m_Header = nullptr;
+		m_Entries = nullptr;
+		m_Blocks = nullptr;
+		m_Index = nullptr;
+		m_Names = nullptr;
+	}
+
+	std::optional<uint32_t> PackArchive::FindEntry(std::string_view name) const
+	{
+		if (!m_Header)
+			return std::nullopt;
+
+		const uint64_t hash = PackFormat::Hash(name);
+		const uint32_t mask = m_Header->indexBuckets - 1;
+		for (uint32_t bucket = static_cast<uint32_t>(hash) & mask;; bucket = (bucket + 1) & mask)
+		{
+			const uint32_t index = m_Index[bucket];
+			if (index == 0)
+				return std::nullopt;
+			if (m_Entries[index - 1].nameHash == hash && GetName(index - 1) == name)
+				return index - 1;
+		}
+	}
+
+	std::optional<std::string_view> PackArchive::Find(std::string_view name) const
+	{
+		const auto index = FindEntry(name);
+		if (!index || IsCompressed(*index))
+			return std::nullopt;
+		return GetData(*index);
+	}
+
+	std::optional<std::string> PackArchive::Load(std::string_view name) const
+	{
+		const auto index = FindEntry(name);
+		if (!index)
+			return std::nullopt;
+
+		std::string data(GetSize(*index), '\0');
+		if (!Read(*index, data.data()))
+			return std::nullopt;
+		return data;
+	}
+
+	bool PackArchive::Read(uint32_t index, void* destination, bool parallel) const
+	{
+		const PackFormat::Entry& entry = m_Entries[index];
+		uint8_t* out = static_cast<uint8_t*>(destination);
+		if (!(entry.flags & PackFormat::Compressed))
+		{
+			if (entry.size > 0) std::memcpy(out, m_File.GetData() + entry.offset, entry.size);
+			return true;
+		}
+
+		// every block decompresses straight to its place in the destination
+		const uint32_t blocks = static_cast<uint32_t>((entry.size + m_Header->blockSize - 1) / m_Header->blockSize);
+		std::atomic<bool> valid = true;
+		auto readBlocks = [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t block = begin; block < end; ++block)
+				if (!readBlock(entry, block, out + uint64_t(block) * m_Header->blockSize))
+					valid.store(false, std::memory_order_relaxed);
+		};
+		if (parallel && blocks > 1)
+			TaskSystem::ParallelFor(blocks, 1, readBlocks);
+		else
+			readBlocks(0, blocks);
+
+		if (!valid)
+			PR_RESOURCES_ERROR("Entry '{0}' of pack '{1}' is corrupt", GetName(index), m_Path);
+		return valid;
+	}
+
+	bool PackArchive::readBlock(const PackFormat::Entry& entry, uint32_t block, uint8_t* destination) const
+	{
+		const PackFormat::Block& stored = m_Blocks[entry.firstBlock + block];
+		const uint64_t size = std::min<uint64_t>(m_Header->blockSize, entry.size - uint64_t(block) * m_Header->blockSize);
+		const uint8_t* source = m_File.GetData() + stored.offset;
+		if (stored.flags & PackFormat::Raw)
+		{
+			std::memcpy(destination, source, size);
+			return true;
+		}
+		return BlockCompression::Decompress(source, stored.storedSize, destination, size);
+	}
+
+	std::string_view PackArchive::GetName(uint32_t index) const
+	{
+		const PackFormat::Entry& entry = m_Entries[index];
+		return { m_Names + entry.nameOffset, entry.nameLength };
+	}
+
+	std::string_view PackArchive::GetData(uint32_t index) const
+	{
+		const PackFormat::Entry& entry = m_Entries[index];
+		return { reinterpret_cast<const char*>(m_File.GetData() + entry.offset), entry.storedSize };
+	}
+
+	// everything Find, Read and Get* access must be inside the file, the pack may be truncated or foreign
+	bool PackArchive::validate() const
+	{
+		const uint64_t size = m_File.GetSize();
+		if (size < sizeof(PackFormat::Header))
+			return false;
+
+		const PackFormat::Header& header = *m_Header;
+		if (std::memcmp(header.magic, PackFormat::Magic, sizeof(PackFormat::Magic)) != 0
+			|| header.version != PackFormat::Version || header.size != size)
+			return false;
+
+		const uint32_t buckets = header.indexBuckets;
+		if (buckets == 0 || (buckets & (buckets - 1)) != 0 || buckets <= header.entryCount || header.blockSize == 0
+			|| header.tocOffset % 8 != 0 || header.blocksOffset % 8 != 0 || header.indexOffset % 8 != 0
+			|| !inRange(header.tocOffset, header.entryCount, sizeof(PackFormat::Entry), size)
+			|| !inRange(header.blocksOffset, header.blockCount, sizeof(PackFormat::Block), size)
+			|| !inRange(header.indexOffset, buckets, sizeof(uint32_t), size)
+			|| header.namesOffset > size)
+			return false;
+
+		const uint8_t* data = m_File.GetData();
+		const PackFormat::Entry* entries = reinterpret_cast<const PackFormat::Entry*>(data + header.tocOffset);
+		const PackFormat::Block* blocks = reinterpret_cast<const PackFormat::Block*>(data + header.blocksOffset);
+		for (uint32_t i = 0; i < header.entryCount; ++i)
+		{
+			const PackFormat::Entry& entry = entries[i];
+			if (entry.nameOffset > size - header.namesOffset
+				|| !inRange(header.namesOffset + entry.nameOffset, entry.nameLength, 1, size)
+				|| !inRange(entry.offset, entry.storedSize, 1, size))
+				return false;
+
+			if (!(entry.flags & PackFormat::Compressed))
+			{
+				if (entry.storedSize != entry.size)
+					return false;
+				continue;
+			}
+
+			const uint64_t blockCount = entry.size / header.blockSize + (entry.size % header.blockSize != 0);
+			if (!inRange(entry.firstBlock, blockCount, 1, header.blockCount))
+				return false;
+			for (uint64_t block = 0; block < blockCount; ++block)
+			{
+				const PackFormat::Block& stored = blocks[entry.firstBlock + block];
+				const uint64_t blockSize = std::min<uint64_t>(header.blockSize, entry.size - block * header.blockSize);
+				if (!inRange(stored.offset, stored.storedSize, 1, size)
+					|| ((stored.flags & PackFormat::Raw) && stored.storedSize != blockSize))
+					return false;
+			}
+		}
+
+		const uint32_t* index = reinterpret_cast<const uint32_t*>(data + header.indexOffset);
+		for (uint32_t i = 0; i < buckets; ++i)
+			if (index[i] > header.entryCount)
+				return false;
+		return true;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "PackFormat.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Prism {
+
+	/**
+	 * Asset pack (see PackFormat.h, written by PackWriter / Tools/Packer)
+	 * mapped into memory
+	 *
+	 * Opening maps the file and validates the table of contents, lookups
+	 * hash the name and probe the index. Uncompressed entries are views
+	 * into the mapping: no copy, valid as long as the archive is open.
+	 * Compressed entries are Read into a buffer, their blocks are
+	 * decompressed in parallel on the TaskSystem.
+	 */
+	class PackArchive {
+	public:
+		// false (and logged) if the file can't be mapped or isn't a valid pack
+		bool Open(const std::string& filepath);
+		void Close();
+		bool IsOpen() const { return m_Header != nullptr; }
+
+		// index of the named entry, nullopt if there is none
+		std::optional<uint32_t> FindEntry(std::string_view name) const;
+		// view of the data of the named entry, nullopt if there is none or it is compressed
+		std::optional<std::string_view> Find(std::string_view name) const;
+		// data of the named entry (decompressed or copied), nullopt if there is none
+		std::optional<std::string> Load(std::string_view name) const;
+
+		/**
+		 * Decompresses (or copies) an entry into destination, which must
+		 * hold GetSize(index) bytes. With parallel, the blocks of large
+		 * entries are spread over the TaskSystem workers.
+		 *
+		 * @returns false (and logs) if the data is corrupt
+		 */
+		bool Read(uint32_t index, void* destination, bool parallel = true) const;
+
+		uint32_t GetEntryCount() const { return m_Header ? m_Header->entryCount : 0; }
+		std::string_view GetName(uint32_t index) const;
+		uint64_t GetSize(uint32_t index) const { return m_Entries[index].size; }
+		bool IsCompressed(uint32_t index) const { return m_Entries[index].flags & PackFormat::Compressed; }
+		// the stored data, only usable as is if the entry isn't compressed
+		std::string_view GetData(uint32_t index) const;
+		const std::string& GetPath() const { return m_Path; }
+
+	private:
+		bool validate() const;
+		bool readBlock(const PackFormat::Entry& entry, uint32_t block, uint8_t* destination) const;
+
+	private:
+		MappedFile m_File;
+		std::string m_Path;
+		const PackFormat::Header* m_Header = nullptr;
+		const PackFormat::Entry* m_Entries = nullptr;
+		const PackFormat::Block* m_Blocks = nullptr;
+		const uint32_t* m_Index = nullptr;
+		const char* m_Names = nullptr;
+	};
+}
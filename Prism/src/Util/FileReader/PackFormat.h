@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * On-disk layout of asset packs (PackWriter writes, PackArchive maps)
+ *
+ * File: Header, then the table of contents (entryCount Entries), the block
+ * table (blockCount Blocks), the name index, the names and finally the
+ * entry data. The tables and the index are 8 byte aligned, every entry's
+ * data is DataAlignment aligned, so the mapped file can be used in place.
+ * All values little endian.
+ *
+ * Compressed entries are split into blocks of blockSize bytes (the last
+ * one may be shorter), each compressed on its own (BlockCompression, LZ4
+ * block format) so they can be decompressed in parallel. Blocks that don't
+ * get smaller are stored raw. Uncompressed entries have no blocks.
+ *
+ * The name index is an open-addressing table of indexBuckets (a power of
+ * two) u32 values: entry index + 1, 0 for empty buckets. Names are hashed
+ * with Hash (FNV-1a), which is the same on every platform.
+ */
+namespace Prism::PackFormat {
+
+	constexpr char Magic[8] = { 'P', 'R', 'P', 'A', 'C', 'K', '\0', '\0' };
+	constexpr uint32_t Version = 2;
+	constexpr uint64_t DataAlignment = 16;
+	constexpr uint32_t DefaultBlockSize = 64 * 1024;
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t entryCount;
+		uint64_t tocOffset;
+		uint64_t blocksOffset;
+		uint32_t blockCount;
+		uint32_t blockSize; // uncompressed bytes per block
+		uint64_t indexOffset;
+		uint32_t indexBuckets;
+		uint32_t reserved;
+		uint64_t namesOffset;
+		uint64_t dataOffset;
+		uint64_t size; // of the whole file
+	};
+
+	enum EntryFlags : uint32_t {
+		Compressed = 1 // data is in blocks
+	};
+
+	struct Entry {
+		uint64_t nameHash;
+		uint64_t offset; // of the data, from the start of the file
+		uint64_t size; // uncompressed
+		uint64_t storedSize; // in the file
+		uint32_t nameOffset; // from namesOffset
+		uint32_t nameLength;
+		uint32_t firstBlock; // Compressed only, (size + blockSize - 1) / blockSize blocks
+		uint32_t flags; // EntryFlags
+	};
+
+	enum BlockFlags : uint32_t {
+		Raw = 1 // stored uncompressed
+	};
+
+	struct Block {
+		uint64_t offset; // from the start of the file
+		uint32_t storedSize;
+		uint32_t flags; // BlockFlags
+	};
+
+	constexpr uint64_t Hash(std::string_view name)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : name)
+			hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+		return hash;
+	}
+
+	constexpr uint64_t Align(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
@@ -0,0 +1,167 @@
+#include "PackWriter.h"
+#include "PackFormat.h"
+
+#include "Util/Compression/BlockCompression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Prism {
+
+	void PackWriter::Add(const std::string& name, std::string data, bool compress)
+	{
+		auto [it, inserted] = m_Indices.emplace(name, m_Entries.size());
+		if (inserted)
+			m_Entries.push_back({ name, std::move(data), compress });
+		else
+			m_Entries[it->second] = { name, std::move(data), compress };
+	}
+
+	bool PackWriter::AddFile(const std::string& name, const std::string& filepath, bool compress)
+	{
+		std::ifstream in(filepath, std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+
+		std::string data;
+		in.seekg(0, std::ios::end);
+		data.resize(static_cast<size_t>(in.tellg()));
+		in.seekg(0, std::ios::beg);
+		in.read(data.data(), data.size());
+		if (!in)
+			return false;
+
+		Add(name, std::move(data), compress);
+		return true;
+	}
+
+	// compresses data block by block into stored, block offsets relative to the entry
+	static bool compressBlocks(const std::string& data, std::string& stored, std::vector<PackFormat::Block>& blocks)
+	{
+		const uint32_t blockSize = PackFormat::DefaultBlockSize;
+		std::string buffer(BlockCompression::GetMaxCompressedSize(blockSize), '\0');
+		bool smaller = false;
+		for (size_t offset = 0; offset < data.size(); offset += blockSize)
+		{
+			const size_t size = std::min<size_t>(blockSize, data.size() - offset);
+			const uint8_t* source = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+			size_t compressed = BlockCompression::Compress(source, size, reinterpret_cast<uint8_t*>(&buffer[0]), buffer.size());
+
+			PackFormat::Block block{ stored.size(), 0, 0 };
+			if (compressed == 0 || compressed >= size)
+			{
+				block.storedSize = static_cast<uint32_t>(size);
+				block.flags = PackFormat::Raw;
+				stored.append(reinterpret_cast<const char*>(source), size);
+			}
+			else
+			{
+				block.storedSize = static_cast<uint32_t>(compressed);
+				stored.append(buffer.data(), compressed);
+				smaller = true;
+			}
+			blocks.push_back(block);
+		}
+		return smaller;
+	}
+
+	bool PackWriter::Write(const std::string& filepath, std::string& error) const
+	{
+		const uint32_t count = static_cast<uint32_t>(m_Entries.size());
+		uint32_t buckets = 16;
+		while (buckets < count * 2) buckets *= 2; // load factor <= 1/2
+
+		// compressed data first, it determines the sizes
+		std::vector<PackFormat::Entry> toc(count);
+		std::vector<PackFormat::Block> blocks;
+		std::vector<std::string> compressed(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			toc[i].size = m_Entries[i].data.size();
+			toc[i].storedSize = toc[i].size;
+
+			std::vector<PackFormat::Block> entryBlocks;
+			if (m_Entries[i].compress && compressBlocks(m_Entries[i].data, compressed[i], entryBlocks))
+			{
+				toc[i].flags = PackFormat::Compressed;
+				toc[i].firstBlock = static_cast<uint32_t>(blocks.size());
+				toc[i].storedSize = compressed[i].size();
+				blocks.insert(blocks.end(), entryBlocks.begin(), entryBlocks.end());
+			}
+			else
+				compressed[i].clear(); // stored as is
+		}
+
+		// layout
+		PackFormat::Header header{};
+		std::memcpy(header.magic, PackFormat::Magic, sizeof(PackFormat::Magic));
+		header.version = PackFormat::Version;
+		header.entryCount = count;
+		header.tocOffset = PackFormat::Align(sizeof(PackFormat::Header), 8);
+		header.blocksOffset = PackFormat::Align(header.tocOffset + count * sizeof(PackFormat::Entry), 8);
+		header.blockCount = static_cast<uint32_t>(blocks.size());
+		header.blockSize = PackFormat::DefaultBlockSize;
+		header.indexOffset = PackFormat::Align(header.blocksOffset + blocks.size() * sizeof(PackFormat::Block), 8);
+		header.indexBuckets = buckets;
+		header.namesOffset = header.indexOffset + buckets * sizeof(uint32_t);
+
+		std::string names;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			toc[i].nameHash = PackFormat::Hash(m_Entries[i].name);
+			toc[i].nameOffset = static_cast<uint32_t>(names.size());
+			toc[i].nameLength = static_cast<uint32_t>(m_Entries[i].name.size());
+			names += m_Entries[i].name;
+		}
+
+		header.dataOffset = PackFormat::Align(header.namesOffset + names.size(), PackFormat::DataAlignment);
+		uint64_t offset = header.dataOffset;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			toc[i].offset = offset;
+			if (toc[i].flags & PackFormat::Compressed)
+				for (uint32_t block = 0; block < (toc[i].size + header.blockSize - 1) / header.blockSize; ++block)
+					blocks[toc[i].firstBlock + block].offset += offset;
+			offset = PackFormat::Align(offset + toc[i].storedSize, PackFormat::DataAlignment);
+		}
+		header.size = offset;
+
+		std::vector<uint32_t> index(buckets, 0);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint32_t bucket = static_cast<uint32_t>(toc[i].nameHash) & (buckets - 1);
+			while (index[bucket] != 0) bucket = (bucket + 1) & (buckets - 1);
+			index[bucket] = i + 1;
+		}
+
+		// everything up to the data is written at once, then the (padded) data
+		std::string metadata(header.dataOffset, '\0');
+		std::memcpy(&metadata[0], &header, sizeof(header));
+		if (count > 0) std::memcpy(&metadata[header.tocOffset], toc.data(), count * sizeof(PackFormat::Entry));
+		if (!blocks.empty()) std::memcpy(&metadata[header.blocksOffset], blocks.data(), blocks.size() * sizeof(PackFormat::Block));
+		std::memcpy(&metadata[header.indexOffset], index.data(), buckets * sizeof(uint32_t));
+		std::memcpy(&metadata[header.namesOffset], names.data(), names.size());
+
+		std::ofstream out(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			error = "could not open '" + filepath + "' for writing";
+			return false;
+		}
+		out.write(metadata.data(), metadata.size());
+		static const char padding[PackFormat::DataAlignment] = {};
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const std::string& stored = (toc[i].flags & PackFormat::Compressed) ? compressed[i] : m_Entries[i].data;
+			out.write(stored.data(), stored.size());
+			out.write(padding, PackFormat::Align(toc[i].storedSize, PackFormat::DataAlignment) - toc[i].storedSize);
+		}
+		if (!out)
+		{
+			error = "could not write '" + filepath + "'";
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Prism {
+
+	/**
+	 * Builds an asset pack (see PackFormat.h) in memory and writes it
+	 *
+	 * Only depends on the standard library, Tools/Packer compiles it in.
+	 */
+	class PackWriter {
+	public:
+		/**
+		 * Adds (or replaces) an entry, names use '/' as separator
+		 *
+		 * Compressed entries are stored in independently compressed blocks,
+		 * unless that doesn't make them smaller (stored as is then).
+		 */
+		void Add(const std::string& name, std::string data, bool compress = false);
+		// false if the file can't be read
+		bool AddFile(const std::string& name, const std::string& filepath, bool compress = false);
+
+		// false (with a description in error) if the file can't be written
+		bool Write(const std::string& filepath, std::string& error) const;
+
+		size_t GetEntryCount() const { return m_Entries.size(); }
+
+	private:
+		struct Entry {
+			std::string name;
+			std::string data;
+			bool compress;
+		};
+		std::vector<Entry> m_Entries; // in the order they were added
+		std::unordered_map<std::string, size_t> m_Indices;
+	};
+}
@@ -0,0 +1,339 @@
+#include "VirtualFileSystem.h"
+
+#include "Core/Memory/Epoch.h"
+#include "Util/FileReader/FileReader.h"
+#include "Util/FileReader/PackArchive.h"
+#include "Util/Log/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace Prism {
+
+	struct VirtualMount {
+		enum class Kind { Directory, Pack, Memory };
+
+		Kind kind = Kind::Directory;
+		VirtualFileSystem::MountID id = 0;
+		std::string mountPoint; // normalized, empty for the root
+		std::string directory; // Directory
+		std::vector<std::string> names; // Directory, Memory: paths relative to the mount point
+		std::vector<std::string> contents; // Memory
+		PackArchive pack; // Pack
+	};
+
+	// where the file of a virtual path is
+	struct VirtualEntry {
+		std::string path;
+		std::shared_ptr<const VirtualMount> mount;
+		uint32_t index; // into names / contents / the pack's entries
+	};
+
+	// all files of all mounts by path hash, immutable once published
+	struct VirtualPathTable {
+		std::unordered_multimap<uint64_t, VirtualEntry> entries;
+	};
+
+	std::mutex g_MountMutex; // for changes, lookups only use the published table
+	std::vector<std::shared_ptr<const VirtualMount>> g_Mounts; // in mount order
+	VirtualFileSystem::MountID g_NextMountID = 1;
+	std::atomic<VirtualPathTable*> g_PathTable = nullptr;
+
+#if defined(_WIN32)
+	constexpr bool c_CaseInsensitive = true; // like the OS, paths that differ only in case are the same file
+#else
+	constexpr bool c_CaseInsensitive = false;
+#endif
+
+	static bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+
+	// '/' separated, without empty and "." segments (lower case on Windows), returns path itself if it is clean already
+	static std::string_view normalize(std::string_view path, std::string& buffer)
+	{
+		const bool clean = path.find('\\') == std::string_view::npos && path.find("//") == std::string_view::npos
+			&& (path.empty() || (path.front() != '/' && path.back() != '/'))
+			&& path != "." && path.substr(0, 2) != "./" && path.find("/./") == std::string_view::npos
+			&& (path.size() < 2 || path.substr(path.size() - 2) != "/.")
+			&& (!c_CaseInsensitive || std::none_of(path.begin(), path.end(), isUpper));
+		if (clean)
+			return path;
+
+		buffer.clear();
+		for (size_t begin = 0; begin <= path.size();)
+		{
+			const size_t end = std::min(path.find_first_of("/\\", begin), path.size());
+			const std::string_view segment = path.substr(begin, end - begin);
+			if (!segment.empty() && segment != ".")
+			{
+				if (!buffer.empty()) buffer += '/';
+				buffer += segment;
+			}
+			begin = end + 1;
+		}
+		if (c_CaseInsensitive)
+			for (char& c : buffer)
+				if (isUpper(c)) c += 'a' - 'A';
+		return buffer;
+	}
+
+	static std::string join(const std::string& mountPoint, std::string_view path)
+	{
+		std::string result = mountPoint;
+		if (!result.empty()) result += '/';
+		result += path;
+		return result;
+	}
+
+	static std::vector<std::string> scanDirectory(const std::string& directory)
+	{
+		std::vector<std::string> names;
+		std::error_code error;
+		for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+			if (it->is_regular_file(error))
+				names.push_back(it->path().lexically_relative(directory).generic_string());
+		return names;
+	}
+
+	// rebuilds the path table from g_Mounts, g_MountMutex must be held
+	static void publishPathTable()
+	{
+		auto* table = new VirtualPathTable();
+		auto add = [table](const std::shared_ptr<const VirtualMount>& mount, std::string path, uint32_t index)
+		{
+			const uint64_t hash = PackFormat::Hash(path);
+			auto [begin, end] = table->entries.equal_range(hash);
+			for (auto it = begin; it != end; ++it)
+				if (it->second.path == path)
+				{
+					it->second = { std::move(path), mount, index }; // later mounts override
+					return;
+				}
+			table->entries.emplace(hash, VirtualEntry{ std::move(path), mount, index });
+		};
+
+		std::string buffer;
+		for (const auto& mount : g_Mounts)
+		{
+			if (mount->kind == VirtualMount::Kind::Pack)
+				for (uint32_t i = 0; i < mount->pack.GetEntryCount(); ++i)
+					add(mount, join(mount->mountPoint, normalize(mount->pack.GetName(i), buffer)), i);
+			else
+				for (uint32_t i = 0; i < mount->names.size(); ++i)
+					add(mount, join(mount->mountPoint, normalize(mount->names[i], buffer)), i); // names keep their case, for the OS
+		}
+
+		// readers may still be in the old table
+		if (VirtualPathTable* old = g_PathTable.exchange(table, std::memory_order_acq_rel))
+			Epoch::Retire(old);
+	}
+
+	static VirtualFileSystem::MountID addMount(std::shared_ptr<VirtualMount> mount, std::string_view source)
+	{
+		std::lock_guard<std::mutex> lock(g_MountMutex);
+		mount->id = g_NextMountID++;
+		g_Mounts.push_back(mount);
+		publishPathTable();
+		PR_CORE_INFO("Mounted '{0}' at '{1}' ({2} files)", source, mount->mountPoint,
+			mount->kind == VirtualMount::Kind::Pack ? mount->pack.GetEntryCount() : mount->names.size());
+		return mount->id;
+	}
+
+	// the entry for a normalized path, must be called within an Epoch::Guard
+	static const VirtualEntry* findEntry(std::string_view path)
+	{
+		const VirtualPathTable* table = g_PathTable.load(std::memory_order_acquire);
+		if (!table)
+			return nullptr;
+		auto [begin, end] = table->entries.equal_range(PackFormat::Hash(path));
+		for (auto it = begin; it != end; ++it)
+			if (it->second.path == path)
+				return &it->second;
+		return nullptr;
+	}
+
+	VirtualFileSystem::MountID VirtualFileSystem::MountDirectory(std::string_view mountPoint, const std::string& directory)
+	{
+		std::error_code error;
+		if (!fs::is_directory(directory, error))
+		{
+			PR_CORE_ERROR("Could not mount directory '{0}'", directory);
+			return 0;
+		}
+
+		std::string buffer;
+		auto mount = std::make_shared<VirtualMount>();
+		mount->kind = VirtualMount::Kind::Directory;
+		mount->mountPoint = normalize(mountPoint, buffer);
+		mount->directory = directory;
+		mount->names = scanDirectory(directory);
+		return addMount(std::move(mount), directory);
+	}
+
+	VirtualFileSystem::MountID VirtualFileSystem::MountPack(std::string_view mountPoint, const std::string& packPath)
+	{
+		std::string buffer;
+		auto mount = std::make_shared<VirtualMount>();
+		mount->kind = VirtualMount::Kind::Pack;
+		mount->mountPoint = normalize(mountPoint, buffer);
+		if (!mount->pack.Open(packPath))
+		{
+			PR_CORE_ERROR("Could not mount pack '{0}'", packPath);
+			return 0;
+		}
+		return addMount(std::move(mount), packPath);
+	}
+
+	VirtualFileSystem::MountID VirtualFileSystem::MountMemory(std::string_view mountPoint, std::vector<std::pair<std::string, std::string>> files)
+	{
+		std::string buffer;
+		auto mount = std::make_shared<VirtualMount>();
+		mount->kind = VirtualMount::Kind::Memory;
+		mount->mountPoint = normalize(mountPoint, buffer);
+		for (auto& [path, contents] : files)
+		{
+			mount->names.emplace_back(normalize(path, buffer));
+			mount->contents.push_back(std::move(contents));
+		}
+		return addMount(std::move(mount), "memory");
+	}
+
+	void VirtualFileSystem::Unmount(MountID mount)
+	{
+		std::lock_guard<std::mutex> lock(g_MountMutex);
+		auto it = std::find_if(g_Mounts.begin(), g_Mounts.end(), [mount](const auto& m) { return m->id == mount; });
+		if (it == g_Mounts.end())
+			return;
+		g_Mounts.erase(it);
+		publishPathTable();
+	}
+
+	void VirtualFileSystem::UnmountAll()
+	{
+		{
+			std::lock_guard<std::mutex> lock(g_MountMutex);
+			g_Mounts.clear();
+			publishPathTable();
+		}
+		Epoch::Collect();
+	}
+
+	void VirtualFileSystem::Rescan()
+	{
+		std::lock_guard<std::mutex> lock(g_MountMutex);
+		for (auto& mount : g_Mounts)
+			if (mount->kind == VirtualMount::Kind::Directory)
+			{
+				// mounts are shared with readers, so it's replaced
+				auto rescanned = std::make_shared<VirtualMount>();
+				rescanned->id = mount->id;
+				rescanned->mountPoint = mount->mountPoint;
+				rescanned->directory = mount->directory;
+				rescanned->names = scanDirectory(mount->directory);
+				mount = std::move(rescanned);
+			}
+		publishPathTable();
+	}
+
+	bool VirtualFileSystem::Exists(std::string_view path)
+	{
+		std::string buffer;
+		const std::string_view normalized = normalize(path, buffer);
+		Epoch::Guard guard;
+		return findEntry(normalized) != nullptr;
+	}
+
+	// the mount and index of a file, the mount is nullptr (and it's logged) if there's no such file
+	static std::pair<std::shared_ptr<const VirtualMount>, uint32_t> lookup(std::string_view path)
+	{
+		std::string buffer;
+		const std::string_view normalized = normalize(path, buffer);
+
+		Epoch::Guard guard;
+		const VirtualEntry* entry = findEntry(normalized);
+		if (!entry)
+		{
+			PR_CORE_ERROR("Could not find file '{0}'", path);
+			return { nullptr, 0 };
+		}
+		return { entry->mount, entry->index };
+	}
+
+	std::optional<VirtualFile> VirtualFileSystem::Open(std::string_view path)
+	{
+		const auto [mount, index] = lookup(path);
+		return mount ? openFile(mount, index) : std::nullopt;
+	}
+
+	std::optional<VirtualFile> VirtualFileSystem::openFile(const std::shared_ptr<const VirtualMount>& mount, uint32_t index)
+	{
+		VirtualFile file;
+		switch (mount->kind)
+		{
+		case VirtualMount::Kind::Directory:
+		{
+			const std::string filepath = mount->directory + '/' + mount->names[index];
+			std::optional<std::string> data = FileReader::Read(filepath);
+			if (!data)
+			{
+				PR_CORE_ERROR("Could not read file '{0}'", filepath);
+				return std::nullopt;
+			}
+			file.m_Data = std::move(*data);
+			break;
+		}
+		case VirtualMount::Kind::Pack:
+			if (mount->pack.IsCompressed(index))
+			{
+				file.m_Data.resize(static_cast<size_t>(mount->pack.GetSize(index)));
+				if (!mount->pack.Read(index, file.m_Data.data()))
+					return std::nullopt;
+			}
+			else
+			{
+				file.m_View = mount->pack.GetData(index);
+				file.m_Source = mount;
+			}
+			break;
+		case VirtualMount::Kind::Memory:
+			file.m_View = mount->contents[index];
+			file.m_Source = mount;
+			break;
+		}
+		return file;
+	}
+
+	void VirtualFileSystem::OpenAsync(std::string_view path, OpenCallback callback)
+	{
+		const auto [mount, index] = lookup(path);
+		if (!mount || mount->kind != VirtualMount::Kind::Directory)
+		{
+			callback(mount ? openFile(mount, index) : std::nullopt);
+			return;
+		}
+
+		FileReader::ReadAsync({ mount->directory + '/' + mount->names[index] },
+			[callback = std::move(callback)](const std::string& filepath, std::optional<std::string> data)
+			{
+				if (!data)
+				{
+					callback(std::nullopt); // logged by the FileReader
+					return;
+				}
+				VirtualFile file;
+				file.m_Data = std::move(*data);
+				callback(std::move(file));
+			});
+	}
+
+	size_t VirtualFileSystem::GetFileCount()
+	{
+		Epoch::Guard guard;
+		const VirtualPathTable* table = g_PathTable.load(std::memory_order_acquire);
+		return table ? table->entries.size() : 0;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Prism {
+
+	struct VirtualMount;
+
+	/**
+	 * Contents of a file opened through the VirtualFileSystem
+	 *
+	 * Either a view into a mapped pack or a memory mount (no copy, the
+	 * mount stays alive while the VirtualFile does) or owned data (loose
+	 * files, compressed pack entries).
+	 */
+	class VirtualFile {
+	public:
+		std::string_view GetView() const { return m_Source ? m_View : std::string_view(m_Data); }
+		const char* GetData() const { return GetView().data(); }
+		size_t GetSize() const { return GetView().size(); }
+
+	private:
+		friend class VirtualFileSystem;
+		std::string_view m_View; // borrowed from m_Source
+		std::string m_Data; // owned, if there is no m_Source
+		std::shared_ptr<const void> m_Source;
+	};
+
+	/**
+	 * Asset paths ("res/shaders/flat_test.glsl") resolved against ordered
+	 * mount points instead of the OS
+	 *
+	 * Every mount (a directory of loose files, a pack archive or files in
+	 * memory) puts its files below a mount point ("res"). Later mounts
+	 * override files of earlier ones, so a patch pack mounted after the
+	 * base data replaces single files.
+	 *
+	 * The files of all mounts are indexed in one hashed path table (rebuilt
+	 * on mount changes), a lookup is one probe however many mounts there
+	 * are, and doesn't touch the file system. Directories are scanned when
+	 * mounted, files added later are found after Rescan().
+	 *
+	 * Paths use '/', "\\", "." and empty segments are normalized away.
+	 * Lookups are case-sensitive, except on Windows (like the OS).
+	 * Lookups are lock-free and may run on any thread.
+	 */
+	class VirtualFileSystem {
+	public:
+		using MountID = uint32_t; // 0 is invalid
+		using OpenCallback = std::function<void(std::optional<VirtualFile> file)>;
+
+		// 0 (and logged) if the directory doesn't exist. Its files are listed now, see Rescan
+		static MountID MountDirectory(std::string_view mountPoint, const std::string& directory);
+		// 0 (and logged) if the pack can't be opened
+		static MountID MountPack(std::string_view mountPoint, const std::string& packPath);
+		// files as { path relative to the mount point, contents }
+		static MountID MountMemory(std::string_view mountPoint, std::vector<std::pair<std::string, std::string>> files);
+
+		// files opened from the mount stay valid
+		static void Unmount(MountID mount);
+		static void UnmountAll();
+		// scans the mounted directories again
+		static void Rescan();
+
+		static bool Exists(std::string_view path);
+		// nullopt (and logged) if no mount has the file or it can't be read
+		static std::optional<VirtualFile> Open(std::string_view path);
+		/**
+		 * Like Open, but loose files are read with FileReader::ReadAsync and
+		 * callback is called on a TaskSystem worker. Pack and memory files
+		 * are there already, callback is called right away for them.
+		 */
+		static void OpenAsync(std::string_view path, OpenCallback callback);
+		// number of distinct paths over all mounts
+		static size_t GetFileCount();
+
+	private:
+		static std::optional<VirtualFile> openFile(const std::shared_ptr<const VirtualMount>& mount, uint32_t index);
+	};
+}
@@ -0,0 +1,297 @@
+#include "Log.h"
+
+#include "Core/Memory/MemoryTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Prism {
+
+	using namespace BinaryLogFormat;
+
+	std::atomic<bool> BinaryLog::s_Open = false;
+
+	struct SiteKey {
+		const char* format;
+		const char* file;
+		int line;
+		spdlog::logger* logger;
+		spdlog::level::level_enum level;
+
+		bool operator==(const SiteKey& other) const
+		{
+			return format == other.format && file == other.file && line == other.line
+				&& logger == other.logger && level == other.level;
+		}
+	};
+
+	struct SiteKeyHash {
+		size_t operator()(const SiteKey& key) const
+		{
+			size_t hash = std::hash<const void*>()(key.format);
+			for (size_t value : { std::hash<const void*>()(key.file), size_t(key.line), std::hash<const void*>()(key.logger), size_t(key.level) })
+				hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+			return hash;
+		}
+	};
+
+	// the mapped file
+	uint8_t* g_BinaryView = nullptr;
+	size_t g_BinaryCapacity = 0;
+	std::atomic<size_t> g_BinaryOffset = 0;
+	std::atomic<uint64_t> g_BinaryDropped = 0;
+	std::string g_BinaryPath;
+#if defined(_WIN32)
+	HANDLE g_BinaryFile = INVALID_HANDLE_VALUE;
+	HANDLE g_BinaryMapping = nullptr;
+#else
+	int g_BinaryFile = -1;
+#endif
+
+	// call sites of the open file, the generation invalidates the per-thread caches on reopen
+	std::mutex g_SiteMutex;
+	std::unordered_map<SiteKey, uint32_t, SiteKeyHash> g_Sites;
+	std::atomic<uint32_t> g_SiteGeneration = 0;
+
+	// direct-mapped, a collision only costs a lookup in the shared map
+	constexpr uint32_t c_SiteCacheSize = 256;
+	struct SiteCache {
+		uint32_t generation = ~0u;
+		SiteKey keys[c_SiteCacheSize] = {};
+		uint32_t ids[c_SiteCacheSize] = {};
+	};
+	thread_local SiteCache t_Sites;
+
+	std::atomic<uint32_t> g_NextBinaryThread = 0;
+	thread_local uint32_t t_BinaryThread = g_NextBinaryThread.fetch_add(1, std::memory_order_relaxed);
+
+	static bool mapFile(const std::string& filepath, size_t capacity)
+	{
+#if defined(_WIN32)
+		g_BinaryFile = CreateFileA(filepath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+			CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (g_BinaryFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		g_BinaryMapping = CreateFileMappingA(g_BinaryFile, nullptr, PAGE_READWRITE,
+			static_cast<DWORD>(uint64_t(capacity) >> 32), static_cast<DWORD>(capacity), nullptr);
+		if (g_BinaryMapping)
+			g_BinaryView = static_cast<uint8_t*>(MapViewOfFile(g_BinaryMapping, FILE_MAP_WRITE, 0, 0, capacity));
+		if (!g_BinaryView)
+		{
+			if (g_BinaryMapping) CloseHandle(g_BinaryMapping);
+			CloseHandle(g_BinaryFile);
+			g_BinaryMapping = nullptr;
+			g_BinaryFile = INVALID_HANDLE_VALUE;
+			return false;
+		}
+#else
+		g_BinaryFile = open(filepath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (g_BinaryFile < 0)
+			return false;
+
+		void* view = MAP_FAILED;
+		if (ftruncate(g_BinaryFile, static_cast<off_t>(capacity)) == 0)
+			view = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, g_BinaryFile, 0);
+		if (view == MAP_FAILED)
+		{
+			close(g_BinaryFile);
+			g_BinaryFile = -1;
+			return false;
+		}
+		g_BinaryView = static_cast<uint8_t*>(view);
+#endif
+		return true;
+	}
+
+	static void unmapFile(size_t used)
+	{
+#if defined(_WIN32)
+		FlushViewOfFile(g_BinaryView, used);
+		UnmapViewOfFile(g_BinaryView);
+		CloseHandle(g_BinaryMapping);
+		LARGE_INTEGER size;
+		size.QuadPart = static_cast<LONGLONG>(used);
+		SetFilePointerEx(g_BinaryFile, size, nullptr, FILE_BEGIN);
+		SetEndOfFile(g_BinaryFile);
+		CloseHandle(g_BinaryFile);
+		g_BinaryMapping = nullptr;
+		g_BinaryFile = INVALID_HANDLE_VALUE;
+#else
+		msync(g_BinaryView, used, MS_SYNC);
+		munmap(g_BinaryView, g_BinaryCapacity);
+		if (ftruncate(g_BinaryFile, static_cast<off_t>(used)) != 0)
+			PR_CORE_WARN("Binary log {0} could not be truncated", g_BinaryPath);
+		close(g_BinaryFile);
+		g_BinaryFile = -1;
+#endif
+		g_BinaryView = nullptr;
+	}
+
+	// entries are 8 byte aligned, so headers can be read in place
+	static uint8_t* reserve(size_t size)
+	{
+		size = (size + 7) & ~size_t(7);
+		const size_t offset = g_BinaryOffset.fetch_add(size, std::memory_order_relaxed);
+		if (offset + size > g_BinaryCapacity)
+		{
+			g_BinaryDropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		uint8_t* entry = g_BinaryView + offset;
+		reinterpret_cast<EntryHeader*>(entry)->size = static_cast<uint32_t>(size);
+		return entry;
+	}
+
+	void BinaryLog::commit(uint8_t* entry)
+	{
+		// the type goes last, a crashed writer leaves a Pending entry the decoder skips
+		std::atomic_thread_fence(std::memory_order_release);
+		reinterpret_cast<EntryHeader*>(entry)->type = EntryType::Message;
+	}
+
+	bool BinaryLog::Open(const std::string& filepath, size_t capacity)
+	{
+		if (IsOpen()) Close();
+		PR_CORE_ASSERT(capacity >= sizeof(FileHeader) && capacity <= (size_t(1) << 40), "Binary log capacity out of range!");
+
+		if (!mapFile(filepath, capacity))
+		{
+			PR_CORE_ERROR("Binary log {0} could not be created", filepath);
+			return false;
+		}
+
+		FileHeader header{};
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.version = Version;
+		header.headerSize = sizeof(FileHeader);
+		std::memcpy(g_BinaryView, &header, sizeof(header));
+
+		g_BinaryPath = filepath;
+		g_BinaryCapacity = capacity;
+		g_BinaryOffset = sizeof(FileHeader);
+		g_BinaryDropped = 0;
+		{
+			std::lock_guard<std::mutex> lock(g_SiteMutex);
+			g_Sites.clear();
+			g_SiteGeneration.fetch_add(1);
+		}
+
+		s_Open = true;
+		PR_CORE_INFO("Binary log {0} opened ({1} MB)", filepath, capacity >> 20);
+		return true;
+	}
+
+	void BinaryLog::Close()
+	{
+		if (!IsOpen()) return;
+		s_Open = false;
+
+		const size_t used = std::min(g_BinaryOffset.load(), g_BinaryCapacity);
+		reinterpret_cast<FileHeader*>(g_BinaryView)->size = used;
+		unmapFile(used);
+
+		const uint64_t dropped = g_BinaryDropped.load();
+		if (dropped > 0)
+			PR_CORE_WARN("Binary log {0} full, {1} messages dropped", g_BinaryPath, dropped);
+		PR_CORE_INFO("Binary log {0} closed ({1} KB, {2} call sites)", g_BinaryPath, used >> 10, g_Sites.size());
+	}
+
+	uint64_t BinaryLog::GetDroppedCount()
+	{
+		return g_BinaryDropped.load();
+	}
+
+	static uint8_t* writeString(uint8_t* out, std::string_view string)
+	{
+		const uint32_t length = static_cast<uint32_t>(string.size());
+		std::memcpy(out, &length, sizeof(length));
+		std::memcpy(out + sizeof(length), string.data(), length);
+		return out + sizeof(length) + length;
+	}
+
+	uint32_t BinaryLog::site(const char* format, spdlog::logger* logger, spdlog::level::level_enum level,
+		const spdlog::source_loc& location)
+	{
+		const SiteKey key{ format, location.filename, location.line, logger, level };
+
+		// thread-local lookup first, the shared map only on the first call per thread and site
+		const uint32_t generation = g_SiteGeneration.load(std::memory_order_relaxed);
+		if (t_Sites.generation != generation)
+		{
+			std::fill(std::begin(t_Sites.keys), std::end(t_Sites.keys), SiteKey{});
+			t_Sites.generation = generation;
+		}
+		const uint32_t slot = static_cast<uint32_t>(SiteKeyHash()(key)) & (c_SiteCacheSize - 1);
+		if (t_Sites.keys[slot] == key)
+			return t_Sites.ids[slot];
+
+		PR_MEMORY_TAG(Log);
+		std::lock_guard<std::mutex> lock(g_SiteMutex);
+		auto itr = g_Sites.find(key);
+		if (itr == g_Sites.end())
+		{
+			const uint32_t id = static_cast<uint32_t>(g_Sites.size());
+			itr = g_Sites.emplace(key, id).first;
+
+			const std::string_view name = logger->name();
+			const std::string_view file = location.filename ? location.filename : "";
+			const std::string_view function = location.funcname ? location.funcname : "";
+			const std::string_view formatString = format ? format : "";
+			const size_t size = sizeof(EntryHeader) + sizeof(SiteHeader) + 4 * sizeof(uint32_t)
+				+ name.size() + file.size() + function.size() + formatString.size();
+
+			// site entries are written before their ID is handed out, so they precede all their messages
+			if (uint8_t* entry = reserve(size))
+			{
+				SiteHeader header{};
+				header.id = id;
+				header.line = static_cast<uint32_t>(location.line);
+				header.level = static_cast<uint8_t>(level);
+				std::memcpy(entry + sizeof(EntryHeader), &header, sizeof(header));
+
+				uint8_t* out = entry + sizeof(EntryHeader) + sizeof(SiteHeader);
+				for (std::string_view string : { name, file, function, formatString })
+					out = writeString(out, string);
+
+				std::atomic_thread_fence(std::memory_order_release);
+				reinterpret_cast<EntryHeader*>(entry)->type = EntryType::Site;
+			}
+		}
+
+		t_Sites.keys[slot] = key;
+		t_Sites.ids[slot] = itr->second;
+		return itr->second;
+	}
+
+	uint8_t* BinaryLog::beginMessage(size_t size, uint32_t site, uint16_t argCount, uint8_t flags)
+	{
+		uint8_t* entry = reserve(size);
+		if (!entry)
+			return nullptr;
+
+		MessageHeader header{};
+		header.site = site;
+		header.thread = t_BinaryThread;
+		header.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			spdlog::log_clock::now().time_since_epoch()).count());
+		header.argCount = argCount;
+		header.flags = flags;
+		std::memcpy(entry + sizeof(EntryHeader), &header, sizeof(header));
+		return entry;
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "BinaryLogFormat.h"
+
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Prism {
+
+	/**
+	 * Binary structured log (included by Log.h, used through Log::Write)
+	 *
+	 * While open, log calls don't format at all: they append the call site ID,
+	 * timestamp, thread ID and the raw argument bytes to a memory-mapped file.
+	 * Call sites (logger, level, location, format string) are written once
+	 * per file. Tools/LogDecoder turns the file back into spdlog's text format
+	 * ("LogDecoder <file> [pattern] > log.txt", the pattern defaults to Log::Init's).
+	 * Applications open it through Application::EngineProperties::binaryLogPath.
+	 *
+	 * Arguments must be arithmetic, enums or strings; other calls (and runtime
+	 * format strings) are formatted on the calling thread and stored as text.
+	 * The file has a fixed capacity, messages beyond it are dropped.
+	 *
+	 * Open/Close must be called while no other thread logs.
+	 */
+	class BinaryLog
+	{
+	public:
+		static bool Open(const std::string& filepath, size_t capacity = 64 << 20);
+		static void Close(); // truncates the file to the bytes in use
+		static bool IsOpen() { return s_Open.load(std::memory_order_relaxed); }
+		static uint64_t GetDroppedCount();
+
+		// Format is deduced as a reference, so const literals can be told from char buffers
+		template<typename Format, typename... Args>
+		static void Write(spdlog::logger* logger, spdlog::level::level_enum level,
+			const spdlog::source_loc& location, Format&& format, const Args&... args);
+
+	private:
+		template<typename T>
+		struct IsString : std::bool_constant<std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value
+			|| std::is_same<T, const char*>::value || std::is_same<T, char*>::value> {};
+
+		template<typename T>
+		struct IsEncodable : std::bool_constant<std::is_arithmetic<T>::value || std::is_enum<T>::value || IsString<T>::value> {};
+
+		template<typename T>
+		static std::string_view toString(const T& value)
+		{
+			if constexpr (std::is_pointer<T>::value) return value ? std::string_view(value) : std::string_view("(null)");
+			else return std::string_view(value);
+		}
+
+		template<typename T>
+		static size_t argSize(const T& value)
+		{
+			if constexpr (IsString<T>::value) return 1 + sizeof(uint32_t) + toString(value).size();
+			else return 1 + sizeof(uint64_t);
+		}
+
+		template<typename T>
+		static uint8_t* writeArg(uint8_t* out, const T& value)
+		{
+			using BinaryLogFormat::ArgType;
+			ArgType type = ArgType::UInt;
+			uint64_t bits = 0;
+			if constexpr (IsString<T>::value)
+			{
+				const std::string_view string = toString(value);
+				const uint32_t length = static_cast<uint32_t>(string.size());
+				*out++ = static_cast<uint8_t>(ArgType::String);
+				std::memcpy(out, &length, sizeof(length));
+				std::memcpy(out + sizeof(length), string.data(), length);
+				return out + sizeof(length) + length;
+			}
+			else if constexpr (std::is_enum<T>::value)
+				return writeArg(out, static_cast<std::underlying_type_t<T>>(value));
+			else if constexpr (std::is_same<T, bool>::value)
+			{
+				type = ArgType::Bool; bits = value ? 1 : 0;
+			}
+			else if constexpr (std::is_same<T, char>::value)
+			{
+				type = ArgType::Char; bits = static_cast<unsigned char>(value);
+			}
+			else if constexpr (std::is_same<T, float>::value)
+			{
+				type = ArgType::Float;
+				std::memcpy(&bits, &value, sizeof(value));
+			}
+			else if constexpr (std::is_floating_point<T>::value)
+			{
+				type = ArgType::Double;
+				const double d = static_cast<double>(value);
+				std::memcpy(&bits, &d, sizeof(d));
+			}
+			else if constexpr (std::is_signed<T>::value)
+			{
+				type = ArgType::Int;
+				const int64_t i = static_cast<int64_t>(value);
+				std::memcpy(&bits, &i, sizeof(i));
+			}
+			else
+			{
+				type = ArgType::UInt; bits = static_cast<uint64_t>(value);
+			}
+			*out++ = static_cast<uint8_t>(type);
+			std::memcpy(out, &bits, sizeof(bits));
+			return out + sizeof(bits);
+		}
+
+		// ID of the call site, registered (and written to the file) on first use; format is nullptr if not a literal
+		static uint32_t site(const char* format, spdlog::logger* logger, spdlog::level::level_enum level,
+			const spdlog::source_loc& location);
+		// reserves a message entry of the given size and fills its headers, nullptr if the file is full
+		static uint8_t* beginMessage(size_t size, uint32_t site, uint16_t argCount, uint8_t flags);
+		static void commit(uint8_t* entry);
+
+		static std::atomic<bool> s_Open;
+	};
+
+	template<typename Format, typename... Args>
+	void BinaryLog::Write(spdlog::logger* logger, spdlog::level::level_enum level,
+		const spdlog::source_loc& location, Format&& format, const Args&... args)
+	{
+		using FormatType = std::remove_reference_t<Format>;
+		constexpr size_t headerSize = sizeof(BinaryLogFormat::EntryHeader) + sizeof(BinaryLogFormat::MessageHeader);
+		// sites are registered by the format's address, only const arrays (literals) keep their text
+		constexpr bool literal = std::is_array<FormatType>::value && std::is_const<std::remove_extent_t<FormatType>>::value;
+
+		if constexpr (literal && (IsEncodable<std::decay_t<const Args&>>::value && ...) && sizeof...(Args) < 0x10000)
+		{
+			const uint32_t id = site(format, logger, level, location);
+			const size_t size = headerSize + (size_t(0) + ... + argSize<std::decay_t<const Args&>>(args));
+			uint8_t* entry = beginMessage(size, id, static_cast<uint16_t>(sizeof...(Args)), 0);
+			if (!entry)
+				return;
+
+			uint8_t* out = entry + headerSize;
+			((out = writeArg<std::decay_t<const Args&>>(out, args)), ...);
+			commit(entry);
+		}
+		else
+		{
+			std::string message;
+			if constexpr (sizeof...(Args) == 0)
+				message = fmt::to_string(format);
+			else
+				message = fmt::vformat(fmt::string_view(format), fmt::make_format_args(args...));
+
+			const char* siteFormat = nullptr;
+			if constexpr (literal) siteFormat = format;
+			const uint32_t id = site(siteFormat, logger, level, location);
+			uint8_t* entry = beginMessage(headerSize + argSize(message), id, 1, BinaryLogFormat::Preformatted);
+			if (!entry)
+				return;
+
+			writeArg(entry + headerSize, message);
+			commit(entry);
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * On-disk layout of binary logs (BinaryLog writes, Tools/LogDecoder reads)
+ *
+ * File: FileHeader, then entries. Every entry starts with an EntryHeader;
+ * its size is written on reservation and its type last, so entries of a
+ * crashed writer (type Pending) can be skipped. All values little endian,
+ * unaligned.
+ *
+ * Site:    EntryHeader, SiteHeader, then logger name, file, function and
+ *          format string, each as u32 length + bytes
+ * Message: EntryHeader, MessageHeader, then argCount arguments as ArgType
+ *          byte + 8 byte value (String: u32 length + bytes)
+ */
+namespace Prism::BinaryLogFormat {
+
+	constexpr char Magic[8] = { 'P', 'R', 'B', 'L', 'O', 'G', '\0', '\0' };
+	constexpr uint32_t Version = 1;
+
+	struct FileHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize; // offset of the first entry
+		uint64_t size; // bytes in use, written on close (0 if the writer crashed)
+	};
+
+	enum class EntryType : uint8_t {
+		Pending = 0,
+		Site = 1,
+		Message = 2
+	};
+
+	struct EntryHeader {
+		uint32_t size; // including this header
+		EntryType type;
+		uint8_t reserved[3];
+	};
+
+	struct SiteHeader {
+		uint32_t id;
+		uint32_t line;
+		uint8_t level; // spdlog::level::level_enum
+		uint8_t reserved[3];
+	};
+
+	enum MessageFlags : uint8_t {
+		Preformatted = 1 // the only argument is the complete message text
+	};
+
+	struct MessageHeader {
+		uint32_t site;
+		uint32_t thread;
+		uint64_t timestamp; // nanoseconds since the system_clock epoch
+		uint16_t argCount;
+		uint8_t flags;
+		uint8_t reserved[5];
+	};
+
+	enum class ArgType : uint8_t {
+		Int, // int64_t
+		UInt, // uint64_t
+		Double,
+		Bool, // uint64_t 0/1
+		Char, // uint64_t
+		String, // u32 length + bytes
+		Float // float in the low 4 bytes, so it formats like the float spdlog got
+	};
+}
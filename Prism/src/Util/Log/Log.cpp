@@ -1,25 +1,351 @@
 #include "Log.h"
 
+#include "Core/Memory/MemoryTracker.h"
+
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace Prism {
 
-	std::shared_ptr<spdlog::logger> Log::s_CoreLogger;
-	std::shared_ptr<spdlog::logger> Log::s_LuaLogger;
-	std::shared_ptr<spdlog::logger> Log::s_AppLogger;
+	std::shared_ptr<spdlog::logger> Log::s_Loggers[static_cast<size_t>(Category::Count)];
+	std::atomic<spdlog::level::level_enum> Log::s_Levels[static_cast<size_t>(Category::Count)];
+	std::atomic<bool> Log::s_Async = false;
+
+	constexpr const char* c_CategoryNames[] = { "Core", "Lua", "App", "Tasks", "Resources", "Vulkan", "ECS" };
+	static_assert(std::size(c_CategoryNames) == static_cast<size_t>(Log::Category::Count), "Log category without a name!");
+
+#ifdef PR_DEBUG
+	constexpr spdlog::level::level_enum c_DefaultLevel = spdlog::level::trace;
+#else
+	constexpr spdlog::level::level_enum c_DefaultLevel = spdlog::level::warn;
+#endif
 
 	void Log::Init()
 	{
+		PR_MEMORY_TAG(Log);
 		spdlog::set_pattern("%^[%T] %n: %v (%s:%#)%$");
 
-		s_CoreLogger = spdlog::stdout_color_mt("Core");
-		s_LuaLogger = spdlog::stdout_color_mt("Lua");
-		s_AppLogger = spdlog::stdout_color_mt("App");
+		// one sink, so the categories don't interleave within a line
+		auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+		for (size_t i = 0; i < static_cast<size_t>(Category::Count); ++i)
+		{
+			s_Loggers[i] = std::make_shared<spdlog::logger>(c_CategoryNames[i], sink);
+			spdlog::initialize_logger(s_Loggers[i]);
+			SetLevel(static_cast<Category>(i), c_DefaultLevel);
+		}
+
+		spdlog::set_default_logger(GetAppLogger());
+	}
+
+	void Log::SetLevel(Category category, spdlog::level::level_enum level)
+	{
+		const size_t index = static_cast<size_t>(category);
+		s_Levels[index].store(level, std::memory_order_relaxed);
+		if (s_Loggers[index])
+			s_Loggers[index]->set_level(level);
+	}
+
+	void Log::SetLevels(const std::string& levels)
+	{
+		size_t begin = 0;
+		while (begin < levels.size())
+		{
+			size_t end = levels.find(',', begin);
+			if (end == std::string::npos) end = levels.size();
+			const std::string entry = levels.substr(begin, end - begin);
+			begin = end + 1;
+			if (entry.empty()) continue;
+
+			const size_t equals = entry.find('=');
+			const std::string name = equals == std::string::npos ? "" : entry.substr(0, equals);
+			const std::string levelName = equals == std::string::npos ? entry : entry.substr(equals + 1);
+
+			// from_str maps unknown names to off
+			const spdlog::level::level_enum level = spdlog::level::from_str(levelName);
+			if (level == spdlog::level::off && levelName != "off")
+			{
+				PR_CORE_WARN("Unknown log level '{0}'", levelName);
+				continue;
+			}
+
+			if (name.empty())
+			{
+				for (size_t i = 0; i < static_cast<size_t>(Category::Count); ++i)
+					SetLevel(static_cast<Category>(i), level);
+				continue;
+			}
+
+			auto category = std::find(std::begin(c_CategoryNames), std::end(c_CategoryNames), name);
+			if (category == std::end(c_CategoryNames))
+				PR_CORE_WARN("Unknown log category '{0}'", name);
+			else
+				SetLevel(static_cast<Category>(category - std::begin(c_CategoryNames)), level);
+		}
+	}
+
+	const char* Log::GetCategoryName(Category category)
+	{
+		return c_CategoryNames[static_cast<size_t>(category)];
+	}
+
+	bool LogRateLimit::Allow(uint64_t& suppressed)
+	{
+		const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		// the first call of a new window restarts the count, racing callers may get one extra message through
+		int64_t start = m_WindowStart.load(std::memory_order_relaxed);
+		if (now - start >= Period && m_WindowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+			m_Count.store(0, std::memory_order_relaxed);
+
+		if (m_Count.fetch_add(1, std::memory_order_relaxed) < Burst)
+		{
+			suppressed = m_Suppressed.exchange(0, std::memory_order_relaxed);
+			return true;
+		}
+		m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// single producer (owning thread), single consumer (background thread)
+	struct LogQueue {
+		std::atomic<uint32_t> head = 0;
+		std::atomic<uint32_t> tail = 0;
+		std::unique_ptr<uint8_t[]> storage;
+		uint32_t mask;
+	};
+
+	Log::AsyncSettings g_AsyncSettings;
+	std::atomic<uint64_t> g_Dropped = 0;
+
+	std::mutex g_QueueMutex;
+	std::vector<std::unique_ptr<LogQueue>> g_Queues; // never shrinks, threads keep pointers
+	std::vector<LogQueue*> g_FreeQueues; // of exited threads, reused once drained
+
+	std::thread g_LogThread;
+	std::atomic<bool> g_LogThreadStop = false;
+	std::atomic<bool> g_LogThreadSleeping = false;
+	std::mutex g_WakeMutex;
+	std::condition_variable g_WakeCondition;
+
+	// returns the queue to the free list when the thread exits
+	struct LogQueueHandle {
+		LogQueue* queue = nullptr;
+		~LogQueueHandle()
+		{
+			if (!queue) return;
+			std::lock_guard<std::mutex> lock(g_QueueMutex);
+			g_FreeQueues.push_back(queue);
+		}
+	};
+	thread_local LogQueueHandle t_Queue;
+
+	static inline Log::Record* recordAt(LogQueue& queue, uint32_t index)
+	{
+		return reinterpret_cast<Log::Record*>(queue.storage.get()) + (index & queue.mask);
+	}
+
+	static LogQueue& localQueue()
+	{
+		if (!t_Queue.queue)
+		{
+			std::lock_guard<std::mutex> lock(g_QueueMutex);
+			if (!g_FreeQueues.empty())
+			{
+				t_Queue.queue = g_FreeQueues.back();
+				g_FreeQueues.pop_back();
+			}
+			else
+			{
+				auto queue = std::make_unique<LogQueue>();
+				const uint32_t size = g_AsyncSettings.queueSize;
+				queue->storage = std::make_unique<uint8_t[]>(size * sizeof(Log::Record));
+				queue->mask = size - 1;
+				t_Queue.queue = queue.get();
+				g_Queues.push_back(std::move(queue));
+			}
+		}
+		return *t_Queue.queue;
+	}
+
+	static void wakeLogThread()
+	{
+		if (g_LogThreadSleeping.load(std::memory_order_relaxed))
+			g_WakeCondition.notify_one();
+	}
+
+	Log::Record* Log::beginRecord()
+	{
+		LogQueue& queue = localQueue();
+		const uint32_t head = queue.head.load(std::memory_order_relaxed);
+		while (head - queue.tail.load(std::memory_order_acquire) > queue.mask)
+		{
+			if (g_AsyncSettings.overflow == OverflowPolicy::Drop)
+			{
+				g_Dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			wakeLogThread();
+			std::this_thread::yield();
+		}
+		return recordAt(queue, head);
+	}
+
+	void Log::commitRecord()
+	{
+		LogQueue& queue = *t_Queue.queue;
+		queue.head.store(queue.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		wakeLogThread();
+	}
+
+	void Log::formatEager(Record& record, std::string& message)
+	{
+		std::string* formatted = reinterpret_cast<std::string*>(record.payload);
+		message = std::move(*formatted);
+		formatted->~basic_string();
+	}
+
+	// formats and writes everything queued so far, in timestamp order; returns false if there was nothing
+	static bool processQueues()
+	{
+		struct Pending {
+			Log::Record* record;
+			spdlog::log_clock::time_point time;
+		};
+		static std::vector<LogQueue*> queues;
+		static std::vector<uint32_t> heads;
+		static std::vector<Pending> pending;
+		static std::string message;
+
+		{
+			std::lock_guard<std::mutex> lock(g_QueueMutex);
+			queues.clear();
+			for (auto& queue : g_Queues)
+				queues.push_back(queue.get());
+		}
+
+		pending.clear();
+		heads.resize(queues.size());
+		for (size_t i = 0; i < queues.size(); ++i)
+		{
+			LogQueue& queue = *queues[i];
+			heads[i] = queue.head.load(std::memory_order_acquire);
+			for (uint32_t index = queue.tail.load(std::memory_order_relaxed); index != heads[i]; ++index)
+			{
+				Log::Record* record = recordAt(queue, index);
+				pending.push_back({ record, record->time });
+			}
+		}
+		if (pending.empty())
+			return false;
+
+		std::stable_sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) { return a.time < b.time; });
+		for (const Pending& entry : pending)
+		{
+			Log::Record& record = *entry.record;
+			record.format(record, message);
+			record.logger->log(record.time, record.location, record.level, message);
+		}
+
+		for (size_t i = 0; i < queues.size(); ++i)
+			queues[i]->tail.store(heads[i], std::memory_order_release);
+		return true;
+	}
+
+	static void logThread()
+	{
+		PR_MEMORY_TAG(Log);
+		uint64_t reportedDrops = 0;
+
+		while (true)
+		{
+			const bool stop = g_LogThreadStop.load();
+			const bool worked = processQueues();
 
-		s_CoreLogger->set_level(spdlog::level::trace);
-		s_LuaLogger->set_level(spdlog::level::trace);
-		s_AppLogger->set_level(spdlog::level::trace);
+			const uint64_t dropped = g_Dropped.load(std::memory_order_relaxed);
+			if (dropped != reportedDrops)
+			{
+				Log::GetCoreLogger()->log(spdlog::source_loc{ __FILE__, __LINE__, SPDLOG_FUNCTION }, spdlog::level::warn,
+					"Log queue overflow, {0} messages dropped", dropped - reportedDrops);
+				reportedDrops = dropped;
+			}
 
-		spdlog::set_default_logger(s_AppLogger);
+			if (worked) continue;
+			if (stop) break; // stop requested before the last (empty) pass
+
+			// producers only notify while we sleep, the timeout covers a missed wakeup
+			std::unique_lock<std::mutex> lock(g_WakeMutex);
+			g_LogThreadSleeping.store(true);
+			g_WakeCondition.wait_for(lock, std::chrono::milliseconds(2));
+			g_LogThreadSleeping.store(false);
+		}
+	}
+
+	void Log::StartAsync(const AsyncSettings& settings)
+	{
+		if (IsAsync()) return;
+		PR_CORE_ASSERT(settings.queueSize > 0 && (settings.queueSize & (settings.queueSize - 1)) == 0,
+			"Log queue size must be a power of two!");
+
+		{
+			// queues of the previous run may have a different size
+			std::lock_guard<std::mutex> lock(g_QueueMutex);
+			if (settings.queueSize != g_AsyncSettings.queueSize)
+				PR_CORE_ASSERT(g_Queues.empty(), "Log queue size can't change once queues exist!");
+		}
+
+		g_AsyncSettings = settings;
+		g_LogThreadStop = false;
+		g_LogThread = std::thread(logThread);
+		s_Async = true;
+	}
+
+	void Log::StopAsync()
+	{
+		if (!IsAsync()) return;
+
+		s_Async = false;
+		g_LogThreadStop = true;
+		g_WakeCondition.notify_one();
+		g_LogThread.join();
+
+		for (auto& logger : s_Loggers)
+			logger->flush();
+	}
+
+	void Log::Flush()
+	{
+		if (IsAsync())
+		{
+			std::vector<std::pair<LogQueue*, uint32_t>> targets;
+			{
+				std::lock_guard<std::mutex> lock(g_QueueMutex);
+				for (auto& queue : g_Queues)
+					targets.push_back({ queue.get(), queue->head.load(std::memory_order_acquire) });
+			}
+
+			for (auto& target : targets)
+				while (static_cast<int32_t>(target.second - target.first->tail.load(std::memory_order_acquire)) > 0)
+				{
+					g_WakeCondition.notify_one();
+					std::this_thread::yield();
+				}
+		}
+
+		for (auto& logger : s_Loggers)
+			if (logger) logger->flush();
+	}
+
+	uint64_t Log::GetDroppedCount()
+	{
+		return g_Dropped.load();
 	}
-}
\ No newline at end of file
+}
@@ -1,57 +1,334 @@
 #pragma once
 
-// Log only in debug mode
+// Trace only in debug mode, the other levels are filtered at runtime (Log::SetLevel)
 #ifdef PR_DEBUG
 #define SPDLOG_DEBUG_ON
 #define SPDLOG_TRACE_ON
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 #else
-#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_ERROR
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
 #endif
 
 #include "spdlog/spdlog.h"
 #include "spdlog/fmt/ostr.h"
 
+#include "BinaryLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
 namespace Prism {
+
 	class Log
 	{
 	public:
-		inline static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; };
-		inline static std::shared_ptr<spdlog::logger>& GetLuaLogger() { return s_LuaLogger; };
-		inline static std::shared_ptr<spdlog::logger>& GetAppLogger() { return s_AppLogger; };
+		// one logger each, Tasks to ECS are sub-categories of Core
+		enum class Category : uint8_t {
+			Core, Lua, App, Tasks, Resources, Vulkan, ECS, Count
+		};
+
+		inline static std::shared_ptr<spdlog::logger>& GetLogger(Category category) { return s_Loggers[static_cast<size_t>(category)]; }
+		inline static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return GetLogger(Category::Core); };
+		inline static std::shared_ptr<spdlog::logger>& GetLuaLogger() { return GetLogger(Category::Lua); };
+		inline static std::shared_ptr<spdlog::logger>& GetAppLogger() { return GetLogger(Category::App); };
 
 		/* must be called before Logger is used */
 		static void Init();
 
+		/**
+		 * Runtime level per category, trace in debug builds and warn otherwise.
+		 * The macros check it before their arguments are evaluated, a disabled
+		 * call costs one relaxed atomic load.
+		 */
+		static bool ShouldLog(Category category, spdlog::level::level_enum level)
+		{
+			return level >= s_Levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+		}
+		static void SetLevel(Category category, spdlog::level::level_enum level);
+		static spdlog::level::level_enum GetLevel(Category category) { return s_Levels[static_cast<size_t>(category)].load(); }
+		/** Comma separated, e.g. "warn,Vulkan=trace,Resources=off"; a bare level applies to all categories. */
+		static void SetLevels(const std::string& levels);
+		static const char* GetCategoryName(Category category);
+
+		enum class OverflowPolicy {
+			Drop, // discard the message, counted in GetDroppedCount()
+			Block // wait for the background thread to make room
+		};
+
+		struct AsyncSettings {
+			OverflowPolicy overflow = OverflowPolicy::Drop;
+			uint32_t queueSize = 4096; // messages per thread, power of two
+		};
+
+		/**
+		 * Asynchronous mode: log calls only copy their arguments into a
+		 * per-thread lock-free queue, a background thread formats them and
+		 * does the sink I/O (in timestamp order).
+		 *
+		 * Deferred are calls with a format string array (the text is copied
+		 * into the queue entry, so stack buffers are fine) whose arguments
+		 * are arithmetic, enums or std::string; all others are formatted on
+		 * the calling thread and only the I/O is deferred. Errors and
+		 * criticals flush the queues and are written synchronously.
+		 *
+		 * Start/StopAsync must be called while no other thread logs.
+		 *
+		 * While a BinaryLog is open, it takes all messages instead; errors
+		 * and criticals additionally go through the text loggers.
+		 */
+		static void StartAsync() { StartAsync(AsyncSettings()); }
+		static void StartAsync(const AsyncSettings& settings);
+		static void StopAsync(); // writes all queued messages
+		static bool IsAsync() { return s_Async.load(std::memory_order_relaxed); }
+
+		/** Blocks until all messages queued so far are written. */
+		static void Flush();
+		static uint64_t GetDroppedCount();
+
+		template<typename Format, typename... Args>
+		static void Write(const std::shared_ptr<spdlog::logger>& logger, spdlog::level::level_enum level,
+			const spdlog::source_loc& location, Format&& format, Args&&... args);
+
+		// one queued message (internal), the payload holds the arguments or the formatted text
+		struct Record {
+			static constexpr size_t PayloadSize = 192;
+
+			void (*format)(Record& record, std::string& message); // also destroys the payload
+			spdlog::logger* logger;
+			spdlog::level::level_enum level;
+			spdlog::source_loc location;
+			spdlog::log_clock::time_point time;
+			alignas(std::max_align_t) unsigned char payload[PayloadSize];
+		};
+
 	private:
-		static std::shared_ptr<spdlog::logger> s_CoreLogger;
-		static std::shared_ptr<spdlog::logger> s_LuaLogger;
-		static std::shared_ptr<spdlog::logger> s_AppLogger;
+		template<typename T>
+		struct IsDeferrable : std::bool_constant<std::is_arithmetic<T>::value
+			|| std::is_enum<T>::value || std::is_same<T, std::string>::value> {};
+
+		// the format text follows in the payload
+		template<typename... Args>
+		struct Deferred {
+			std::tuple<Args...> args;
+			size_t formatSize;
+		};
+
+		template<typename... Args>
+		static void formatDeferred(Record& record, std::string& message)
+		{
+			auto* deferred = reinterpret_cast<Deferred<Args...>*>(record.payload);
+			const fmt::string_view format(reinterpret_cast<const char*>(record.payload + sizeof(Deferred<Args...>)), deferred->formatSize);
+			if constexpr (sizeof...(Args) == 0)
+				message.assign(format.data(), format.size());
+			else
+				message = std::apply([&](auto&... args) { return fmt::vformat(format, fmt::make_format_args(args...)); },
+					deferred->args);
+			deferred->~Deferred();
+		}
+
+		static void formatEager(Record& record, std::string& message);
+
+		// reserves a slot in the calling thread's queue, nullptr if dropped
+		static Record* beginRecord();
+		static void commitRecord();
+
+	private:
+		static std::shared_ptr<spdlog::logger> s_Loggers[static_cast<size_t>(Category::Count)];
+		static std::atomic<spdlog::level::level_enum> s_Levels[static_cast<size_t>(Category::Count)];
+
+		static std::atomic<bool> s_Async;
 	};
+
+	/**
+	 * Per call site limit of the PR_*_LIMITED macros: up to Burst messages
+	 * per second, the count of the suppressed ones precedes the next message.
+	 */
+	class LogRateLimit
+	{
+	public:
+		static constexpr uint32_t Burst = 5;
+		static constexpr int64_t Period = 1000; // ms
+
+		// suppressed: messages dropped since the last allowed one
+		bool Allow(uint64_t& suppressed);
+
+	private:
+		std::atomic<int64_t> m_WindowStart = std::numeric_limits<int64_t>::min() / 2;
+		std::atomic<uint32_t> m_Count = 0;
+		std::atomic<uint64_t> m_Suppressed = 0;
+	};
+
+	template<typename Format, typename... Args>
+	void Log::Write(const std::shared_ptr<spdlog::logger>& logger, spdlog::level::level_enum level,
+		const spdlog::source_loc& location, Format&& format, Args&&... args)
+	{
+		using FormatType = std::remove_reference_t<Format>;
+
+		if (!logger->should_log(level))
+			return;
+
+		if (BinaryLog::IsOpen())
+		{
+			BinaryLog::Write(logger.get(), level, location, format, args...);
+			if (level < spdlog::level::err)
+				return;
+		}
+
+		if (!IsAsync())
+		{
+			logger->log(location, level, format, std::forward<Args>(args)...);
+			return;
+		}
+
+		if (level >= spdlog::level::err)
+		{
+			// must be visible before e.g. an assertion breaks
+			Flush();
+			logger->log(location, level, format, std::forward<Args>(args)...);
+			return;
+		}
+
+		Record* record = beginRecord();
+		if (!record)
+			return;
+
+		record->logger = logger.get();
+		record->level = level;
+		record->location = location;
+		record->time = spdlog::log_clock::now();
+
+		using DeferredType = Deferred<std::decay_t<Args>...>;
+		constexpr bool deferrable = std::is_array<FormatType>::value
+			&& (IsDeferrable<std::decay_t<Args>>::value && ...)
+			&& sizeof(DeferredType) + std::extent<FormatType>::value <= Record::PayloadSize
+			&& alignof(DeferredType) <= alignof(std::max_align_t);
+
+		if constexpr (deferrable)
+		{
+			// literal or not (a char buffer on the stack), the array may be gone when the message is formatted
+			const size_t formatSize = std::find(format, format + std::extent<FormatType>::value, '\0') - format;
+			new (record->payload) DeferredType{ std::tuple<std::decay_t<Args>...>(std::forward<Args>(args)...), formatSize };
+			std::memcpy(record->payload + sizeof(DeferredType), format, formatSize);
+			record->format = &formatDeferred<std::decay_t<Args>...>;
+		}
+		else
+		{
+			std::string* message = new (record->payload) std::string();
+			if constexpr (sizeof...(Args) == 0)
+				*message = fmt::to_string(format);
+			else
+				*message = fmt::vformat(fmt::string_view(format), fmt::make_format_args(args...));
+			record->format = &formatEager;
+		}
+		commitRecord();
+	}
 }
 
+// source location of the call site, for any logger (no category level check)
+#define PR_LOG_WRITE(logger, level, ...) ::Prism::Log::Write(logger, level, spdlog::source_loc{ __FILE__, __LINE__, SPDLOG_FUNCTION }, __VA_ARGS__)
+
+// runtime level of the category checked first, the arguments are only evaluated if it passes
+#define PR_LOG_CATEGORY(category, level, ...) (::Prism::Log::ShouldLog(category, level) \
+	? PR_LOG_WRITE(::Prism::Log::GetLogger(category), level, __VA_ARGS__) : (void)0)
+
+// rate limited per call site (LogRateLimit), for messages that may fire every frame
+#define PR_LOG_LIMITED(category, level, ...) do { if (::Prism::Log::ShouldLog(category, level)) { \
+	static ::Prism::LogRateLimit prRateLimit; uint64_t prSuppressed = 0; \
+	if (prRateLimit.Allow(prSuppressed)) { \
+		if (prSuppressed > 0) PR_LOG_WRITE(::Prism::Log::GetLogger(category), level, "{0} similar messages suppressed", prSuppressed); \
+		PR_LOG_WRITE(::Prism::Log::GetLogger(category), level, __VA_ARGS__); } } } while (0)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define PR_LOG_WRITE_TRACE(category, ...) PR_LOG_CATEGORY(category, spdlog::level::trace, __VA_ARGS__)
+#define PR_LOG_LIMITED_TRACE(category, ...) PR_LOG_LIMITED(category, spdlog::level::trace, __VA_ARGS__)
+#else
+#define PR_LOG_WRITE_TRACE(category, ...) (void)0
+#define PR_LOG_LIMITED_TRACE(category, ...) (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define PR_LOG_WRITE_INFO(category, ...) PR_LOG_CATEGORY(category, spdlog::level::info, __VA_ARGS__)
+#define PR_LOG_LIMITED_INFO(category, ...) PR_LOG_LIMITED(category, spdlog::level::info, __VA_ARGS__)
+#else
+#define PR_LOG_WRITE_INFO(category, ...) (void)0
+#define PR_LOG_LIMITED_INFO(category, ...) (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define PR_LOG_WRITE_WARN(category, ...) PR_LOG_CATEGORY(category, spdlog::level::warn, __VA_ARGS__)
+#define PR_LOG_LIMITED_WARN(category, ...) PR_LOG_LIMITED(category, spdlog::level::warn, __VA_ARGS__)
+#else
+#define PR_LOG_WRITE_WARN(category, ...) (void)0
+#define PR_LOG_LIMITED_WARN(category, ...) (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define PR_LOG_WRITE_ERROR(category, ...) PR_LOG_CATEGORY(category, spdlog::level::err, __VA_ARGS__)
+#define PR_LOG_LIMITED_ERROR(category, ...) PR_LOG_LIMITED(category, spdlog::level::err, __VA_ARGS__)
+#else
+#define PR_LOG_WRITE_ERROR(category, ...) (void)0
+#define PR_LOG_LIMITED_ERROR(category, ...) (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define PR_LOG_WRITE_CRITICAL(category, ...) PR_LOG_CATEGORY(category, spdlog::level::critical, __VA_ARGS__)
+#else
+#define PR_LOG_WRITE_CRITICAL(category, ...) (void)0
+#endif
+
 #define PR_LOG_HEADING_TEXT(text) "========== {0} ====================", text
-#define PR_CORE_TRACE(...)		SPDLOG_LOGGER_TRACE(Prism::Log::GetCoreLogger(),__VA_ARGS__)
-#define PR_CORE_INFO(...)		SPDLOG_LOGGER_INFO(Prism::Log::GetCoreLogger(),__VA_ARGS__)
-#define PR_CORE_WARN(...)		SPDLOG_LOGGER_WARN(Prism::Log::GetCoreLogger(),__VA_ARGS__)
-#define PR_CORE_ERROR(...)		SPDLOG_LOGGER_ERROR(Prism::Log::GetCoreLogger(),__VA_ARGS__)
-#define PR_CORE_CRITICAL(...)	SPDLOG_LOGGER_CRITICAL(Prism::Log::GetCoreLogger(),__VA_ARGS__)
+#define PR_CORE_TRACE(...)		PR_LOG_WRITE_TRACE(Prism::Log::Category::Core, __VA_ARGS__)
+#define PR_CORE_INFO(...)		PR_LOG_WRITE_INFO(Prism::Log::Category::Core, __VA_ARGS__)
+#define PR_CORE_WARN(...)		PR_LOG_WRITE_WARN(Prism::Log::Category::Core, __VA_ARGS__)
+#define PR_CORE_ERROR(...)		PR_LOG_WRITE_ERROR(Prism::Log::Category::Core, __VA_ARGS__)
+#define PR_CORE_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::Core, __VA_ARGS__)
 #define PR_CORE_HEAD(text)		PR_CORE_INFO(PR_LOG_HEADING_TEXT(text))
+#define PR_CORE_WARN_LIMITED(...)	PR_LOG_LIMITED_WARN(Prism::Log::Category::Core, __VA_ARGS__)
 
-#define PR_LUA_TRACE(...)		SPDLOG_LOGGER_TRACE(Prism::Log::GetLuaLogger(),__VA_ARGS__)
-#define PR_LUA_INFO(...)		SPDLOG_LOGGER_INFO(Prism::Log::GetLuaLogger(),__VA_ARGS__)
-#define PR_LUA_WARN(...)		SPDLOG_LOGGER_WARN(Prism::Log::GetLuaLogger(),__VA_ARGS__)
-#define PR_LUA_ERROR(...)		SPDLOG_LOGGER_ERROR(Prism::Log::GetLuaLogger(),__VA_ARGS__)
-#define PR_LUA_CRITICAL(...)	SPDLOG_LOGGER_CRITICAL(Prism::Log::GetLuaLogger(),__VA_ARGS__)
+#define PR_LUA_TRACE(...)		PR_LOG_WRITE_TRACE(Prism::Log::Category::Lua, __VA_ARGS__)
+#define PR_LUA_INFO(...)		PR_LOG_WRITE_INFO(Prism::Log::Category::Lua, __VA_ARGS__)
+#define PR_LUA_WARN(...)		PR_LOG_WRITE_WARN(Prism::Log::Category::Lua, __VA_ARGS__)
+#define PR_LUA_ERROR(...)		PR_LOG_WRITE_ERROR(Prism::Log::Category::Lua, __VA_ARGS__)
+#define PR_LUA_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::Lua, __VA_ARGS__)
 #define PR_LUA_HEAD(text)		PR_LUA_INFO(PR_LOG_HEADING_TEXT(text))
 
-#define PR_LOG_TRACE(...)		SPDLOG_LOGGER_TRACE(Prism::Log::GetAppLogger(),__VA_ARGS__)
-#define PR_LOG_INFO(...)		SPDLOG_LOGGER_INFO(Prism::Log::GetAppLogger(),__VA_ARGS__)
-#define PR_LOG_WARN(...)		SPDLOG_LOGGER_WARN(Prism::Log::GetAppLogger(),__VA_ARGS__)
-#define PR_LOG_ERROR(...)		SPDLOG_LOGGER_ERROR(Prism::Log::GetAppLogger(),__VA_ARGS__)
-#define PR_LOG_CRITICAL(...)	SPDLOG_LOGGER_CRITICAL(Prism::Log::GetAppLogger(),__VA_ARGS__)
+#define PR_LOG_TRACE(...)		PR_LOG_WRITE_TRACE(Prism::Log::Category::App, __VA_ARGS__)
+#define PR_LOG_INFO(...)		PR_LOG_WRITE_INFO(Prism::Log::Category::App, __VA_ARGS__)
+#define PR_LOG_WARN(...)		PR_LOG_WRITE_WARN(Prism::Log::Category::App, __VA_ARGS__)
+#define PR_LOG_ERROR(...)		PR_LOG_WRITE_ERROR(Prism::Log::Category::App, __VA_ARGS__)
+#define PR_LOG_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::App, __VA_ARGS__)
 #define PR_LOG_HEAD(text)		PR_LOG_INFO(PR_LOG_HEADING_TEXT(text))
 
+#define PR_TASKS_TRACE(...)		PR_LOG_WRITE_TRACE(Prism::Log::Category::Tasks, __VA_ARGS__)
+#define PR_TASKS_INFO(...)		PR_LOG_WRITE_INFO(Prism::Log::Category::Tasks, __VA_ARGS__)
+#define PR_TASKS_WARN(...)		PR_LOG_WRITE_WARN(Prism::Log::Category::Tasks, __VA_ARGS__)
+#define PR_TASKS_ERROR(...)		PR_LOG_WRITE_ERROR(Prism::Log::Category::Tasks, __VA_ARGS__)
+#define PR_TASKS_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::Tasks, __VA_ARGS__)
+#define PR_TASKS_WARN_LIMITED(...)	PR_LOG_LIMITED_WARN(Prism::Log::Category::Tasks, __VA_ARGS__)
+
+#define PR_RESOURCES_TRACE(...)	PR_LOG_WRITE_TRACE(Prism::Log::Category::Resources, __VA_ARGS__)
+#define PR_RESOURCES_INFO(...)	PR_LOG_WRITE_INFO(Prism::Log::Category::Resources, __VA_ARGS__)
+#define PR_RESOURCES_WARN(...)	PR_LOG_WRITE_WARN(Prism::Log::Category::Resources, __VA_ARGS__)
+#define PR_RESOURCES_ERROR(...)	PR_LOG_WRITE_ERROR(Prism::Log::Category::Resources, __VA_ARGS__)
+#define PR_RESOURCES_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::Resources, __VA_ARGS__)
+#define PR_RESOURCES_WARN_LIMITED(...)	PR_LOG_LIMITED_WARN(Prism::Log::Category::Resources, __VA_ARGS__)
+
+#define PR_VULKAN_TRACE(...)	PR_LOG_WRITE_TRACE(Prism::Log::Category::Vulkan, __VA_ARGS__)
+#define PR_VULKAN_INFO(...)		PR_LOG_WRITE_INFO(Prism::Log::Category::Vulkan, __VA_ARGS__)
+#define PR_VULKAN_WARN(...)		PR_LOG_WRITE_WARN(Prism::Log::Category::Vulkan, __VA_ARGS__)
+#define PR_VULKAN_ERROR(...)	PR_LOG_WRITE_ERROR(Prism::Log::Category::Vulkan, __VA_ARGS__)
+#define PR_VULKAN_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::Vulkan, __VA_ARGS__)
+#define PR_VULKAN_WARN_LIMITED(...)	PR_LOG_LIMITED_WARN(Prism::Log::Category::Vulkan, __VA_ARGS__)
+
+#define PR_ECS_TRACE(...)		PR_LOG_WRITE_TRACE(Prism::Log::Category::ECS, __VA_ARGS__)
+#define PR_ECS_INFO(...)		PR_LOG_WRITE_INFO(Prism::Log::Category::ECS, __VA_ARGS__)
+#define PR_ECS_WARN(...)		PR_LOG_WRITE_WARN(Prism::Log::Category::ECS, __VA_ARGS__)
+#define PR_ECS_ERROR(...)		PR_LOG_WRITE_ERROR(Prism::Log::Category::ECS, __VA_ARGS__)
+#define PR_ECS_CRITICAL(...)	PR_LOG_WRITE_CRITICAL(Prism::Log::Category::ECS, __VA_ARGS__)
+#define PR_ECS_WARN_LIMITED(...)	PR_LOG_LIMITED_WARN(Prism::Log::Category::ECS, __VA_ARGS__)
+
 // Asserts
 #define PR_CORE_ASSERT(x, ...) {if(!(x)) {PR_CORE_ERROR("Assertion failed: {0}", __VA_ARGS__); __debugbreak();}}
 #define PR_ASSERT(x, ...) {if(!(x)) {PR_LOG_ERROR("Assertion failed: {0}", __VA_ARGS__); __debugbreak();}}
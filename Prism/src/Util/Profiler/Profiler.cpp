@@ -0,0 +1,294 @@
+#include "Profiler.h"
+
+#include "Util/Log/Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Prism {
+
+	static constexpr uint32_t c_BufferSize = 1 << 14; // zones per thread and frame, power of two
+	static constexpr uint32_t c_HistorySize = 256; // frames for min/avg/p99
+
+	struct ThreadBuffer {
+		std::atomic<uint32_t> head = 0; // written by the owning thread
+		std::atomic<uint32_t> tail = 0; // written by NewFrame
+		std::atomic<uint64_t> dropped = 0;
+		uint32_t depth = 0;
+		uint32_t id;
+		std::string name;
+		Profiler::ZoneEvent events[c_BufferSize];
+	};
+
+	struct ZoneHistory {
+		std::string name;
+		std::vector<float> frames = std::vector<float>(c_HistorySize); // ring of per frame totals, ms
+		uint32_t count = 0, next = 0;
+		uint32_t lastCalls = 0;
+		double lastMs = 0.0;
+		bool active = false; // recorded in the last frame
+	};
+
+	std::mutex g_RegistryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> g_Buffers;
+	thread_local ThreadBuffer* t_Buffer = nullptr;
+
+	std::mutex g_FrameMutex;
+	std::vector<Profiler::FrameEvent> g_FrameEvents;
+	std::vector<ZoneHistory> g_Zones;
+	std::unordered_map<const char*, uint32_t> g_ZoneByPointer;
+	std::unordered_map<std::string, uint32_t> g_ZoneByName;
+	uint64_t g_FrameBegin = 0;
+	double g_FrameTime = 0.0;
+
+	// TSC calibration against the steady clock, refined every frame
+	uint64_t g_CalibrationTicks = 0, g_CalibrationNanoseconds = 0;
+	std::atomic<double> g_TicksPerMillisecond = 0.0;
+
+	static ThreadBuffer& localBuffer()
+	{
+		if (!t_Buffer)
+		{
+			std::lock_guard<std::mutex> lock(g_RegistryMutex);
+			g_Buffers.push_back(std::make_unique<ThreadBuffer>());
+			t_Buffer = g_Buffers.back().get();
+			t_Buffer->id = static_cast<uint32_t>(g_Buffers.size() - 1);
+			t_Buffer->name = "thread-" + std::to_string(t_Buffer->id);
+		}
+		return *t_Buffer;
+	}
+
+	uint64_t Profiler::nowNanoseconds()
+	{
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	uint32_t Profiler::EnterZone()
+	{
+		return localBuffer().depth++;
+	}
+
+	void Profiler::LeaveZone()
+	{
+		localBuffer().depth--;
+	}
+
+	void Profiler::Record(const ZoneEvent& event)
+	{
+		ThreadBuffer& buffer = localBuffer();
+		const uint32_t head = buffer.head.load(std::memory_order_relaxed);
+		if (head - buffer.tail.load(std::memory_order_acquire) == c_BufferSize)
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer.events[head & (c_BufferSize - 1)] = event;
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::SetThreadName(const std::string& name)
+	{
+		ThreadBuffer& buffer = localBuffer();
+		std::lock_guard<std::mutex> lock(g_RegistryMutex);
+		buffer.name = name;
+	}
+
+	double Profiler::TicksToMilliseconds(uint64_t ticks)
+	{
+		const double ticksPerMs = g_TicksPerMillisecond.load();
+		return ticksPerMs > 0.0 ? ticks / ticksPerMs : 0.0;
+	}
+
+	static void updateCalibration(uint64_t ticks)
+	{
+#ifdef PR_PROFILE_RDTSC
+		const uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		if (g_CalibrationTicks == 0)
+		{
+			g_CalibrationTicks = ticks;
+			g_CalibrationNanoseconds = nanoseconds;
+		}
+		else if (nanoseconds - g_CalibrationNanoseconds > 1000000)
+			g_TicksPerMillisecond = (ticks - g_CalibrationTicks) * 1e6 / (nanoseconds - g_CalibrationNanoseconds);
+#else
+		g_TicksPerMillisecond = 1e6; // timestamps are nanoseconds already
+#endif
+	}
+
+	static uint32_t zoneIndex(const char* name)
+	{
+		auto itr = g_ZoneByPointer.find(name);
+		if (itr != g_ZoneByPointer.end())
+			return itr->second;
+
+		// the same name may come from different literals
+		auto byName = g_ZoneByName.emplace(name, static_cast<uint32_t>(g_Zones.size()));
+		if (byName.second)
+			g_Zones.push_back({ name });
+		g_ZoneByPointer.emplace(name, byName.first->second);
+		return byName.first->second;
+	}
+
+	static void pushHistory(ZoneHistory& zone, double ms)
+	{
+		zone.frames[zone.next] = static_cast<float>(ms);
+		zone.next = (zone.next + 1) % c_HistorySize;
+		zone.count = std::min(zone.count + 1, c_HistorySize);
+	}
+
+	void Profiler::NewFrame()
+	{
+		const uint64_t now = GetTimestamp();
+		std::lock_guard<std::mutex> frameLock(g_FrameMutex);
+
+		const bool calibrated = g_TicksPerMillisecond.load() > 0.0;
+		updateCalibration(now);
+
+		g_FrameEvents.clear();
+		{
+			std::lock_guard<std::mutex> lock(g_RegistryMutex);
+			for (auto& buffer : g_Buffers)
+			{
+				const uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+				const uint32_t head = buffer->head.load(std::memory_order_acquire);
+				for (uint32_t i = tail; i != head; ++i)
+					g_FrameEvents.push_back({ buffer->events[i & (c_BufferSize - 1)], buffer->id });
+				buffer->tail.store(head, std::memory_order_release);
+			}
+		}
+
+		const uint64_t frameBegin = g_FrameBegin;
+		g_FrameBegin = now;
+		// the very first frame has no start and no time base yet
+		if (frameBegin == 0 || !calibrated)
+			return;
+
+		for (auto& zone : g_Zones)
+		{
+			zone.active = false;
+			zone.lastCalls = 0;
+			zone.lastMs = 0.0;
+		}
+
+		for (const FrameEvent& event : g_FrameEvents)
+		{
+			ZoneHistory& zone = g_Zones[zoneIndex(event.zone.name)];
+			zone.active = true;
+			zone.lastCalls++;
+			zone.lastMs += TicksToMilliseconds(event.zone.end - event.zone.begin);
+		}
+
+		for (auto& zone : g_Zones)
+			if (zone.active)
+				pushHistory(zone, zone.lastMs);
+
+		g_FrameTime = TicksToMilliseconds(now - frameBegin);
+		ZoneHistory& frame = g_Zones[zoneIndex("Frame")];
+		frame.active = true;
+		frame.lastCalls = 1;
+		frame.lastMs = g_FrameTime;
+		pushHistory(frame, g_FrameTime);
+	}
+
+	std::vector<Profiler::ZoneStats> Profiler::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(g_FrameMutex);
+
+		std::vector<ZoneStats> result;
+		std::vector<float> sorted;
+		for (const auto& zone : g_Zones)
+		{
+			if (zone.count == 0)
+				continue;
+
+			sorted.assign(zone.frames.begin(), zone.frames.begin() + zone.count);
+			std::sort(sorted.begin(), sorted.end());
+
+			ZoneStats stats;
+			stats.name = zone.name;
+			stats.calls = zone.lastCalls;
+			stats.lastMs = zone.lastMs;
+			stats.frames = zone.count;
+			stats.minMs = sorted.front();
+			stats.maxMs = sorted.back();
+			double sum = 0.0;
+			for (float ms : sorted)
+				sum += ms;
+			stats.avgMs = sum / zone.count;
+			stats.p99Ms = sorted[(zone.count * 99 + 99) / 100 - 1];
+			result.push_back(std::move(stats));
+		}
+
+		std::sort(result.begin(), result.end(), [](const ZoneStats& a, const ZoneStats& b) { return a.avgMs > b.avgMs; });
+		return result;
+	}
+
+	const std::vector<Profiler::FrameEvent>& Profiler::GetFrameEvents()
+	{
+		return g_FrameEvents;
+	}
+
+	double Profiler::GetFrameTime()
+	{
+		return g_FrameTime;
+	}
+
+	uint64_t Profiler::GetDroppedCount()
+	{
+		std::lock_guard<std::mutex> lock(g_RegistryMutex);
+		uint64_t dropped = 0;
+		for (const auto& buffer : g_Buffers)
+			dropped += buffer->dropped.load();
+		return dropped;
+	}
+
+	bool Profiler::Dump(const std::string& filepath)
+	{
+		std::ofstream file(filepath);
+		if (!file)
+		{
+			PR_CORE_WARN("Could not open profiler dump file {0}", filepath);
+			return false;
+		}
+
+		const auto stats = GetStats();
+		file << fmt::format("{:<40} {:>6} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+			"zone (ms per frame)", "calls", "last", "min", "avg", "p99", "max");
+		for (const auto& zone : stats)
+			file << fmt::format("{:<40} {:>6} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f}\n",
+				zone.name, zone.calls, zone.lastMs, zone.minMs, zone.avgMs, zone.p99Ms, zone.maxMs);
+
+		std::lock_guard<std::mutex> lock(g_FrameMutex);
+		std::vector<std::string> threadNames;
+		{
+			std::lock_guard<std::mutex> registryLock(g_RegistryMutex);
+			for (const auto& buffer : g_Buffers)
+				threadNames.push_back(buffer->name);
+		}
+
+		// timeline of the last frame per thread, relative to its earliest zone
+		std::vector<FrameEvent> events = g_FrameEvents;
+		std::sort(events.begin(), events.end(), [](const FrameEvent& a, const FrameEvent& b)
+			{
+				return a.thread != b.thread ? a.thread < b.thread : a.zone.begin < b.zone.begin;
+			});
+		uint64_t origin = ~0ull;
+		for (const auto& event : events)
+			origin = std::min(origin, event.zone.begin);
+
+		file << fmt::format("\n{:<16} {:>10} {:>10}  zone\n", "thread", "start", "duration");
+		for (const auto& event : events)
+			file << fmt::format("{:<16} {:>10.3f} {:>10.3f}  {:>{}}{}\n", threadNames[event.thread],
+				TicksToMilliseconds(event.zone.begin - origin), TicksToMilliseconds(event.zone.end - event.zone.begin),
+				"", event.zone.depth * 2, event.zone.name);
+
+		file << fmt::format("\ndropped zones: {}\n", GetDroppedCount());
+		return true;
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PR_PROFILE_RDTSC() __rdtsc()
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PR_PROFILE_RDTSC() __rdtsc()
+#endif
+
+namespace Prism {
+
+	/**
+	 * CPU frame profiler
+	 *
+	 * Zones are recorded per thread into lock-free single-producer ring
+	 * buffers (the owning thread writes, NewFrame() drains), timestamps are
+	 * raw TSC ticks calibrated against the steady clock.
+	 *
+	 * Statistics are per zone over the last frames: the time a zone took
+	 * in total per frame (summed over threads and calls).
+	 */
+	class Profiler {
+	public:
+		struct ZoneEvent {
+			const char* name; // must have static storage (string literal, __FUNCTION__)
+			uint64_t begin, end;
+			uint32_t depth;
+		};
+
+		struct ZoneStats {
+			std::string name;
+			uint32_t calls = 0; // in the last frame
+			double lastMs = 0.0, minMs = 0.0, avgMs = 0.0, p99Ms = 0.0, maxMs = 0.0;
+			uint32_t frames = 0; // number of frames the zone was recorded in
+		};
+
+		struct FrameEvent {
+			ZoneEvent zone;
+			uint32_t thread;
+		};
+
+		static uint64_t GetTimestamp()
+		{
+#ifdef PR_PROFILE_RDTSC
+			return PR_PROFILE_RDTSC();
+#else
+			return nowNanoseconds();
+#endif
+		}
+
+		/** Closes the current frame: drains all thread buffers and updates the statistics. */
+		static void NewFrame();
+
+		static void Record(const ZoneEvent& event);
+		static uint32_t EnterZone(); // returns the nesting depth
+		static void LeaveZone();
+
+		static void SetThreadName(const std::string& name);
+
+		static std::vector<ZoneStats> GetStats();
+		static const std::vector<FrameEvent>& GetFrameEvents(); // zones of the last complete frame
+		static double GetFrameTime(); // ms, last frame
+		static double TicksToMilliseconds(uint64_t ticks);
+		static uint64_t GetDroppedCount();
+
+		/** Writes the statistics and the zones of the last frame to a text file. */
+		static bool Dump(const std::string& filepath);
+
+	private:
+		static uint64_t nowNanoseconds();
+	};
+
+	class ProfileScope {
+	public:
+		ProfileScope(const char* name)
+			: m_Name(name), m_Depth(Profiler::EnterZone()), m_Begin(Profiler::GetTimestamp()) {}
+		~ProfileScope()
+		{
+			Profiler::Record({ m_Name, m_Begin, Profiler::GetTimestamp(), m_Depth });
+			Profiler::LeaveZone();
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* m_Name;
+		uint32_t m_Depth;
+		uint64_t m_Begin;
+	};
+}
+
+// Profiling compiles away entirely in release builds
+#ifndef PR_RELEASE
+#define PR_PROFILE_ENABLED
+#endif
+
+#ifdef PR_PROFILE_ENABLED
+#define PR_PROFILE_CONCAT_IMPL(a, b) a##b
+#define PR_PROFILE_CONCAT(a, b) PR_PROFILE_CONCAT_IMPL(a, b)
+#define PR_PROFILE_SCOPE(name) ::Prism::ProfileScope PR_PROFILE_CONCAT(prProfileScope, __LINE__)(name)
+#define PR_PROFILE_FUNCTION() PR_PROFILE_SCOPE(__FUNCTION__)
+#define PR_PROFILE_FRAME() ::Prism::Profiler::NewFrame()
+#define PR_PROFILE_THREAD(name) ::Prism::Profiler::SetThreadName(name)
+#else
+#define PR_PROFILE_SCOPE(name)
+#define PR_PROFILE_FUNCTION()
+#define PR_PROFILE_FRAME()
+#define PR_PROFILE_THREAD(name)
+#endif
@@ -4,7 +4,7 @@ struct Sandbox : public Prism::Application {
 
 	Prism::Entity entity;
 
-	Sandbox() : Prism::Application({})
+	Sandbox() : Prism::Application(Prism::Window::Properties{})
 	{
 	}
 
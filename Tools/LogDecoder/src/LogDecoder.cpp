@@ -0,0 +1,243 @@
+/**
+ * LogDecoder: turns a binary log (Prism::BinaryLog) back into spdlog's text format
+ *
+ * usage: LogDecoder <file> [pattern]
+ * The pattern defaults to the one of Log::Init, without colors.
+ */
+#include "Util/Log/BinaryLogFormat.h"
+
+#include "spdlog/spdlog.h"
+#include "spdlog/pattern_formatter.h"
+#ifdef SPDLOG_FMT_EXTERNAL
+#include <fmt/args.h>
+#else
+#include "spdlog/fmt/bundled/args.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Prism::BinaryLogFormat;
+
+struct Site {
+	bool valid = false;
+	spdlog::level::level_enum level = spdlog::level::info;
+	uint32_t line = 0;
+	std::string logger, file, function, format;
+};
+
+struct Message {
+	MessageHeader header;
+	size_t args; // offset of the first argument
+	size_t end;
+};
+
+// bounds-checked reads, the file may end in the middle of an entry
+class Reader {
+public:
+	Reader(const std::vector<uint8_t>& data, size_t offset, size_t end) : m_Data(data), m_Offset(offset), m_End(end) {}
+
+	template<typename T>
+	bool Read(T& value)
+	{
+		if (m_End - m_Offset < sizeof(T)) return false;
+		std::memcpy(&value, m_Data.data() + m_Offset, sizeof(T));
+		m_Offset += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(std::string_view& string)
+	{
+		uint32_t length;
+		if (!Read(length) || m_End - m_Offset < length) return false;
+		string = std::string_view(reinterpret_cast<const char*>(m_Data.data()) + m_Offset, length);
+		m_Offset += length;
+		return true;
+	}
+
+	size_t Offset() const { return m_Offset; }
+
+private:
+	const std::vector<uint8_t>& m_Data;
+	size_t m_Offset, m_End;
+};
+
+static bool decodeMessage(const std::vector<uint8_t>& data, const Message& message, const Site& site, std::string& text)
+{
+	Reader reader(data, message.args, message.end);
+	fmt::dynamic_format_arg_store<fmt::format_context> store;
+	for (uint16_t i = 0; i < message.header.argCount; ++i)
+	{
+		uint8_t type;
+		if (!reader.Read(type)) return false;
+		if (static_cast<ArgType>(type) == ArgType::String)
+		{
+			std::string_view string;
+			if (!reader.ReadString(string)) return false;
+			if (message.header.flags & Preformatted)
+			{
+				text.assign(string.data(), string.size());
+				return true;
+			}
+			store.push_back(string); // data outlives the store
+			continue;
+		}
+
+		uint64_t bits;
+		if (!reader.Read(bits)) return false;
+		switch (static_cast<ArgType>(type))
+		{
+		case ArgType::Int: store.push_back(static_cast<int64_t>(bits)); break;
+		case ArgType::UInt: store.push_back(bits); break;
+		case ArgType::Bool: store.push_back(bits != 0); break;
+		case ArgType::Char: store.push_back(static_cast<char>(bits)); break;
+		case ArgType::Double:
+		{
+			double d;
+			std::memcpy(&d, &bits, sizeof(d));
+			store.push_back(d);
+			break;
+		}
+		case ArgType::Float:
+		{
+			float f;
+			std::memcpy(&f, &bits, sizeof(f));
+			store.push_back(f);
+			break;
+		}
+		default: return false;
+		}
+	}
+
+	try
+	{
+		text = fmt::vformat(site.format, store);
+	}
+	catch (const fmt::format_error& error)
+	{
+		text = "[format error: " + std::string(error.what()) + "] " + site.format;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <file> [pattern]\n", argv[0]);
+		return 1;
+	}
+	const std::string pattern = argc > 2 ? argv[2] : "[%T] %n: %v (%s:%#)";
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file)
+	{
+		std::fprintf(stderr, "%s: could not open\n", argv[1]);
+		return 1;
+	}
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	FileHeader header;
+	if (data.size() < sizeof(header) || (std::memcpy(&header, data.data(), sizeof(header)), std::memcmp(header.magic, Magic, sizeof(Magic)) != 0))
+	{
+		std::fprintf(stderr, "%s: not a binary log\n", argv[1]);
+		return 1;
+	}
+	if (header.version != Version)
+	{
+		std::fprintf(stderr, "%s: version %u, expected %u\n", argv[1], header.version, Version);
+		return 1;
+	}
+
+	// header.size is 0 if the writer didn't close the file: entries end at the first empty header
+	const size_t end = header.size != 0 ? std::min<size_t>(header.size, data.size()) : data.size();
+	std::vector<Site> sites;
+	std::vector<Message> messages;
+	size_t pending = 0, corrupt = 0;
+
+	for (size_t offset = header.headerSize; end - offset >= sizeof(EntryHeader);)
+	{
+		EntryHeader entry;
+		std::memcpy(&entry, data.data() + offset, sizeof(entry));
+		if (entry.size < sizeof(EntryHeader) || entry.size > end - offset)
+			break;
+
+		Reader reader(data, offset + sizeof(EntryHeader), offset + entry.size);
+		if (entry.type == EntryType::Site)
+		{
+			SiteHeader siteHeader;
+			std::string_view strings[4];
+			bool valid = reader.Read(siteHeader);
+			for (auto& string : strings)
+				valid = valid && reader.ReadString(string);
+
+			if (valid)
+			{
+				if (siteHeader.id >= sites.size()) sites.resize(siteHeader.id + 1);
+				Site& site = sites[siteHeader.id];
+				site.valid = true;
+				site.level = static_cast<spdlog::level::level_enum>(siteHeader.level);
+				site.line = siteHeader.line;
+				site.logger = strings[0];
+				site.file = strings[1];
+				site.function = strings[2];
+				site.format = strings[3];
+			}
+			else ++corrupt;
+		}
+		else if (entry.type == EntryType::Message)
+		{
+			Message message;
+			if (reader.Read(message.header))
+			{
+				message.args = reader.Offset();
+				message.end = offset + entry.size;
+				messages.push_back(message);
+			}
+			else ++corrupt;
+		}
+		else ++pending;
+
+		offset += entry.size;
+	}
+
+	// threads reserve their entries slightly out of order
+	std::stable_sort(messages.begin(), messages.end(), [](const Message& a, const Message& b) { return a.header.timestamp < b.header.timestamp; });
+
+	spdlog::pattern_formatter formatter(pattern, spdlog::pattern_time_type::local, "\n");
+	spdlog::memory_buf_t buffer;
+	std::string text;
+	for (const Message& message : messages)
+	{
+		if (message.header.site >= sites.size() || !sites[message.header.site].valid)
+		{
+			++corrupt;
+			continue;
+		}
+		const Site& site = sites[message.header.site];
+		if (!decodeMessage(data, message, site, text))
+		{
+			++corrupt;
+			continue;
+		}
+
+		const spdlog::log_clock::time_point time{ std::chrono::duration_cast<spdlog::log_clock::duration>(
+			std::chrono::nanoseconds(message.header.timestamp)) };
+		spdlog::details::log_msg msg(time, spdlog::source_loc{ site.file.c_str(), static_cast<int>(site.line), site.function.c_str() },
+			site.logger, site.level, text);
+		msg.thread_id = message.header.thread;
+
+		buffer.clear();
+		formatter.format(msg, buffer);
+		std::fwrite(buffer.data(), 1, buffer.size(), stdout);
+	}
+
+	if (pending > 0 || corrupt > 0)
+		std::fprintf(stderr, "%zu incomplete and %zu unreadable entries skipped\n", pending, corrupt);
+	return 0;
+}
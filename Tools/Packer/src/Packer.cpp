@@ -0,0 +1,80 @@
+/**
+ * Packer: packs asset directories into one pack (Prism::PackArchive)
+ *
+ * usage: Packer [-c] <output> <directory>...
+ * Entries are named by their path relative to the given directory, with
+ * '/' as separator (e.g. "shaders/flat_test.glsl" for res/shaders/... when
+ * packing res). Later directories override earlier ones.
+ * With -c, entries are block compressed (where that makes them smaller).
+ */
+#include "Util/FileReader/PackWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv)
+{
+	const bool compress = argc > 1 && std::string(argv[1]) == "-c";
+	const int first = compress ? 2 : 1; // the output
+	if (argc < first + 2)
+	{
+		std::fprintf(stderr, "usage: %s [-c] <output> <directory>...\n", argv[0]);
+		return 1;
+	}
+
+	Prism::PackWriter writer;
+	std::map<std::string, uint64_t> sizes; // of the entries, an overridden one counts once
+	for (int arg = first + 1; arg < argc; ++arg)
+	{
+		const fs::path root = argv[arg];
+		std::error_code error;
+		if (!fs::is_directory(root, error))
+		{
+			std::fprintf(stderr, "%s: not a directory\n", argv[arg]);
+			return 1;
+		}
+
+		// sorted, so the same input gives the same pack
+		std::vector<fs::path> files;
+		for (auto it = fs::recursive_directory_iterator(root, error); !error && it != fs::recursive_directory_iterator(); it.increment(error))
+			if (it->is_regular_file(error))
+				files.push_back(it->path());
+		if (error)
+		{
+			std::fprintf(stderr, "%s: %s\n", argv[arg], error.message().c_str());
+			return 1;
+		}
+		std::sort(files.begin(), files.end());
+
+		for (const fs::path& file : files)
+		{
+			const std::string name = file.lexically_relative(root).generic_string();
+			if (!writer.AddFile(name, file.string(), compress))
+			{
+				std::fprintf(stderr, "%s: could not read\n", file.string().c_str());
+				return 1;
+			}
+			sizes[name] = fs::file_size(file, error);
+		}
+	}
+
+	uint64_t bytes = 0;
+	for (const auto& [name, size] : sizes)
+		bytes += size;
+
+	std::string error;
+	if (!writer.Write(argv[first], error))
+	{
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+	std::printf("packed %zu files (%llu bytes) into %s (%llu bytes)\n", writer.GetEntryCount(), static_cast<unsigned long long>(bytes),
+		argv[first], static_cast<unsigned long long>(fs::file_size(argv[first])));
+	return 0;
+}
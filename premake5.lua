@@ -1,3 +1,8 @@
+newoption {
+	trigger = "avx2",
+	description = "Compile the SIMD kernels (Prism/src/Math) with AVX2"
+}
+
 workspace "Prism"
     architecture "x64"
     startproject "Sandbox"
@@ -16,6 +21,10 @@ workspace "Prism"
         "NOMINMAX"
     }
 
+    filter "options:avx2"
+        vectorextensions "AVX2"
+    filter {}
+
 outputdir = "%{cfg.buildcfg}"
 includedir = {}
 
@@ -117,4 +126,109 @@ project "Sandbox"
 	filter "configurations:Release"
 		defines "PR_RELEASE"
 		runtime "Release"
-		optimize "On"
\ No newline at end of file
+		optimize "On"
+
+
+project "Benchmark"
+	location "Benchmark"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "On"
+	systemversion "latest"
+	
+	targetdir ("bin/" .. outputdir)
+	objdir ("bin-int/%{prj.name}-" .. outputdir)
+
+	files {
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp"
+	}
+
+	includedirs {
+		"Prism/src",
+        "%{includedir.spdlog}",
+        "%{includedir.lua}"
+	}
+
+	links {
+		"Prism"
+	}
+	
+	filter "configurations:Debug"
+		defines "PR_DEBUG"
+		runtime "Debug"
+		buildoptions "/MT /await"
+		symbols "On"
+
+	filter "configurations:Release"
+		defines "PR_RELEASE"
+		runtime "Release"
+		optimize "On"
+group "Tools"
+
+project "LogDecoder"
+	location "Tools/LogDecoder"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "On"
+	systemversion "latest"
+	
+	targetdir ("bin/" .. outputdir)
+	objdir ("bin-int/%{prj.name}-" .. outputdir)
+
+	files {
+		"Tools/%{prj.name}/src/**.h",
+		"Tools/%{prj.name}/src/**.cpp"
+	}
+
+	-- only the file format is shared, the decoder doesn't link Prism
+	includedirs {
+		"Prism/src",
+        "%{includedir.spdlog}"
+	}
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "On"
+
+project "Packer"
+	location "Tools/Packer"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "On"
+	systemversion "latest"
+	
+	targetdir ("bin/" .. outputdir)
+	objdir ("bin-int/%{prj.name}-" .. outputdir)
+
+	-- the writer only depends on the standard library, the packer doesn't link Prism
+	files {
+		"Tools/%{prj.name}/src/**.h",
+		"Tools/%{prj.name}/src/**.cpp",
+		"Prism/src/Util/FileReader/PackFormat.h",
+		"Prism/src/Util/FileReader/PackWriter.h",
+		"Prism/src/Util/FileReader/PackWriter.cpp",
+		"Prism/src/Util/Compression/BlockCompression.h",
+		"Prism/src/Util/Compression/BlockCompression.cpp"
+	}
+
+	includedirs {
+		"Prism/src"
+	}
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "On"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "On"
+
+group ""